@@ -0,0 +1,90 @@
+#include <algorithm>
+#include "AuctionEngine.hpp"
+#include "BoardDefinition.hpp"
+
+namespace {
+    // what a tile is worth on top of its price, in percent of it: per tile of its group owned (spread over the
+    // group), for completing a monopoly and for stopping another player from completing one
+    constexpr std::uint64_t OWNED_PERCENT = 50;
+    constexpr std::uint64_t MONOPOLY_PERCENT = 100;
+    constexpr std::uint64_t BLOCKING_PERCENT = 50;
+}
+
+AuctionEngine::AuctionEngine()
+    : m_first(1, 0)
+{
+}
+
+AuctionEngine::AuctionEngine(const BoardDefinition& board){
+    unsigned int numGroups = board.getNumGroups();
+    m_first.reserve(numGroups + 1);
+    for (unsigned int group = 0; group < numGroups; group++) {
+        std::uint8_t id = static_cast<std::uint8_t>(group);
+        m_first.push_back(static_cast<std::uint32_t>(m_percents.size()));
+
+        // monopolies are only worth more where they can be built on
+        std::uint64_t size = board.getGroupSize(id);
+        bool buildable = size > 0;
+        for (unsigned int tile : board.getGroupTiles(id)) {
+            buildable = buildable && board.getTile(tile).housePrice > 0;
+        }
+        for (int blocks = 0; blocks < 2; blocks++) {
+            for (std::uint64_t owned = 0; owned < size; owned++) {
+                std::uint64_t percent = 100 + OWNED_PERCENT * owned / size;
+                if (buildable && owned + 1 == size) {
+                    percent += MONOPOLY_PERCENT;
+                }
+                if (buildable && blocks) {
+                    percent += BLOCKING_PERCENT;
+                }
+                m_percents.push_back(static_cast<std::uint16_t>(percent));
+            }
+        }
+    }
+    m_first.push_back(static_cast<std::uint32_t>(m_percents.size()));
+}
+
+unsigned int AuctionEngine::getValue(unsigned int price, std::uint8_t group, unsigned int owned, bool blocks) const {
+    if (group + 1u >= m_first.size()) {
+        return 0;
+    }
+    std::uint32_t first = m_first[group];
+    std::uint32_t size = (m_first[group + 1] - first) / 2;
+    if (size == 0) {
+        return 0;
+    }
+    std::uint64_t percent = m_percents[first + (blocks ? size : 0) + std::min(owned, size - 1)];
+    return static_cast<unsigned int>(price * percent / 100);
+}
+
+AuctionEngine::Result AuctionEngine::resolve(Kind kind, const unsigned int* limits, unsigned int numPlayers, unsigned int first){
+    // the best two bids, a later bidder has to beat an earlier one to take the lead
+    int winner = -1;
+    unsigned int best = 0;
+    unsigned int second = 0;
+    for (unsigned int i = 0; i < numPlayers; i++) {
+        unsigned int player = (first + i) % numPlayers;
+        unsigned int bid = kind == Kind::SealedBid
+            ? static_cast<unsigned int>(static_cast<std::uint64_t>(limits[player]) * SEALED_BID_PERCENT / 100)
+            : limits[player];
+        if (bid > best || winner < 0) {
+            second = best;
+            best = bid;
+            winner = static_cast<int>(player);
+        } else if (bid > second) {
+            second = bid;
+        }
+    }
+    if (winner < 0 || best < MIN_BID) {
+        return Result{ -1, 0 };
+    }
+    if (kind == Kind::SealedBid) {
+        return Result{ winner, best };
+    }
+    // the others drop out once the price passes their limits, the winner never goes over theirs
+    return Result{ winner, std::min(best, std::max(MIN_BID, second + BID_STEP)) };
+}
+
+std::size_t AuctionEngine::getMemoryUsage() const {
+    return sizeof(*this) + m_first.capacity() * sizeof(std::uint32_t) + m_percents.capacity() * sizeof(std::uint16_t);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BoardDefinition;
+
+/** @class AuctionEngine
+ *
+ * @brief Auctions a tile whose purchase was declined, and values the tiles for the bots that bid on it.
+ *
+ * Every player still in the game bids up to a limit: what the tile is worth to them, and never more than their cash.
+ * The worth of a tile depends on its price, on how many tiles of its group the bidder already holds (winning the last
+ * one completes a monopoly) and on whether another player is one tile away from the group. Those are worked out once
+ * per board into a small table of percents of the price for every group (see BoardDefinition::getAuctions()), so a
+ * bidder's limit is a lookup and an auction needs no search.
+ *
+ * An ascending auction goes up in steps of BID_STEP until one bidder is left, which is the same as the highest limit
+ * winning at one step over the second highest, so it's resolved in one pass over the limits. In a sealed bid auction
+ * every bidder bids a share of their limit (shading it, as the winner pays their own bid) and the highest bid wins.
+ * Ties go to the first bidder in turn order, starting from the player that declined the purchase.
+ */
+class AuctionEngine {
+public:
+    /** @enum Kind
+     *  @brief How the bids are made.
+     */
+    enum class Kind : std::uint8_t { Ascending, SealedBid };
+
+    /** @brief The lowest bid the bank accepts, a tile nobody bids that much on stays unowned. */
+    static constexpr unsigned int MIN_BID = 10;
+
+    /** @brief The step an ascending auction goes up by. */
+    static constexpr unsigned int BID_STEP = 10;
+
+    /** @brief The share of their limit a bidder bids in a sealed bid auction, in percent. */
+    static constexpr unsigned int SEALED_BID_PERCENT = 80;
+
+    /** @brief The outcome of an auction. */
+    struct Result {
+        int winner;                ///< The index of the winning player, -1 if nobody bid MIN_BID.
+        unsigned int price;        ///< What the winner pays.
+    };
+
+    /** @brief Creates an engine without groups, every tile is worth nothing to it. */
+    AuctionEngine();
+
+    /** @brief Computes the percents of the groups of a board.
+     *
+     * @param board The tiles of the board, the engine keeps nothing of it.
+     */
+    explicit AuctionEngine(const BoardDefinition& board);
+
+    /** @brief Gets what a tile is worth to a bidder.
+     *
+     * @param price The price of the tile.
+     * @param group The group of the tile, nothing is worth anything outside a group.
+     * @param owned The number of tiles of its group the bidder owns.
+     * @param blocks Whether winning it stops another player from completing the group.
+     */
+    unsigned int getValue(unsigned int price, std::uint8_t group, unsigned int owned, bool blocks) const;
+
+    /** @brief Resolves an auction from the limits of the bidders.
+     *
+     * @param kind How the bids are made.
+     * @param limits The most every player bids, 0 for the players that don't bid.
+     * @param numPlayers The number of players.
+     * @param first The player that bids first, the ties go to them and then to the players after them.
+     */
+    static Result resolve(Kind kind, const unsigned int* limits, unsigned int numPlayers, unsigned int first);
+
+    /** @brief Gets the bytes the table takes, shared by all the games on the board. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    //* MEMBERS
+    std::vector<std::uint32_t> m_first;      ///< The index of the first percent of every group, and one past the last group.
+    std::vector<std::uint16_t> m_percents;   ///< The percent of the price for every count of the group owned, then when blocking.
+};
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "BenchmarkSuite.hpp"
+
+namespace {
+    // gets the number following "key": on a line written by writeJson, false if missing
+    bool findNumber(const std::string& line, const std::string& key, double& value){
+        std::size_t position = line.find("\"" + key + "\":");
+        if (position == std::string::npos) {
+            return false;
+        }
+        value = std::atof(line.c_str() + position + key.size() + 3);
+        return true;
+    }
+
+    // gets the string following "key": on a line written by writeJson, false if missing
+    bool findString(const std::string& line, const std::string& key, std::string& value){
+        std::size_t position = line.find("\"" + key + "\":\"");
+        if (position == std::string::npos) {
+            return false;
+        }
+        position += key.size() + 4;
+        std::size_t end = line.find('"', position);
+        if (end == std::string::npos) {
+            return false;
+        }
+        value = line.substr(position, end - position);
+        return true;
+    }
+}
+
+void BenchmarkSuite::add(const std::string& name, Function function){
+    m_entries.push_back(Entry{ name, std::move(function) });
+}
+
+std::vector<BenchmarkSuite::Result> BenchmarkSuite::run(const Options& options, std::ostream& log) const {
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perfCounters) {
+        counters.reset(new PerfCounters());
+        if (!counters->isAvailable()) {
+            log << "perf events are unavailable here, timing only\n";
+            counters.reset();
+        }
+    }
+
+    std::vector<Result> results;
+    for (const auto& entry : m_entries) {
+        if (!options.filter.empty() && entry.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        // double the operations until one run is long enough, which also warms up the caches
+        const double minRunNs = options.minRunMs * 1e6;
+        std::uint64_t operations = 1;
+        double elapsedNs = timeRun(entry.function, operations);
+        while (elapsedNs < minRunNs && operations < (1ull << 40)) {
+            // jump close to the target once the time is measurable, then settle by doubling
+            if (elapsedNs > minRunNs / 100) {
+                operations = static_cast<std::uint64_t>(operations * (minRunNs / elapsedNs) * 1.1) + 1;
+            } else {
+                operations *= 2;
+            }
+            elapsedNs = timeRun(entry.function, operations);
+        }
+
+        std::vector<double> nsPerOperation;
+        PerfCounters::Reading counts = {};
+        for (unsigned int i = 0; i < std::max(1u, options.runs); i++) {
+            PerfCounters::Reading runCounts;
+            nsPerOperation.push_back(timeRun(entry.function, operations, counters.get(), &runCounts) / operations);
+            counts += runCounts;
+        }
+
+        Result result;
+        result.name = entry.name;
+        result.operationsPerRun = operations;
+        result.runs = static_cast<unsigned int>(nsPerOperation.size());
+        double sum = 0.0;
+        for (double ns : nsPerOperation) {
+            sum += ns;
+        }
+        result.meanNs = sum / nsPerOperation.size();
+        double squares = 0.0;
+        for (double ns : nsPerOperation) {
+            squares += (ns - result.meanNs) * (ns - result.meanNs);
+        }
+        result.stddevNs = nsPerOperation.size() > 1 ? std::sqrt(squares / (nsPerOperation.size() - 1)) : 0.0;
+        std::sort(nsPerOperation.begin(), nsPerOperation.end());
+        std::size_t middle = nsPerOperation.size() / 2;
+        result.medianNs = nsPerOperation.size() % 2 ? nsPerOperation[middle]
+                                                    : (nsPerOperation[middle - 1] + nsPerOperation[middle]) / 2;
+        result.minNs = nsPerOperation.front();
+        result.maxNs = nsPerOperation.back();
+        if (counters) {
+            result.hasCounters = true;
+            for (unsigned int event = 0; event < PerfCounters::NUM_EVENTS; event++) {
+                result.countsPerOperation[event] = static_cast<double>(counts.counts[event]) / (operations * result.runs);
+            }
+        }
+        results.push_back(result);
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-48s %14.1f ns/op  +-%5.1f%%  (%u runs of %llu)\n",
+                      result.name.c_str(), result.medianNs, 100.0 * result.stddevNs / std::max(result.meanNs, 1e-9),
+                      result.runs, static_cast<unsigned long long>(result.operationsPerRun));
+        log << line;
+        if (result.hasCounters) {
+            const double* perOperation = result.countsPerOperation;
+            std::snprintf(line, sizeof(line), "%-48s %14.1f cycles/op  IPC %.2f  L1d %.2f  LLC %.3f  branch %.2f misses/op\n",
+                          "", perOperation[PerfCounters::Cycles],
+                          perOperation[PerfCounters::Instructions] / std::max(perOperation[PerfCounters::Cycles], 1e-9),
+                          perOperation[PerfCounters::L1DataMisses], perOperation[PerfCounters::LastLevelMisses],
+                          perOperation[PerfCounters::BranchMisses]);
+            log << line;
+        }
+        log << std::flush;
+    }
+    return results;
+}
+
+void BenchmarkSuite::writeJson(std::ostream& out, const std::vector<Result>& results){
+    out << "{\"benchmarks\":[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "{\"name\":\"%s\",\"runs\":%u,\"operations_per_run\":%llu,\"mean_ns\":%.3f,\"median_ns\":%.3f,"
+                      "\"stddev_ns\":%.3f,\"min_ns\":%.3f,\"max_ns\":%.3f,\"operations_per_second\":%.1f",
+                      result.name.c_str(), result.runs, static_cast<unsigned long long>(result.operationsPerRun),
+                      result.meanNs, result.medianNs, result.stddevNs, result.minNs, result.maxNs,
+                      result.medianNs > 0 ? 1e9 / result.medianNs : 0.0);
+        out << line;
+        // the counters per operation, named like "cycles_per_op"
+        if (result.hasCounters) {
+            for (unsigned int event = 0; event < PerfCounters::NUM_EVENTS; event++) {
+                std::snprintf(line, sizeof(line), ",\"%s_per_op\":%.3f",
+                              PerfCounters::getEventName(static_cast<PerfCounters::Event>(event)),
+                              result.countsPerOperation[event]);
+                out << line;
+            }
+        }
+        out << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    out << "]}\n";
+}
+
+bool BenchmarkSuite::readJson(const std::string& path, std::vector<Result>& results){
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        Result result;
+        double runs = 0.0;
+        double operations = 0.0;
+        if (!findString(line, "name", result.name) || !findNumber(line, "median_ns", result.medianNs)) {
+            continue;
+        }
+        findNumber(line, "runs", runs);
+        findNumber(line, "operations_per_run", operations);
+        findNumber(line, "mean_ns", result.meanNs);
+        findNumber(line, "stddev_ns", result.stddevNs);
+        findNumber(line, "min_ns", result.minNs);
+        findNumber(line, "max_ns", result.maxNs);
+        result.runs = static_cast<unsigned int>(runs);
+        result.operationsPerRun = static_cast<std::uint64_t>(operations);
+        results.push_back(result);
+    }
+    return true;
+}
+
+unsigned int BenchmarkSuite::compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                     double threshold, std::ostream& out){
+    unsigned int regressions = 0;
+    for (const auto& result : current) {
+        auto base = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b){ return b.name == result.name; });
+        if (base == baseline.end() || base->medianNs <= 0.0) {
+            continue;
+        }
+        double change = result.medianNs / base->medianNs - 1.0;
+        double noise = 2.0 * (result.stddevNs + base->stddevNs);
+        const char* verdict = "";
+        if (change > threshold && result.medianNs - base->medianNs > noise) {
+            verdict = "  REGRESSION";
+            regressions++;
+        } else if (change < -threshold && base->medianNs - result.medianNs > noise) {
+            verdict = "  faster";
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-48s %14.1f -> %14.1f ns/op  %+6.1f%%%s\n",
+                      result.name.c_str(), base->medianNs, result.medianNs, 100.0 * change, verdict);
+        out << line;
+    }
+    return regressions;
+}
+
+double BenchmarkSuite::timeRun(const Function& function, std::uint64_t operations, const PerfCounters* counters,
+                               PerfCounters::Reading* counts){
+    if (counters) {
+        PerfCounters::Reading start = counters->read();
+        function(operations);
+        *counts = counters->read() - start;
+        return static_cast<double>(counts->wallNs);
+    }
+    auto start = std::chrono::steady_clock::now();
+    function(operations);
+    auto end = std::chrono::steady_clock::now();
+    if (counts) {
+        *counts = PerfCounters::Reading{};
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "PerfCounters.hpp"
+
+/** @brief Keeps the compiler from optimizing away a value computed by a benchmark. */
+template <typename T>
+inline void doNotOptimize(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** @class BenchmarkSuite
+ *
+ * @brief Runs named benchmarks several times and reports the time per operation with its spread.
+ *
+ * Each benchmark is a function running a given number of operations. The suite first finds an
+ * operation count that takes at least the minimal run time (this also warms up the caches), then
+ * times that many operations in every run. Results are written as JSON, one benchmark per line, and
+ * can be compared against a baseline file written the same way to flag regressions.
+ *
+ * With perfCounters, the timed runs are also counted with PerfCounters, and the results hold the cycles,
+ * instructions and misses per operation. Only the calling thread is counted, and where perf events are unavailable
+ * the results hold the time alone.
+ */
+class BenchmarkSuite {
+public:
+    /** @brief Runs the given number of operations of a benchmark. */
+    using Function = std::function<void(std::uint64_t operations)>;
+
+    /** @brief How the benchmarks are run. */
+    struct Options {
+        std::string filter;         ///< Only run the benchmarks whose name contains it.
+        unsigned int runs = 10;     ///< The number of timed runs of each benchmark.
+        double minRunMs = 50.0;     ///< The minimal duration of one run.
+        bool perfCounters = false;  ///< Count the hardware events of the timed runs.
+    };
+
+    /** @brief The timing of one benchmark over all its runs. */
+    struct Result {
+        std::string name;
+        std::uint64_t operationsPerRun = 0;
+        unsigned int runs = 0;
+        double meanNs = 0.0;        ///< The mean time per operation.
+        double medianNs = 0.0;
+        double stddevNs = 0.0;      ///< The run to run standard deviation of the time per operation.
+        double minNs = 0.0;
+        double maxNs = 0.0;
+        bool hasCounters = false;                            ///< If any hardware event was counted.
+        double countsPerOperation[PerfCounters::NUM_EVENTS] = {};  ///< Over all the timed runs.
+    };
+
+    /** @brief Registers a benchmark.
+     *
+     * @param name The name of the benchmark, e.g. "TextBox::update/long/Left".
+     * @param function The benchmark, running the given number of operations.
+     */
+    void add(const std::string& name, Function function);
+
+    /** @brief Runs the registered benchmarks that match the filter, printing each result as it's done.
+     *
+     * @param options How to run the benchmarks.
+     * @param log Where to print the progress.
+     * @return The results, in the order the benchmarks were registered.
+     */
+    std::vector<Result> run(const Options& options, std::ostream& log) const;
+
+    /** @brief Writes results as JSON, one benchmark per line. */
+    static void writeJson(std::ostream& out, const std::vector<Result>& results);
+
+    /** @brief Reads results written by writeJson.
+     *
+     * @param path The path of the file to read.
+     * @param results Filled with the results of the file.
+     * @return Whether the file could be read.
+     */
+    static bool readJson(const std::string& path, std::vector<Result>& results);
+
+    /** @brief Compares results against a baseline and prints the changes.
+     *
+     * A benchmark regressed when its median got slower than the threshold and the slowdown
+     * is larger than the run to run noise of both results.
+     *
+     * @param baseline The results to compare against.
+     * @param current The new results.
+     * @param threshold The relative slowdown that is allowed, e.g. 0.05 for 5%.
+     * @param out Where to print the comparison.
+     * @return The number of regressed benchmarks.
+     */
+    static unsigned int compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                double threshold, std::ostream& out);
+
+private:
+    /** @brief A registered benchmark. */
+    struct Entry {
+        std::string name;
+        Function function;
+    };
+
+    /** @brief Times one call of a benchmark, in nanoseconds.
+     *
+     * @param counters Counts the call into counts, nullptr to only time it.
+     */
+    static double timeRun(const Function& function, std::uint64_t operations, const PerfCounters* counters = nullptr,
+                          PerfCounters::Reading* counts = nullptr);
+
+    //* MEMBERS
+    std::vector<Entry> m_entries;
+};
@@ -1,113 +1,269 @@
 #include "Board.hpp"
+#include "Player.hpp"
+#include "Profiler.hpp"
 
-Board::Board(float edgeSize, float cornersRatio, sf::Font &font):
-    m_font(font),
+namespace {
+    // the memory the texts of a tile take, to size the text arena of a board up front
+    constexpr std::size_t TEXT_BYTES_PER_TILE = 4096;
+    // the side of a token, relative to the side of the board
+    constexpr float TOKEN_SIZE_RATIO = 0.018f;
+}
+
+Board::Board(float edgeSize, float cornersRatio, sf::Font &font, const BoardDefinition& definition):
+    m_textArena(definition.getNumTiles() * TEXT_BYTES_PER_TILE),
+    m_textPool(&m_textArena),
     m_edgeSize(edgeSize),
-    m_cornersRatio(cornersRatio)
+    m_cornersRatio(cornersRatio),
+    m_font(font)
 {
-    createTiles();
+    createTiles(definition);
+    for (unsigned int i = 0; i < TokenAnimator::MAX_TOKENS; i++){
+        m_tokenPlayers[i] = nullptr;
+        m_tokenTiles[i] = getNumTiles();
+    }
     adjustAllComponents();
 }
 
-void Board::createTiles(){
-    // create the corners
-    // the corners that do nothing on landing
-    m_BottomRightCorner = std::make_unique<StreetTile>("Go", 100, m_font, StreetTile::ReadingDirection::Up, sf::Color::White); //! UNCOMMENT
-    m_BottomLeftCorner = std::make_unique<StreetTile>("Jail", 100, m_font, StreetTile::ReadingDirection::Up, sf::Color::White); //! UNCOMMENT
-    m_TopLeftCorner = std::make_unique<StreetTile>("Free Parking", 100, m_font, StreetTile::ReadingDirection::Up, sf::Color::White); //! UNCOMMENT
-    // the corner that does something: Go to jail
-    m_TopRightCorner = std::make_unique<StreetTile>("Go to Jail", 100, m_font, StreetTile::ReadingDirection::Up, sf::Color::White); //! UNCOMMENT
-
-    // create the edges
-    // down edge
-    m_downEdge.push_back(std::make_unique<StreetTile>("Ofakim", 100, m_font, StreetTile::ReadingDirection::Up, sf::Color(252, 152, 3))); // orange
-    m_downEdge.push_back(std::make_unique<StreetTile>("Sderot", 80, m_font, StreetTile::ReadingDirection::Up, sf::Color(252, 152, 3))); // orange
-    m_downEdge.push_back(std::make_unique<StreetTile>("Netivot", 60, m_font, StreetTile::ReadingDirection::Up, sf::Color(252, 152, 3))); // orange
-    m_downEdge.push_back(std::make_unique<StreetTile>("Ashdod Port", 200, m_font, StreetTile::ReadingDirection::Up, sf::Color::Red));
-    m_downEdge.push_back(std::make_unique<StreetTile>("Ashkelon", 50, m_font, StreetTile::ReadingDirection::Up, sf::Color::Red));
-    m_downEdge.push_back(std::make_unique<StreetTile>("Nitzanim", 50, m_font, StreetTile::ReadingDirection::Up, sf::Color::Red));
-    m_downEdge.push_back(std::make_unique<StreetTile>("Palmachim", 60, m_font, StreetTile::ReadingDirection::Up, sf::Color::Red));
-
-    // left edge
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Eilat", 100, m_font, StreetTile::ReadingDirection::Left, sf::Color::Green));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Yotvata", 60, m_font, StreetTile::ReadingDirection::Left, sf::Color::Green));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Mitzpe Ramon", 60, m_font, StreetTile::ReadingDirection::Left, sf::Color::Green));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Be'er Sheva University", 200, m_font, StreetTile::ReadingDirection::Left, sf::Color::Blue));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Sde Boker", 50, m_font, StreetTile::ReadingDirection::Left, sf::Color::Blue));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Dimona", 50, m_font, StreetTile::ReadingDirection::Left, sf::Color::Blue));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Arad", 60, m_font, StreetTile::ReadingDirection::Left, sf::Color::Blue));
-    m_leftEdge.push_back(std::make_unique<StreetTile>("Yeruham", 70, m_font, StreetTile::ReadingDirection::Left, sf::Color::Blue));
-
-    // up edge
-    m_upEdge.push_back(std::make_unique<StreetTile>("Haifa", 100, m_font, StreetTile::ReadingDirection::Down, sf::Color::Magenta));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Acre", 80, m_font, StreetTile::ReadingDirection::Down, sf::Color::Magenta));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Kiryat Ata", 60, m_font, StreetTile::ReadingDirection::Down, sf::Color::Magenta));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Kiryat Motzkin", 60, m_font, StreetTile::ReadingDirection::Down, sf::Color::Magenta));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Carmel Tunnels", 200, m_font, StreetTile::ReadingDirection::Down, sf::Color::Yellow));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Tiberias", 50, m_font, StreetTile::ReadingDirection::Down, sf::Color::Yellow));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Karmiel", 50, m_font, StreetTile::ReadingDirection::Down, sf::Color::Yellow));
-    m_upEdge.push_back(std::make_unique<StreetTile>("Tzfat", 60, m_font, StreetTile::ReadingDirection::Down, sf::Color::Yellow));
-
-    // right edge
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Tel Aviv", 100, m_font, StreetTile::ReadingDirection::Right, sf::Color::Cyan));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Ramat Gan", 60, m_font, StreetTile::ReadingDirection::Right, sf::Color::Cyan));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Bat Yam", 80, m_font, StreetTile::ReadingDirection::Right, sf::Color::Cyan));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Holon", 60, m_font, StreetTile::ReadingDirection::Right, sf::Color::Cyan));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Ayalon Highway", 200, m_font, StreetTile::ReadingDirection::Right));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Rishon LeZion", 50, m_font, StreetTile::ReadingDirection::Right, sf::Color(173, 216, 230)));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Petah Tikva", 70, m_font, StreetTile::ReadingDirection::Right, sf::Color(173, 216, 230)));
-    m_rightEdge.push_back(std::make_unique<StreetTile>("Rehovot", 50, m_font, StreetTile::ReadingDirection::Right, sf::Color(173, 216, 230)));
+void Board::createTiles(const BoardDefinition& definition){
+    // the tiles between the corners are split as evenly as possible between the edges, the later edges take the extra tiles
+    unsigned int numTiles = definition.getNumTiles();
+    unsigned int edgeTiles = numTiles > 4 ? numTiles - 4 : 0;
+    unsigned int edgeCounts[4];
+    for (unsigned int edge = 0; edge < 4; edge++){
+        edgeCounts[edge] = edgeTiles / 4 + (edge >= 4 - edgeTiles % 4 ? 1 : 0);
+    }
+
+    // walking from Go: the bottom right corner, the down edge from right to left, the bottom left corner, the left edge
+    // from bottom to top, the top left corner, the up edge from left to right, the top right corner and the right edge from top to bottom
+    m_BottomRightCorner = 0;
+    m_downEdge = Edge{ 1, edgeCounts[0], true };
+    m_BottomLeftCorner = m_downEdge.first + m_downEdge.count;
+    m_leftEdge = Edge{ m_BottomLeftCorner + 1, edgeCounts[1], true };
+    m_TopLeftCorner = m_leftEdge.first + m_leftEdge.count;
+    m_upEdge = Edge{ m_TopLeftCorner + 1, edgeCounts[2], false };
+    m_TopRightCorner = m_upEdge.first + m_upEdge.count;
+    m_rightEdge = Edge{ m_TopRightCorner + 1, edgeCounts[3], false };
+    m_jailIndex = definition.getJailIndex();
 
-    adjustAllComponents();
+    // reserved up front, so the tiles never move (the layout pass keeps pointers to their text boxes)
+    m_tiles.clear();
+    m_tiles.reserve(numTiles);
+    for (unsigned int i = 0; i < numTiles; i++){
+        StreetTile::ReadingDirection direction = StreetTile::ReadingDirection::Up;
+        if (i >= m_leftEdge.first && i < m_leftEdge.first + m_leftEdge.count){
+            direction = StreetTile::ReadingDirection::Left;
+        } else if (i >= m_upEdge.first && i < m_upEdge.first + m_upEdge.count){
+            direction = StreetTile::ReadingDirection::Down;
+        } else if (i >= m_rightEdge.first && i < m_rightEdge.first + m_rightEdge.count){
+            direction = StreetTile::ReadingDirection::Right;
+        }
+        const BoardDefinition::Tile& tile = definition.getTile(i);
+        m_tiles.emplace_back(tile.name, tile.price, m_font, direction, sf::Color(tile.color), &m_textPool);
+    }
 }
 
-void Board::draw(sf::RenderTarget &target, sf::RenderStates states) const{
-    // draw the corners
-    target.draw(*m_BottomRightCorner, states);
-    target.draw(*m_BottomLeftCorner, states);
-    target.draw(*m_TopLeftCorner, states);
-    target.draw(*m_TopRightCorner, states);
+StreetTile* Board::getTileAfterMove(StreetTile* currTile, unsigned int diceSum){
+    unsigned int index = getTileIndex(currTile);
+    if (index >= m_tiles.size()){
+        return nullptr;
+    }
+    return &m_tiles[(index + diceSum) % m_tiles.size()];
+}
+
+void Board::movePlayer(Player& player, unsigned int seat, StreetTile* currTile, StreetTile* newTile){
+    unsigned int token = getToken(player);
+    unsigned int newIndex = getTileIndex(newTile);
+    player.setStreetTile(newTile);
+    if (token >= TokenAnimator::MAX_TOKENS || newIndex >= m_tiles.size()){
+        return;
+    }
+
+    // a player that isn't on the board yet appears on the tile, the others walk there
+    if (!currTile || !m_tokens.isVisible(token)){
+        unsigned int oldIndex = m_tokenTiles[token];
+        m_tokens.place(token, newIndex, Player::getSeatColor(seat));
+        m_tokenTiles[token] = newIndex;
+        updateLandingPlayers(oldIndex);
+        updateLandingPlayers(newIndex);
+        return;
+    }
+    m_tokens.move(token, newIndex);
+}
 
-    // draw the edges
-    for (const auto& tile : m_downEdge){
-        target.draw(*tile, states);
+void Board::movePlayerToJail(Player& player, unsigned int seat){
+    unsigned int token = getToken(player);
+    StreetTile* jail = getJailTile();
+    player.setStreetTile(jail);
+    if (token >= TokenAnimator::MAX_TOKENS || !jail){
+        return;
     }
-    for (const auto& tile : m_leftEdge){
-        target.draw(*tile, states);
+    unsigned int oldIndex = m_tokenTiles[token];
+    m_tokens.place(token, m_jailIndex, Player::getSeatColor(seat));
+    m_tokenTiles[token] = m_jailIndex;
+    updateLandingPlayers(oldIndex);
+    updateLandingPlayers(m_jailIndex);
+}
+
+void Board::removePlayer(Player& player){
+    unsigned int token = getToken(player);
+    player.setStreetTile(nullptr);
+    if (token >= TokenAnimator::MAX_TOKENS){
+        return;
+    }
+    // the token is free for another player
+    unsigned int oldIndex = m_tokenTiles[token];
+    m_tokens.hide(token);
+    m_tokenPlayers[token] = nullptr;
+    m_tokenTiles[token] = getNumTiles();
+    updateLandingPlayers(oldIndex);
+}
+
+StreetTile* Board::getJailTile(){
+    return getTile(m_jailIndex);
+}
+
+void Board::update(float seconds){
+    std::uint32_t arrived = m_tokens.update(seconds);
+    // the tiles change once per arrival, never while the tokens walk
+    for (unsigned int token = 0; arrived != 0; token++, arrived >>= 1){
+        if (arrived & 1u){
+            unsigned int oldIndex = m_tokenTiles[token];
+            m_tokenTiles[token] = m_tokens.getTile(token);
+            updateLandingPlayers(oldIndex);
+            updateLandingPlayers(m_tokenTiles[token]);
+        }
+    }
+}
+
+bool Board::isAnimating() const{
+    for (unsigned int token = 0; token < TokenAnimator::MAX_TOKENS; token++){
+        if (m_tokens.isMoving(token)){
+            return true;
+        }
+    }
+    return false;
+}
+
+StreetTile* Board::getTile(unsigned int index){
+    return index < m_tiles.size() ? &m_tiles[index] : nullptr;
+}
+
+void Board::setEdgeSize(float edgeSize){
+    if (edgeSize == m_edgeSize){
+        return;
     }
-    for (const auto& tile : m_upEdge){
-        target.draw(*tile, states);
+    m_edgeSize = edgeSize;
+    adjustAllComponents();
+}
+
+float Board::getEdgeSize() const{
+    return m_edgeSize;
+}
+
+unsigned int Board::getNumTiles() const{
+    return static_cast<unsigned int>(m_tiles.size());
+}
+
+void Board::collectTextBoxes(std::vector<const TextBox*>& textBoxes) const{
+    for (const auto& tile : m_tiles){
+        tile.collectTextBoxes(textBoxes);
     }
-    for (const auto& tile : m_rightEdge){
-        target.draw(*tile, states);
+}
+
+void Board::draw(sf::RenderTarget &target, sf::RenderStates states) const{
+    PROFILE_ZONE("Board::draw");
+    // the tiles in memory order
+    for (const auto& tile : m_tiles){
+        target.draw(tile, states);
     }
+    // the tokens over the tiles
+    target.draw(m_tokens, states);
 }
 
 void Board::adjustAllComponents(){
+    if (m_tiles.empty()){
+        return;
+    }
     // set the bounds of the corners
-    // m_BottomRightCorner->getBounds(); //DEBUG
-    m_BottomRightCorner->setBounds(sf::FloatRect(m_edgeSize * (1 - m_cornersRatio), m_edgeSize * (1 - m_cornersRatio), m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
-    m_BottomLeftCorner->setBounds(sf::FloatRect(0, m_edgeSize * (1 - m_cornersRatio), m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
-    m_TopLeftCorner->setBounds(sf::FloatRect(0, 0, m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
-    m_TopRightCorner->setBounds(sf::FloatRect(m_edgeSize * (1 - m_cornersRatio), 0, m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
+    m_tiles[m_BottomRightCorner].setBounds(sf::FloatRect(m_edgeSize * (1 - m_cornersRatio), m_edgeSize * (1 - m_cornersRatio), m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
+    m_tiles[m_BottomLeftCorner].setBounds(sf::FloatRect(0, m_edgeSize * (1 - m_cornersRatio), m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
+    m_tiles[m_TopLeftCorner].setBounds(sf::FloatRect(0, 0, m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
+    m_tiles[m_TopRightCorner].setBounds(sf::FloatRect(m_edgeSize * (1 - m_cornersRatio), 0, m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio));
 
     // set the bounds of the edges
     setHorizontalEdgeBounds(m_downEdge, sf::FloatRect(m_edgeSize * m_cornersRatio, m_edgeSize * (1 - m_cornersRatio), m_edgeSize * (1 - 2 * m_cornersRatio), m_edgeSize * m_cornersRatio));
     setVerticalEdgeBounds(m_leftEdge, sf::FloatRect(0, m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio, m_edgeSize * (1 - 2 * m_cornersRatio)));
     setHorizontalEdgeBounds(m_upEdge, sf::FloatRect(m_edgeSize * m_cornersRatio, 0, m_edgeSize * (1 - 2 * m_cornersRatio), m_edgeSize * m_cornersRatio));
     setVerticalEdgeBounds(m_rightEdge, sf::FloatRect(m_edgeSize * (1 - m_cornersRatio), m_edgeSize * m_cornersRatio, m_edgeSize * m_cornersRatio, m_edgeSize * (1 - 2 * m_cornersRatio)));
+
+    adjustTokenRing();
 }
 
-void Board::setHorizontalEdgeBounds(std::vector<std::unique_ptr<StreetTile>>& edge, sf::FloatRect bounds){
-    float edgeSize = bounds.width / edge.size();
-    for (unsigned int i = 0; i < edge.size(); i++){
-        edge[i]->setBounds(sf::FloatRect(bounds.left + i * edgeSize, bounds.top, edgeSize, bounds.height));
+void Board::adjustTokenRing(){
+    std::vector<sf::Vector2f> centers;
+    centers.reserve(m_tiles.size());
+    for (const auto& tile : m_tiles){
+        sf::FloatRect bounds = tile.getBounds();
+        centers.emplace_back(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
     }
+    m_tokens.setRing(std::move(centers), m_edgeSize * TOKEN_SIZE_RATIO);
 }
 
-void Board::setVerticalEdgeBounds(std::vector<std::unique_ptr<StreetTile>>& edge, sf::FloatRect bounds){
-    float edgeSize = bounds.height / edge.size();
-    for (unsigned int i = 0; i < edge.size(); i++){
-        edge[i]->setBounds(sf::FloatRect(bounds.left, bounds.top + i * edgeSize, bounds.width, edgeSize));
+unsigned int Board::getToken(const Player& player){
+    for (unsigned int token = 0; token < TokenAnimator::MAX_TOKENS; token++){
+        if (m_tokenPlayers[token] == &player){
+            return token;
+        }
+    }
+    for (unsigned int token = 0; token < TokenAnimator::MAX_TOKENS; token++){
+        if (!m_tokenPlayers[token]){
+            m_tokenPlayers[token] = &player;
+            return token;
+        }
     }
-}
\ No newline at end of file
+    return TokenAnimator::MAX_TOKENS;
+}
+
+unsigned int Board::getTileIndex(const StreetTile* tile) const{
+    if (!tile || tile < m_tiles.data() || tile >= m_tiles.data() + m_tiles.size()){
+        return getNumTiles();
+    }
+    return static_cast<unsigned int>(tile - m_tiles.data());
+}
+
+void Board::updateLandingPlayers(unsigned int tileIndex){
+    if (tileIndex >= m_tiles.size()){
+        return;
+    }
+    m_landingPlayers.clear();
+    for (unsigned int token = 0; token < TokenAnimator::MAX_TOKENS; token++){
+        if (m_tokenPlayers[token] && m_tokenTiles[token] == tileIndex){
+            if (!m_landingPlayers.empty()){
+                m_landingPlayers += ", ";
+            }
+            m_landingPlayers += m_tokenPlayers[token]->getName();
+        }
+    }
+    StreetTile& tile = m_tiles[tileIndex];
+    if (tile.getLandingPlayerName() != m_landingPlayers){
+        tile.setLandingPlayerName(m_landingPlayers);
+    }
+}
+
+void Board::setHorizontalEdgeBounds(const Edge& edge, sf::FloatRect bounds){
+    float edgeSize = bounds.width / edge.count;
+    for (unsigned int i = 0; i < edge.count; i++){
+        // i is the position from the left
+        StreetTile& tile = m_tiles[edge.reversed ? edge.first + edge.count - 1 - i : edge.first + i];
+        tile.setBounds(sf::FloatRect(bounds.left + i * edgeSize, bounds.top, edgeSize, bounds.height));
+    }
+}
+
+void Board::setVerticalEdgeBounds(const Edge& edge, sf::FloatRect bounds){
+    float edgeSize = bounds.height / edge.count;
+    for (unsigned int i = 0; i < edge.count; i++){
+        // i is the position from the top
+        StreetTile& tile = m_tiles[edge.reversed ? edge.first + edge.count - 1 - i : edge.first + i];
+        tile.setBounds(sf::FloatRect(bounds.left, bounds.top + i * edgeSize, bounds.width, edgeSize));
+    }
+}
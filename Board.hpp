@@ -1,13 +1,24 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <memory>
+#include <memory_resource>
+#include <string>
 #include <vector>
 
+#include "BoardDefinition.hpp"
 #include "StreetTile.hpp"
+#include "TokenAnimator.hpp"
 
 class Player;  // Forward declaration for Player class
 
+/** @class Board
+ * 
+ * @brief The tiles of the board, laid out around a square.
+ * 
+ * all the tiles are stored in one array in the order the players walk them, and the text of their text boxes
+ * comes from a memory pool of the board, so building a board makes a handful of allocations and drawing it
+ * walks the tiles in memory order.
+ */
 class Board : public sf::Drawable, public sf::Transformable {
 public:
     /** @brief creates a squere Board with the given edges size and font
@@ -15,10 +26,15 @@ public:
      * @param edgeSize the size of the edges of the board
      * @param cornersRatio the ratio of the squere corners of the board to the edges
      * @param font the font to be used for the text on the board
+     * @param definition the tiles of the board, the first one is the bottom right corner
      */
-    Board(float edgeSize, float cornersRatio, sf::Font& font);
-    /** @brief create the tiles of the standard monopoly board */
-    void createTiles(); 
+    Board(float edgeSize, float cornersRatio, sf::Font& font, const BoardDefinition& definition = BoardDefinition::standard());
+
+    Board(const Board&) = delete;
+    Board& operator=(const Board&) = delete;
+
+    /** @brief create the tiles of the board from its definition */
+    void createTiles(const BoardDefinition& definition); 
     /** @brief Calculates the tile a player would land on if they move dicesum steps from their currTile
      * 
      * @param currTile the tile the player is currently on
@@ -27,16 +43,35 @@ public:
     StreetTile* getTileAfterMove(StreetTile* currTile, unsigned int diceSum);
     /** @brief Moves the player to the new tile
      * 
+     * the token of the player walks there tile by tile (see update()), and the landing players of the tiles are
+     * only updated once it arrives, so the tiles aren't laid out again during the walk.
+     * a player that isn't on the board yet is placed on the new tile right away.
      * @param player the player to move
-     * @param currTile the tile the player is currently on
+     * @param seat the seat of the player in the game, it colors the token
+     * @param currTile the tile the player is currently on, nullptr if they aren't on the board yet
      * @param newTile the tile the player is moving to
      */
-    void movePlayer(Player& player, StreetTile* currTile, StreetTile* newTile);
+    void movePlayer(Player& player, unsigned int seat, StreetTile* currTile, StreetTile* newTile);
     /** @brief move the given player to the jail tail.
      * 
+     * the token jumps there without walking.
      * @param player the player to move to jail
+     * @param seat the seat of the player in the game, it colors the token
     */
-    void movePlayerToJail(Player& player);
+    void movePlayerToJail(Player& player, unsigned int seat);
+    /** @brief take the token of a player off the board, e.g. when they went bankrupt.
+     * 
+     * the board forgets the player, so it must be called before a player is destroyed.
+     * @param player the player to remove
+     */
+    void removePlayer(Player& player);
+    /** @brief advance the walks of the tokens, and update the tiles the tokens arrived at.
+     * 
+     * @param seconds the time since the last update
+     */
+    void update(float seconds);
+    /** @brief whether a token is still walking. */
+    bool isAnimating() const;
     /** @brief get the jail tile of the board
      * 
      * @return the jail tile of the board
@@ -50,6 +85,28 @@ public:
     */
     bool hasAllStreetOfColor(Player& player, sf::Color color);
 
+    /** @brief get a tile by its index in the order the players walk the board (counter clockwise, starting at Go).
+     * 
+     * this is the same order as the tiles of GameState, and the order the tiles are stored in.
+     * @param index the index of the tile, smaller than getNumTiles()
+     */
+    StreetTile* getTile(unsigned int index);
+    /** @brief resize the board, laying all the tiles out again.
+     * 
+     * the text boxes are laid out again before the next draw (or by the layout pass).
+     * @param edgeSize the new size of the edges of the board
+     */
+    void setEdgeSize(float edgeSize);
+    /** @brief get the size of the edges of the board */
+    float getEdgeSize() const;
+    /** @brief get the number of tiles on the board */
+    unsigned int getNumTiles() const;
+    /** @brief add the text boxes of all the tiles to a list, for the layout pass.
+     * 
+     * @param textBoxes the list to add to
+     */
+    void collectTextBoxes(std::vector<const TextBox*>& textBoxes) const;
+
 private:
     // Inherited via Drawable
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override; // Implemented
@@ -58,21 +115,54 @@ private:
      * This function should be called right after a change to the data has accured.
     */
     void adjustAllComponents();
+    /** @brief the tiles between two corners, a range of the tiles array. */
+    struct Edge {
+        unsigned int first;  // the index of the first tile of the edge
+        unsigned int count;  // the number of tiles on the edge
+        bool reversed;       // whether the tiles are walked right to left (or bottom to top)
+    };
+
     /** @brief set the grapical attributes of a horizontal edge of the board(Up or Down).*/
-    void setHorizontalEdgeBounds(std::vector<std::unique_ptr<StreetTile>>& edge, sf::FloatRect bounds);
+    void setHorizontalEdgeBounds(const Edge& edge, sf::FloatRect bounds);
     /** @brief set the grapical attributes of a vertical edge of the board(Left or Right).*/
-    void setVerticalEdgeBounds(std::vector<std::unique_ptr<StreetTile>>& edge, sf::FloatRect bounds);
+    void setVerticalEdgeBounds(const Edge& edge, sf::FloatRect bounds);
+    /** @brief set the ring the tokens walk on from the bounds of the tiles.*/
+    void adjustTokenRing();
+    /** @brief get the token of a player, giving them the next free one on their first move.
+     * 
+     * @return the index of the token, TokenAnimator::MAX_TOKENS if all the tokens are taken
+     */
+    unsigned int getToken(const Player& player);
+    /** @brief get the index of a tile in m_tiles, getNumTiles() for nullptr. */
+    unsigned int getTileIndex(const StreetTile* tile) const;
+    /** @brief set the landing players of a tile to the players whose tokens stand on it. */
+    void updateLandingPlayers(unsigned int tileIndex);
 
     // Members
-    std::vector<std::unique_ptr<StreetTile>> m_downEdge;
-    std::vector<std::unique_ptr<StreetTile>> m_leftEdge;
-    std::vector<std::unique_ptr<StreetTile>> m_upEdge;
-    std::vector<std::unique_ptr<StreetTile>> m_rightEdge;
-
-    std::unique_ptr<StreetTile> m_BottomRightCorner; // Corrected spelling
-    std::unique_ptr<StreetTile> m_BottomLeftCorner;  // Corrected spelling
-    std::unique_ptr<StreetTile> m_TopLeftCorner;
-    std::unique_ptr<StreetTile> m_TopRightCorner;
+    // the memory of the texts of the tiles: the pool reuses what the tiles free, and takes new memory from the arena.
+    // declared before the tiles, so it outlives them
+    std::pmr::monotonic_buffer_resource m_textArena;
+    std::pmr::unsynchronized_pool_resource m_textPool;
+
+    // all the tiles in the order the players walk them
+    std::vector<StreetTile> m_tiles;
+
+    Edge m_downEdge;
+    Edge m_leftEdge;
+    Edge m_upEdge;
+    Edge m_rightEdge;
+
+    unsigned int m_BottomRightCorner; // the indices of the corners in m_tiles
+    unsigned int m_BottomLeftCorner;
+    unsigned int m_TopLeftCorner;
+    unsigned int m_TopRightCorner;
+    unsigned int m_jailIndex; // the index of the jail in m_tiles, the number of tiles if there is none
+
+    // the tokens of the players, walking around the board over the tiles
+    TokenAnimator m_tokens;
+    const Player* m_tokenPlayers[TokenAnimator::MAX_TOKENS]; // the player of each token, nullptr for a free token
+    unsigned int m_tokenTiles[TokenAnimator::MAX_TOKENS];    // the tile each token was last shown on, the number of tiles for none
+    std::string m_landingPlayers;                            // reused to join the names of the players on a tile
 
     // the size of the edges of the board
     float m_edgeSize;
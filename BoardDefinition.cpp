@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "BoardDefinition.hpp"
+
+namespace {
+    // the groups of the standard board, the four 200 streets are spaced like railroads so they form one group
+    enum StandardGroup : std::uint8_t { Red, Orange, Blue, Green, Magenta, Yellow, Cyan, LightBlue, Transport };
+
+    // the rent of every building level of a generated street, in tenths of its price
+    constexpr unsigned int GENERATED_RENT_TENTHS[6] = { 1, 5, 15, 40, 50, 60 };
+    // the hues of two groups in a row are this many degrees apart, so neighbouring groups never look alike
+    constexpr double GROUP_HUE_STEP = 137.50776405;
+
+    // an opaque RGBA color of a hue in degrees, a little less than fully saturated and bright
+    std::uint32_t hueColor(double hue){
+        const double saturation = 0.75;
+        const double value = 0.95;
+        double sector = std::fmod(hue, 360.0) / 60.0;
+        double chroma = value * saturation;
+        double second = chroma * (1.0 - std::fabs(std::fmod(sector, 2.0) - 1.0));
+        double rgb[3] = { 0.0, 0.0, 0.0 };
+        switch (static_cast<int>(sector)) {
+            case 0: rgb[0] = chroma; rgb[1] = second; break;
+            case 1: rgb[0] = second; rgb[1] = chroma; break;
+            case 2: rgb[1] = chroma; rgb[2] = second; break;
+            case 3: rgb[1] = second; rgb[2] = chroma; break;
+            case 4: rgb[0] = second; rgb[2] = chroma; break;
+            default: rgb[0] = chroma; rgb[2] = second; break;
+        }
+        std::uint32_t color = 0xFF;
+        for (int channel = 0; channel < 3; channel++) {
+            std::uint32_t byte = static_cast<std::uint32_t>(std::lround((rgb[channel] + value - chroma) * 255.0));
+            color |= byte << (24 - 8 * channel);
+        }
+        return color;
+    }
+
+    // prices and house prices are printed in tens
+    unsigned int roundPrice(double price){
+        return std::max(10u, 10 * static_cast<unsigned int>(std::lround(price / 10.0)));
+    }
+}
+
+BoardDefinition::BoardDefinition(std::vector<Tile> tiles)
+    : BoardDefinition(std::move(tiles), {}, {})
+{
+}
+
+BoardDefinition::BoardDefinition(std::vector<Tile> tiles, std::vector<Card> chance, std::vector<Card> communityChest)
+    : m_tiles(std::move(tiles)),
+      m_jailIndex(0)
+{
+    // Board indexes its four corners, and the games take every move modulo the tiles
+    if (m_tiles.size() < MIN_TILES || m_tiles.size() > MAX_TILES) {
+        throw std::invalid_argument("BoardDefinition: a board must have MIN_TILES to MAX_TILES tiles");
+    }
+    if (chance.size() > MAX_CARDS || communityChest.size() > MAX_CARDS) {
+        throw std::invalid_argument("BoardDefinition: a deck can't have more than MAX_CARDS cards");
+    }
+    m_decks[static_cast<unsigned int>(DeckKind::Chance)] = std::move(chance);
+    m_decks[static_cast<unsigned int>(DeckKind::CommunityChest)] = std::move(communityChest);
+
+    for (unsigned int i = 0; i < m_tiles.size(); i++) {
+        std::uint8_t group = m_tiles[i].group;
+        if (group == NO_GROUP) {
+            continue;
+        }
+        if (group >= m_groupTiles.size()) {
+            m_groupTiles.resize(group + 1);
+        }
+        m_groupTiles[group].push_back(i);
+    }
+    while (m_jailIndex < m_tiles.size() && m_tiles[m_jailIndex].kind != TileKind::Jail) {
+        m_jailIndex++;
+    }
+    m_auctions = AuctionEngine(*this);
+}
+
+const BoardDefinition& BoardDefinition::standard(){
+    // walked counter clockwise from Go, which Board draws at the bottom right corner, nine tiles between every two corners
+    static const BoardDefinition board = []{
+        const std::uint32_t orange = 0xFC9803FF;
+        const std::uint32_t red = 0xFF0000FF;
+        const std::uint32_t green = 0x00FF00FF;
+        const std::uint32_t blue = 0x0000FFFF;
+        const std::uint32_t magenta = 0xFF00FFFF;
+        const std::uint32_t yellow = 0xFFFF00FF;
+        const std::uint32_t cyan = 0x00FFFFFF;
+        const std::uint32_t lightBlue = 0xADD8E6FF;
+        const std::uint32_t gray = 0x808080FF;
+        const std::uint32_t white = 0xFFFFFFFF;
+
+        // a house costs more on every edge, nothing is built on the transports, which get a color of their own
+        auto street = [](const char* name, unsigned int price, std::uint32_t color, std::uint8_t group){
+            static const unsigned int housePrices[] = { 50, 50, 100, 100, 150, 150, 200, 200, 0 };
+            return Tile{ name, price, color, TileKind::Street, group, { 50, 100, 200, 400, 800, 200 }, housePrices[group] };
+        };
+        auto corner = [white](const char* name, TileKind kind){
+            return Tile{ name, 0, white, kind, NO_GROUP, { 0, 0, 0, 0, 0, 0 }, 0 };
+        };
+        auto chance = [white](){
+            return Tile{ "Chance", 0, white, TileKind::Chance, NO_GROUP, { 0, 0, 0, 0, 0, 0 }, 0 };
+        };
+        auto communityChest = [white](){
+            return Tile{ "Community Chest", 0, white, TileKind::CommunityChest, NO_GROUP, { 0, 0, 0, 0, 0, 0 }, 0 };
+        };
+
+        std::vector<Tile> tiles = {
+            corner("Go", TileKind::Go),
+            // down edge, right to left
+            street("Palmachim", 60, red, Red),
+            communityChest(),
+            street("Nitzanim", 50, red, Red),
+            street("Ashkelon", 50, red, Red),
+            street("Ashdod Port", 200, gray, Transport),
+            chance(),
+            street("Netivot", 60, orange, Orange),
+            street("Sderot", 80, orange, Orange),
+            street("Ofakim", 100, orange, Orange),
+            corner("Jail", TileKind::Jail),
+            // left edge, bottom to top
+            street("Yeruham", 70, blue, Blue),
+            street("Arad", 60, blue, Blue),
+            street("Dimona", 50, blue, Blue),
+            communityChest(),
+            street("Sde Boker", 50, blue, Blue),
+            street("Be'er Sheva University", 200, gray, Transport),
+            street("Mitzpe Ramon", 60, green, Green),
+            street("Yotvata", 60, green, Green),
+            street("Eilat", 100, green, Green),
+            corner("Free Parking", TileKind::FreeParking),
+            // up edge, left to right
+            street("Haifa", 100, magenta, Magenta),
+            chance(),
+            street("Acre", 80, magenta, Magenta),
+            street("Kiryat Ata", 60, magenta, Magenta),
+            street("Kiryat Motzkin", 60, magenta, Magenta),
+            street("Carmel Tunnels", 200, gray, Transport),
+            street("Tiberias", 50, yellow, Yellow),
+            street("Karmiel", 50, yellow, Yellow),
+            street("Tzfat", 60, yellow, Yellow),
+            corner("Go to Jail", TileKind::GoToJail),
+            // right edge, top to bottom
+            street("Tel Aviv", 100, cyan, Cyan),
+            street("Ramat Gan", 60, cyan, Cyan),
+            street("Bat Yam", 80, cyan, Cyan),
+            street("Holon", 60, cyan, Cyan),
+            street("Ayalon Highway", 200, gray, Transport),
+            chance(),
+            street("Rishon LeZion", 50, lightBlue, LightBlue),
+            street("Petah Tikva", 70, lightBlue, LightBlue),
+            street("Rehovot", 50, lightBlue, LightBlue),
+        };
+
+        // the cards that move the players name their tiles, so they follow the tiles if the board changes
+        auto indexOf = [&tiles](const char* name){
+            std::int32_t index = 0;
+            while (tiles[index].name != name) {
+                index++;
+            }
+            return index;
+        };
+        std::vector<Card> chanceCards = {
+            { CardOp::AdvanceTo, 0, 0, "Advance to Go (collect $200)" },
+            { CardOp::AdvanceTo, indexOf("Tel Aviv"), 0, "Advance to Tel Aviv" },
+            { CardOp::AdvanceTo, indexOf("Haifa"), 0, "Advance to Haifa" },
+            { CardOp::AdvanceTo, indexOf("Eilat"), 0, "Take a trip to Eilat" },
+            { CardOp::AdvanceTo, indexOf("Ashdod Port"), 0, "Take a trip to Ashdod Port" },
+            { CardOp::AdvanceToNearest, Transport, 0, "Advance to the nearest transport" },
+            { CardOp::AdvanceToNearest, Transport, 0, "Advance to the nearest transport" },
+            { CardOp::Collect, 50, 0, "Bank pays you a dividend of $50" },
+            { CardOp::GetOutOfJail, 0, 0, "Get out of jail free" },
+            { CardOp::MoveBy, -3, 0, "Go back 3 spaces" },
+            { CardOp::GoToJail, 0, 0, "Go to jail" },
+            { CardOp::Repairs, 25, 100, "General repairs: pay $25 per house and $100 per hotel" },
+            { CardOp::Pay, 15, 0, "Speeding fine $15" },
+            { CardOp::PayEach, 50, 0, "Elected chairman of the board: pay each player $50" },
+            { CardOp::Collect, 150, 0, "Your building loan matures: collect $150" },
+            { CardOp::Collect, 100, 0, "You won a crossword competition: collect $100" },
+        };
+        std::vector<Card> communityChestCards = {
+            { CardOp::AdvanceTo, 0, 0, "Advance to Go (collect $200)" },
+            { CardOp::Collect, 200, 0, "Bank error in your favor: collect $200" },
+            { CardOp::Pay, 50, 0, "Doctor's fee: pay $50" },
+            { CardOp::Collect, 50, 0, "From sale of stock you get $50" },
+            { CardOp::GetOutOfJail, 0, 0, "Get out of jail free" },
+            { CardOp::GoToJail, 0, 0, "Go to jail" },
+            { CardOp::Collect, 100, 0, "Holiday fund matures: collect $100" },
+            { CardOp::Collect, 20, 0, "Income tax refund: collect $20" },
+            { CardOp::CollectFromEach, 10, 0, "It is your birthday: collect $10 from every player" },
+            { CardOp::Collect, 100, 0, "Life insurance matures: collect $100" },
+            { CardOp::Pay, 100, 0, "Pay hospital fees of $100" },
+            { CardOp::Pay, 50, 0, "Pay school fees of $50" },
+            { CardOp::Collect, 25, 0, "Receive a $25 consultancy fee" },
+            { CardOp::Repairs, 40, 115, "Street repairs: pay $40 per house and $115 per hotel" },
+            { CardOp::Collect, 10, 0, "You won second prize in a beauty contest: collect $10" },
+            { CardOp::Collect, 100, 0, "You inherit $100" },
+        };
+        return BoardDefinition(std::move(tiles), std::move(chanceCards), std::move(communityChestCards));
+    }();
+    return board;
+}
+
+BoardDefinition BoardDefinition::generate(const GeneratorOptions& options){
+    if (options.numTiles < MIN_TILES || options.numTiles > MAX_TILES || options.minPrice == 0) {
+        throw std::invalid_argument("BoardDefinition: a generated board needs MIN_TILES to MAX_TILES tiles and a positive price");
+    }
+    const std::uint32_t white = 0xFFFFFFFF;
+    const unsigned int numTiles = options.numTiles;
+    std::vector<Tile> tiles(numTiles, Tile{ "", 0, white, TileKind::Street, NO_GROUP, { 0, 0, 0, 0, 0, 0 }, 0 });
+
+    // the corners, with the tiles between them split between the edges like Board::createTiles does
+    const TileKind cornerKinds[4] = { TileKind::Go, TileKind::Jail, TileKind::FreeParking, TileKind::GoToJail };
+    const char* const cornerNames[4] = { "Go", "Jail", "Free Parking", "Go to Jail" };
+    unsigned int edgeTiles = numTiles - 4;
+    unsigned int corner = 0;
+    for (unsigned int edge = 0; edge < 4; edge++) {
+        tiles[corner].name = cornerNames[edge];
+        tiles[corner].kind = cornerKinds[edge];
+        corner += 1 + edgeTiles / 4 + (edge >= 4 - edgeTiles % 4 ? 1 : 0);
+    }
+
+    // the card tiles every cardSpacing tiles between the corners, the decks taking turns, and the streets in between
+    std::vector<unsigned int> streets;
+    streets.reserve(edgeTiles);
+    unsigned int between = 0;
+    unsigned int numCardTiles = 0;
+    for (unsigned int i = 0; i < numTiles; i++) {
+        if (tiles[i].kind != TileKind::Street) {
+            continue;
+        }
+        if (options.cardSpacing > 0 && between++ % options.cardSpacing == options.cardSpacing / 2) {
+            bool communityChest = numCardTiles++ % 2 == 0;
+            tiles[i].name = communityChest ? "Community Chest" : "Chance";
+            tiles[i].kind = communityChest ? TileKind::CommunityChest : TileKind::Chance;
+            continue;
+        }
+        streets.push_back(i);
+    }
+
+    // a group is a byte and NO_GROUP is taken, so a huge board has larger groups rather than more of them
+    const unsigned int maxGroups = NO_GROUP;
+    unsigned int numStreets = static_cast<unsigned int>(streets.size());
+    unsigned int groupSize = std::max({ options.groupSize, 1u, (numStreets + maxGroups - 1) / maxGroups });
+    unsigned int numGroups = (numStreets + groupSize - 1) / groupSize;
+    double maxPrice = std::max(options.maxPrice, options.minPrice);
+    for (unsigned int street = 0; street < numStreets; street++) {
+        unsigned int group = street / groupSize;
+        double share = numGroups > 1 ? static_cast<double>(group) / (numGroups - 1) : 0.0;
+        double price = options.minPrice;
+        if (options.priceCurve == PriceCurve::Linear) {
+            price += (maxPrice - options.minPrice) * share;
+        } else if (options.priceCurve == PriceCurve::Exponential) {
+            price *= std::pow(maxPrice / options.minPrice, share);
+        }
+
+        Tile& tile = tiles[streets[street]];
+        tile.name = "Street " + std::to_string(street + 1);
+        tile.price = roundPrice(price);
+        tile.color = hueColor(group * GROUP_HUE_STEP);
+        tile.group = static_cast<std::uint8_t>(group);
+        for (unsigned int level = 0; level < 6; level++) {
+            tile.rents[level] = tile.price * GENERATED_RENT_TENTHS[level] / 10;
+        }
+        tile.housePrice = roundPrice(tile.price / 2.0);
+    }
+
+    // the standard decks, with the cards that advance to a tile moved to the street at the same share of the board
+    const BoardDefinition& standardBoard = standard();
+    std::vector<Card> decks[NUM_DECKS];
+    for (unsigned int deck = 0; deck < NUM_DECKS; deck++) {
+        for (Card card : standardBoard.getCards(static_cast<DeckKind>(deck))) {
+            if (card.op == CardOp::AdvanceTo && card.value != 0) {
+                if (streets.empty()) {
+                    continue;
+                }
+                unsigned int target = static_cast<unsigned int>(static_cast<std::uint64_t>(card.value) * numTiles / standardBoard.getNumTiles());
+                auto street = std::lower_bound(streets.begin(), streets.end(), target);
+                card.value = static_cast<std::int32_t>(street != streets.end() ? *street : streets.front());
+                card.text = "Advance to " + tiles[card.value].name;
+            } else if (card.op == CardOp::AdvanceToNearest) {
+                if (streets.empty()) {
+                    continue;
+                }
+                card.value %= static_cast<std::int32_t>(numGroups);
+                card.text = "Advance to the nearest street of group " + std::to_string(card.value + 1);
+            }
+            decks[deck].push_back(std::move(card));
+        }
+    }
+    return BoardDefinition(std::move(tiles), std::move(decks[static_cast<unsigned int>(DeckKind::Chance)]),
+                           std::move(decks[static_cast<unsigned int>(DeckKind::CommunityChest)]));
+}
+
+unsigned int BoardDefinition::getNumTiles() const {
+    return static_cast<unsigned int>(m_tiles.size());
+}
+
+const BoardDefinition::Tile& BoardDefinition::getTile(unsigned int index) const {
+    return m_tiles.at(index);
+}
+
+unsigned int BoardDefinition::getNumGroups() const {
+    return static_cast<unsigned int>(m_groupTiles.size());
+}
+
+unsigned int BoardDefinition::getGroupSize(std::uint8_t group) const {
+    return group < m_groupTiles.size() ? static_cast<unsigned int>(m_groupTiles[group].size()) : 0;
+}
+
+const std::vector<unsigned int>& BoardDefinition::getGroupTiles(std::uint8_t group) const {
+    return m_groupTiles.at(group);
+}
+
+unsigned int BoardDefinition::getJailIndex() const {
+    return m_jailIndex;
+}
+
+const std::vector<BoardDefinition::Card>& BoardDefinition::getCards(DeckKind deck) const {
+    return m_decks[static_cast<unsigned int>(deck)];
+}
+
+const AuctionEngine& BoardDefinition::getAuctions() const {
+    return m_auctions;
+}
+
+std::size_t BoardDefinition::getMemoryUsage() const {
+    std::size_t bytes = sizeof(*this) - sizeof(AuctionEngine) + m_auctions.getMemoryUsage()
+        + m_tiles.capacity() * sizeof(Tile) + m_groupTiles.capacity() * sizeof(m_groupTiles[0]);
+    for (const auto& group : m_groupTiles) {
+        bytes += group.capacity() * sizeof(unsigned int);
+    }
+    // the strings that don't fit in the string itself
+    auto stringBytes = [](const std::string& text){
+        return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+    };
+    for (const auto& tile : m_tiles) {
+        bytes += stringBytes(tile.name);
+    }
+    for (const auto& deck : m_decks) {
+        bytes += deck.capacity() * sizeof(Card);
+        for (const auto& card : deck) {
+            bytes += stringBytes(card.text);
+        }
+    }
+    return bytes;
+}
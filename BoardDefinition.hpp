@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AuctionEngine.hpp"
+
+/** @class BoardDefinition
+ *
+ * @brief The tiles of a board as they are printed on it: names, prices, colors, groups and rents.
+ *
+ * None of it changes during a game, so a single read only table is shared by every game played on
+ * that board, and each game only keeps the few bytes of state of every tile (see GameState::TileState).
+ */
+class BoardDefinition {
+public:
+    /** @enum TileKind
+     *  @brief What happens when a player lands on a tile.
+     */
+    enum class TileKind : std::uint8_t { Go, Jail, FreeParking, GoToJail, Street, Chance, CommunityChest };
+
+    /** @enum DeckKind
+     *  @brief The decks of cards, drawn from when landing on a Chance or a Community Chest tile.
+     */
+    enum class DeckKind : std::uint8_t { Chance, CommunityChest };
+
+    /** @brief The number of decks. */
+    static constexpr unsigned int NUM_DECKS = 2;
+
+    /** @brief The most cards in a deck, so a game keeps the order of its decks in fixed arrays. */
+    static constexpr unsigned int MAX_CARDS = 32;
+
+    /** @enum CardOp
+     *  @brief What a card does, the values of the card are its operands.
+     */
+    enum class CardOp : std::uint8_t {
+        Collect,            ///< Collect value from the bank.
+        Pay,                ///< Pay value to the bank.
+        CollectFromEach,    ///< Collect value from every other player.
+        PayEach,            ///< Pay value to every other player.
+        AdvanceTo,          ///< Advance to tile value, collecting the Go salary when passing it.
+        AdvanceToNearest,   ///< Advance to the next tile of group value, collecting the Go salary when passing it.
+        MoveBy,             ///< Move value tiles (backwards when negative), without collecting the Go salary.
+        GoToJail,           ///< Go straight to the jail.
+        GetOutOfJail,       ///< Keep the card, and leave the jail with it later.
+        Repairs             ///< Pay value for every house and value2 for every hotel.
+    };
+
+    /** @brief A card of a deck. */
+    struct Card {
+        CardOp op;                 ///< What the card does.
+        std::int32_t value;        ///< The first operand of the op.
+        std::int32_t value2;       ///< The second operand of the op, 0 when unused.
+        std::string text;          ///< The text printed on the card.
+    };
+
+    /** @brief The group of the tiles that don't belong to any group (the corners). */
+    static constexpr std::uint8_t NO_GROUP = 0xFF;
+
+    /** @brief What never changes about a tile. */
+    struct Tile {
+        std::string name;          ///< Name of the tile.
+        unsigned int price;        ///< Price of the tile.
+        std::uint32_t color;       ///< RGBA color of the tile's color strip.
+        TileKind kind;             ///< What happens when landing on the tile.
+        std::uint8_t group;        ///< The group (e.g. the color set) of the tile, NO_GROUP for none.
+        unsigned int rents[6];     ///< Rent for each building level (none, 1-4 houses, hotel).
+        unsigned int housePrice;   ///< Price of a house, and of a hotel over 4 houses, 0 if the tile can't be built on.
+    };
+
+    /** @enum PriceCurve
+     *  @brief How the prices of a generated board grow from its first group to its last.
+     */
+    enum class PriceCurve : std::uint8_t { Flat, Linear, Exponential };
+
+    /** @brief What a generated board looks like. */
+    struct GeneratorOptions {
+        unsigned int numTiles = 40;           ///< All the tiles with the corners, between MIN_TILES and MAX_TILES.
+        unsigned int groupSize = 3;           ///< The streets of a group, raised when the streets need more than 255 groups.
+        unsigned int cardSpacing = 8;         ///< One tile in this many between the corners is a card tile, 0 for none.
+        PriceCurve priceCurve = PriceCurve::Linear;
+        unsigned int minPrice = 60;           ///< The price of the streets of the first group.
+        unsigned int maxPrice = 400;          ///< The price of the streets of the last group.
+    };
+
+    /** @brief The fewest tiles of a board, Board draws four of them as its corners. */
+    static constexpr unsigned int MIN_TILES = 4;
+
+    /** @brief The most tiles of a board, the engines keep tile indices in 16 bits. */
+    static constexpr unsigned int MAX_TILES = 65536;
+
+    /** @brief Creates a board from its tiles.
+     *
+     * @param tiles The tiles, in the order the players walk them (starting at Go).
+     * @throws std::invalid_argument if there are fewer than MIN_TILES or more than MAX_TILES tiles.
+     */
+    explicit BoardDefinition(std::vector<Tile> tiles);
+
+    /** @brief Creates a board from its tiles and the cards of its decks.
+     *
+     * @param tiles The tiles, in the order the players walk them (starting at Go).
+     * @param chance The cards of the Chance deck.
+     * @param communityChest The cards of the Community Chest deck.
+     * @throws std::invalid_argument if there are fewer than MIN_TILES or more than MAX_TILES tiles, or a deck has
+     *         more than MAX_CARDS cards.
+     */
+    BoardDefinition(std::vector<Tile> tiles, std::vector<Card> chance, std::vector<Card> communityChest);
+
+    /** @brief Gets the standard board, the one the window draws. */
+    static const BoardDefinition& standard();
+
+    /** @brief Generates a board of any size, to stress the layout and the engines far beyond the standard board.
+     *
+     * The corners sit where Board draws them, the card tiles are spread evenly between them and the other tiles are
+     * streets, grouped in walking order with a color per group. The decks are the standard ones, with the cards that
+     * advance to a tile moved to the street at the same share of the board.
+     * @throws std::invalid_argument if numTiles is out of range or minPrice is 0.
+     */
+    static BoardDefinition generate(const GeneratorOptions& options);
+
+    //* Getters
+    unsigned int getNumTiles() const;
+    const Tile& getTile(unsigned int index) const;
+    /** @brief Gets the number of groups, the groups of the tiles are smaller. */
+    unsigned int getNumGroups() const;
+    /** @brief Gets the number of tiles in a group. */
+    unsigned int getGroupSize(std::uint8_t group) const;
+    /** @brief Gets the indices of the tiles of a group, in the order of the board. */
+    const std::vector<unsigned int>& getGroupTiles(std::uint8_t group) const;
+    /** @brief Gets the index of the jail tile, getNumTiles() if the board has none. */
+    unsigned int getJailIndex() const;
+    /** @brief Gets the cards of a deck, in the order they are printed (a game shuffles them, see CardDeck). */
+    const std::vector<Card>& getCards(DeckKind deck) const;
+    /** @brief Gets the bot valuations of the groups, worked out with the board. */
+    const AuctionEngine& getAuctions() const;
+    /** @brief Gets the bytes the table takes, shared by all the games on the board. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    //* MEMBERS
+    std::vector<Tile> m_tiles;
+    std::vector<std::vector<unsigned int>> m_groupTiles;  ///< The tiles of each group.
+    std::vector<Card> m_decks[NUM_DECKS];     ///< The cards of every deck, indexed by DeckKind.
+    unsigned int m_jailIndex;
+    AuctionEngine m_auctions;
+};
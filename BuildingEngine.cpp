@@ -0,0 +1,334 @@
+#include <algorithm>
+#include "BuildingEngine.hpp"
+
+namespace {
+    // the houses a hotel replaces
+    constexpr unsigned int HOUSES_PER_HOTEL = BuildingEngine::HOTEL_LEVEL - 1;
+
+    const std::vector<std::uint16_t> NO_SITES;
+}
+
+BuildingEngine::BuildingEngine(const BoardDefinition& board, unsigned int numPlayers)
+    : m_board(&board),
+      m_numPlayers(numPlayers),
+      m_groups(board.getNumGroups()),
+      m_owned(board.getNumGroups() * numPlayers, 0),
+      m_levels(board.getNumTiles(), 0),
+      m_tileSites(board.getNumTiles(), Site::None),
+      m_sitePositions(board.getNumTiles(), 0),
+      m_playerSites(numPlayers * 2),
+      m_counts(numPlayers, BuildingCounts{ 0, 0 }),
+      m_bankHouses(BANK_HOUSES),
+      m_bankHotels(BANK_HOTELS)
+{
+    for (unsigned int i = 0; i < m_groups.size(); i++) {
+        const std::vector<unsigned int>& tiles = board.getGroupTiles(static_cast<std::uint8_t>(i));
+        bool buildable = !tiles.empty() && std::all_of(tiles.begin(), tiles.end(), [&board](unsigned int tile){
+            return board.getTile(tile).housePrice > 0;
+        });
+        std::uint16_t size = static_cast<std::uint16_t>(tiles.size());
+        m_groups[i] = Group{ -1, 0, size, size, 0, buildable };
+        m_newLevels.resize(std::max<std::size_t>(m_newLevels.size(), size));
+    }
+}
+
+void BuildingEngine::setOwner(unsigned int tile, int oldOwner, int newOwner){
+    std::uint8_t group = m_board->getTile(tile).group;
+    if (group == BoardDefinition::NO_GROUP || oldOwner == newOwner) {
+        return;
+    }
+    Group& state = m_groups[group];
+
+    // the sets of the old monopoly owner lose the group before it changes hands
+    if (state.owner >= 0) {
+        for (unsigned int groupTile : m_board->getGroupTiles(group)) {
+            setSite(groupTile, Site::None);
+        }
+    }
+    if (oldOwner >= 0) {
+        m_owned[group * m_numPlayers + oldOwner]--;
+    }
+    state.owner = -1;
+    if (newOwner >= 0 && ++m_owned[group * m_numPlayers + newOwner] == state.size) {
+        state.owner = static_cast<std::int8_t>(newOwner);
+    }
+    refreshGroup(group);
+}
+
+void BuildingEngine::setMortgaged(unsigned int tile, bool mortgaged){
+    std::uint8_t group = m_board->getTile(tile).group;
+    if (group == BoardDefinition::NO_GROUP) {
+        return;
+    }
+    Group& state = m_groups[group];
+    state.mortgaged = static_cast<std::uint16_t>(mortgaged ? state.mortgaged + 1 : state.mortgaged - 1);
+    refreshGroup(group);
+}
+
+bool BuildingEngine::canBuild(unsigned int player, unsigned int tile) const {
+    if (tile >= m_tileSites.size()) {
+        return false;
+    }
+    std::uint8_t group = m_board->getTile(tile).group;
+    if (group == BoardDefinition::NO_GROUP || m_groups[group].owner != static_cast<int>(player)) {
+        return false;
+    }
+    switch (m_tileSites[tile]) {
+        case Site::House:
+            return m_bankHouses > 0;
+        case Site::Hotel:
+            return m_bankHotels > 0;
+        default:
+            return false;
+    }
+}
+
+bool BuildingEngine::canSell(unsigned int player, unsigned int tile) const {
+    if (tile >= m_levels.size() || m_levels[tile] == 0) {
+        return false;
+    }
+    std::uint8_t group = m_board->getTile(tile).group;
+    const Group& state = m_groups[group];
+    if (state.owner != static_cast<int>(player)) {
+        return false;
+    }
+    // only the tiles at the highest level of the group, which is the lowest one when they're all at it
+    unsigned int maxLevel = state.atMinLevel == state.size ? state.minLevel : state.minLevel + 1u;
+    if (m_levels[tile] != maxLevel) {
+        return false;
+    }
+    return m_levels[tile] < HOTEL_LEVEL || m_bankHouses >= HOUSES_PER_HOTEL;
+}
+
+unsigned int BuildingEngine::build(unsigned int tile){
+    std::uint8_t group = m_board->getTile(tile).group;
+    Group& state = m_groups[group];
+    BuildingCounts& counts = m_counts[state.owner];
+    if (m_levels[tile] + 1u == HOTEL_LEVEL) {
+        m_bankHotels--;
+        m_bankHouses += HOUSES_PER_HOTEL;
+        counts.houses -= HOUSES_PER_HOTEL;
+        counts.hotels++;
+    } else {
+        m_bankHouses--;
+        counts.houses++;
+    }
+    m_levels[tile]++;
+
+    // the last tile at the lowest level raises it, and the whole group can be built on again
+    if (--state.atMinLevel == 0) {
+        state.minLevel++;
+        state.atMinLevel = state.size;
+        refreshGroup(group);
+    } else {
+        setSite(tile, Site::None);
+    }
+    return m_levels[tile];
+}
+
+unsigned int BuildingEngine::sell(unsigned int tile){
+    std::uint8_t group = m_board->getTile(tile).group;
+    Group& state = m_groups[group];
+    BuildingCounts& counts = m_counts[state.owner];
+    if (m_levels[tile] == HOTEL_LEVEL) {
+        m_bankHotels++;
+        m_bankHouses -= HOUSES_PER_HOTEL;
+        counts.hotels--;
+        counts.houses += HOUSES_PER_HOTEL;
+    } else {
+        m_bankHouses++;
+        counts.houses--;
+    }
+    m_levels[tile]--;
+
+    // selling from a group at one level lowers it, and only the sold tile is at the new level
+    if (state.atMinLevel == state.size) {
+        state.minLevel--;
+        state.atMinLevel = 1;
+        refreshGroup(group);
+    } else {
+        state.atMinLevel++;
+        setSite(tile, getGroupSite(state));
+    }
+    return m_levels[tile];
+}
+
+bool BuildingEngine::getLevelsAfterSelling(std::uint8_t group, unsigned int count, std::uint8_t* levels) const {
+    const std::vector<unsigned int>& tiles = m_board->getGroupTiles(group);
+    unsigned int size = static_cast<unsigned int>(tiles.size());
+    unsigned int left = getGroupBuildings(group) - std::min(count, getGroupBuildings(group));
+    unsigned int level = left / size;
+    unsigned int extra = left % size;
+    for (unsigned int i = 0; i < size; i++) {
+        levels[i] = static_cast<std::uint8_t>(level);
+    }
+
+    // the leftover buildings go one by one where they add the most rent, on tiles that already have them
+    for (unsigned int placed = 0; placed < extra; placed++) {
+        unsigned int best = size;
+        unsigned int bestRent = 0;
+        for (unsigned int i = 0; i < size; i++) {
+            const BoardDefinition::Tile& tile = m_board->getTile(tiles[i]);
+            unsigned int rent = tile.rents[level + 1] - std::min(tile.rents[level + 1], tile.rents[level]);
+            if (levels[i] == level && m_levels[tiles[i]] > level && (best == size || rent > bestRent)) {
+                best = i;
+                bestRent = rent;
+            }
+        }
+        levels[best]++;
+    }
+
+    // the houses standing once the hotels are sold down can't be more than the bank has
+    unsigned int housesBefore = 0;
+    unsigned int housesAfter = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        housesBefore += m_levels[tiles[i]] < HOTEL_LEVEL ? m_levels[tiles[i]] : 0;
+        housesAfter += levels[i] < HOTEL_LEVEL ? levels[i] : 0;
+    }
+    return housesAfter <= housesBefore + m_bankHouses;
+}
+
+bool BuildingEngine::sellDown(std::uint8_t group, unsigned int count){
+    Group& state = m_groups[group];
+    if (count == 0 || state.owner < 0) {
+        return count == 0;
+    }
+    if (!getLevelsAfterSelling(group, count, m_newLevels.data())) {
+        return false;
+    }
+    BuildingCounts& counts = m_counts[state.owner];
+    const std::vector<unsigned int>& tiles = m_board->getGroupTiles(group);
+    for (unsigned int i = 0; i < tiles.size(); i++) {
+        std::uint8_t& level = m_levels[tiles[i]];
+        if (level == HOTEL_LEVEL) {
+            m_bankHotels++;
+            counts.hotels--;
+        } else {
+            m_bankHouses += level;
+            counts.houses -= level;
+        }
+        level = m_newLevels[i];
+        if (level == HOTEL_LEVEL) {
+            m_bankHotels--;
+            counts.hotels++;
+        } else {
+            m_bankHouses -= level;
+            counts.houses += level;
+        }
+    }
+    unsigned int left = getGroupBuildings(group) - count;
+    state.minLevel = static_cast<std::uint8_t>(left / state.size);
+    state.atMinLevel = static_cast<std::uint16_t>(state.size - left % state.size);
+    refreshGroup(group);
+    return true;
+}
+
+unsigned int BuildingEngine::sellAll(std::uint8_t group){
+    unsigned int sold = getGroupBuildings(group);
+    sellDown(group, sold);
+    return sold;
+}
+
+void BuildingEngine::refreshGroup(std::uint8_t group){
+    const Group& state = m_groups[group];
+    Site site = state.owner >= 0 && state.mortgaged == 0 ? getGroupSite(state) : Site::None;
+    for (unsigned int tile : m_board->getGroupTiles(group)) {
+        setSite(tile, m_levels[tile] == state.minLevel ? site : Site::None);
+    }
+}
+
+BuildingEngine::Site BuildingEngine::getGroupSite(const Group& group) const {
+    if (!group.buildable || group.minLevel >= HOTEL_LEVEL) {
+        return Site::None;
+    }
+    return group.minLevel + 1u == HOTEL_LEVEL ? Site::Hotel : Site::House;
+}
+
+void BuildingEngine::setSite(unsigned int tile, Site site){
+    Site current = m_tileSites[tile];
+    if (current == site) {
+        return;
+    }
+    // only the monopoly owner of the group has its tiles in their sets
+    unsigned int owner = static_cast<unsigned int>(m_groups[m_board->getTile(tile).group].owner);
+    if (current != Site::None) {
+        std::vector<std::uint16_t>& sites = getSites(owner, current);
+        std::uint16_t position = m_sitePositions[tile];
+        sites[position] = sites.back();
+        m_sitePositions[sites[position]] = position;
+        sites.pop_back();
+    }
+    if (site != Site::None) {
+        std::vector<std::uint16_t>& sites = getSites(owner, site);
+        m_sitePositions[tile] = static_cast<std::uint16_t>(sites.size());
+        sites.push_back(static_cast<std::uint16_t>(tile));
+    }
+    m_tileSites[tile] = site;
+}
+
+std::vector<std::uint16_t>& BuildingEngine::getSites(unsigned int player, Site site){
+    return m_playerSites[player * 2 + (site == Site::Hotel ? 1 : 0)];
+}
+
+const std::vector<std::uint16_t>& BuildingEngine::getHouseSites(unsigned int player) const {
+    return m_bankHouses > 0 ? m_playerSites.at(player * 2) : NO_SITES;
+}
+
+const std::vector<std::uint16_t>& BuildingEngine::getHotelSites(unsigned int player) const {
+    return m_bankHotels > 0 ? m_playerSites.at(player * 2 + 1) : NO_SITES;
+}
+
+bool BuildingEngine::canBuildAnywhere(unsigned int player) const {
+    return !getHouseSites(player).empty() || !getHotelSites(player).empty();
+}
+
+unsigned int BuildingEngine::getGroupBuildings(std::uint8_t group) const {
+    if (group >= m_groups.size()) {
+        return 0;
+    }
+    const Group& state = m_groups[group];
+    return state.minLevel * state.size + (state.size - state.atMinLevel);
+}
+
+unsigned int BuildingEngine::getOwnedCount(std::uint8_t group, unsigned int player) const {
+    return group < m_groups.size() && player < m_numPlayers ? m_owned[group * m_numPlayers + player] : 0;
+}
+
+unsigned int BuildingEngine::getLevel(unsigned int tile) const {
+    return m_levels.at(tile);
+}
+
+int BuildingEngine::getMonopolyOwner(std::uint8_t group) const {
+    return group < m_groups.size() ? m_groups[group].owner : -1;
+}
+
+bool BuildingEngine::hasBuildings(std::uint8_t group) const {
+    if (group >= m_groups.size()) {
+        return false;
+    }
+    const Group& state = m_groups[group];
+    return state.minLevel > 0 || state.atMinLevel < state.size;
+}
+
+BuildingEngine::BuildingCounts BuildingEngine::getBuildingCounts(unsigned int player) const {
+    return m_counts.at(player);
+}
+
+unsigned int BuildingEngine::getBankHouses() const {
+    return m_bankHouses;
+}
+
+unsigned int BuildingEngine::getBankHotels() const {
+    return m_bankHotels;
+}
+
+std::size_t BuildingEngine::getMemoryUsage() const {
+    std::size_t bytes = m_groups.capacity() * sizeof(Group) + m_owned.capacity() * sizeof(std::uint16_t)
+        + m_levels.capacity() + m_tileSites.capacity() * sizeof(Site) + m_sitePositions.capacity() * sizeof(std::uint16_t)
+        + m_playerSites.capacity() * sizeof(m_playerSites[0]) + m_counts.capacity() * sizeof(BuildingCounts)
+        + m_newLevels.capacity();
+    for (const auto& sites : m_playerSites) {
+        bytes += sites.capacity() * sizeof(std::uint16_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BoardDefinition.hpp"
+
+/** @class BuildingEngine
+ *
+ * @brief The building rules of one game: monopolies, the even-build rule and the bank's supply of houses and hotels.
+ *
+ * A player can build on a tile once they own its whole group, none of the group is mortgaged, and the tile has
+ * no more buildings than any other tile of the group. Every build takes a house from the bank (32 of them), and the
+ * fifth takes a hotel (12 of them) and returns the 4 houses. Selling goes the other way, from the tiles with the
+ * most buildings.
+ *
+ * Evenly built, the tiles of a group are at most one building apart, so a group only keeps its lowest level and
+ * how many tiles are at it: those are the tiles that can be built on, and the tiles at the level above are the ones
+ * that can be sold. The tiles every player can build on are kept in two sets per player, those that take a house and
+ * those that take a hotel, updated as the owners, mortgages and buildings change. Whether a player can build on a
+ * tile, and on which tiles they can build, is then answered without looking at their other tiles.
+ *
+ * GameState calls the engine whenever a tile changes hands or is mortgaged, and builds and sells through it.
+ * The building level of every tile is kept here, the game's TileState only shows a copy of it.
+ */
+class BuildingEngine {
+public:
+    /** @brief The houses and hotels the bank starts with. */
+    static constexpr unsigned int BANK_HOUSES = 32;
+    static constexpr unsigned int BANK_HOTELS = 12;
+
+    /** @brief The building level of a hotel, the levels below it are the number of houses. */
+    static constexpr unsigned int HOTEL_LEVEL = 5;
+
+    /** @brief The houses and hotels standing on the tiles of one player. */
+    struct BuildingCounts {
+        unsigned int houses;
+        unsigned int hotels;
+    };
+
+    /** @brief Creates the engine of a game where the bank owns every tile.
+     *
+     * @param board The tiles of the board, it must outlive the engine.
+     * @param numPlayers The number of players of the game.
+     */
+    BuildingEngine(const BoardDefinition& board, unsigned int numPlayers);
+
+    /** @brief Tells the engine a tile changed hands, its group must have no buildings.
+     *
+     * @param tile The index of the tile.
+     * @param oldOwner The index of the player that owned it, -1 for the bank.
+     * @param newOwner The index of the player that owns it now, -1 for the bank.
+     */
+    void setOwner(unsigned int tile, int oldOwner, int newOwner);
+
+    /** @brief Tells the engine a tile was mortgaged or redeemed, its group must have no buildings. */
+    void setMortgaged(unsigned int tile, bool mortgaged);
+
+    /** @brief Checks if a player can build on a tile now: the rules and the bank's supply, not their money. */
+    bool canBuild(unsigned int player, unsigned int tile) const;
+
+    /** @brief Checks if a player can sell a building of a tile now (a hotel needs 4 houses in the bank). */
+    bool canSell(unsigned int player, unsigned int tile) const;
+
+    /** @brief Builds one more building on a tile, canBuild() must be true.
+     *
+     * @param tile The index of the tile, at the lowest level of its group.
+     * @return The new building level of the tile.
+     */
+    unsigned int build(unsigned int tile);
+
+    /** @brief Sells one building of a tile back to the bank, canSell() must be true.
+     *
+     * @param tile The index of the tile, at the highest level of its group.
+     * @return The new building level of the tile.
+     */
+    unsigned int sell(unsigned int tile);
+
+    /** @brief Computes the levels of the tiles of a group after selling some of its buildings at once, evenly.
+     *
+     * the group ends up as even as it can, and the buildings left over stay on the tiles where they are worth the
+     * most rent. Hotels sold down to houses need those houses from the bank.
+     * @param group The group.
+     * @param count The number of buildings to sell, counting a hotel as HOTEL_LEVEL, at most getGroupBuildings().
+     * @param levels The new level of every tile of the group, in the order of BoardDefinition::getGroupTiles().
+     * @return Whether the bank has the houses the sale needs.
+     */
+    bool getLevelsAfterSelling(std::uint8_t group, unsigned int count, std::uint8_t* levels) const;
+
+    /** @brief Sells some of the buildings of a group back to the bank at once, see getLevelsAfterSelling().
+     *
+     * @param group The group.
+     * @param count The number of buildings to sell, counting a hotel as HOTEL_LEVEL.
+     * @return Whether they were sold, false if the bank lacks the houses the sale needs.
+     */
+    bool sellDown(std::uint8_t group, unsigned int count);
+
+    /** @brief Sells all the buildings of a group back to the bank at once, e.g. when its owner goes bankrupt.
+     *
+     * @param group The group.
+     * @return The number of buildings sold, counting a hotel as HOTEL_LEVEL.
+     */
+    unsigned int sellAll(std::uint8_t group);
+
+    //* Getters
+    /** @brief Gets the tiles a player can build a house on now, empty while the bank has no houses. */
+    const std::vector<std::uint16_t>& getHouseSites(unsigned int player) const;
+    /** @brief Gets the tiles a player can build a hotel on now, empty while the bank has no hotels. */
+    const std::vector<std::uint16_t>& getHotelSites(unsigned int player) const;
+    /** @brief Checks if a player can build anywhere now. */
+    bool canBuildAnywhere(unsigned int player) const;
+    /** @brief Gets the player that owns the whole group, -1 if none. */
+    int getMonopolyOwner(std::uint8_t group) const;
+    /** @brief Checks if a group has buildings, then none of its tiles can change hands or be mortgaged. */
+    bool hasBuildings(std::uint8_t group) const;
+    /** @brief Gets the buildings of a group, counting a hotel as HOTEL_LEVEL. */
+    unsigned int getGroupBuildings(std::uint8_t group) const;
+    /** @brief Gets the number of tiles of a group a player owns. */
+    unsigned int getOwnedCount(std::uint8_t group, unsigned int player) const;
+    unsigned int getLevel(unsigned int tile) const;
+    BuildingCounts getBuildingCounts(unsigned int player) const;
+    unsigned int getBankHouses() const;
+    unsigned int getBankHotels() const;
+
+    /** @brief Gets the bytes the engine takes, without the board. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /** @brief What a group keeps to follow its monopoly and its even buildings. */
+    struct Group {
+        std::int8_t owner;         ///< The player owning the whole group, -1 if none.
+        std::uint8_t minLevel;     ///< The lowest building level of the group, the others are one above it.
+        std::uint16_t atMinLevel;  ///< The number of tiles at the lowest level.
+        std::uint16_t size;
+        std::uint16_t mortgaged;   ///< The number of mortgaged tiles.
+        bool buildable;            ///< Whether all the tiles of the group can be built on.
+    };
+
+    /** @brief Which set of its owner a tile is in. */
+    enum class Site : std::uint8_t { None, House, Hotel };
+
+    /** @brief Puts the tiles of a group at its lowest level in the sets of its owner, and takes the others out. */
+    void refreshGroup(std::uint8_t group);
+
+    /** @brief Gets the set the tiles of a group at its lowest level belong to. */
+    Site getGroupSite(const Group& group) const;
+
+    /** @brief Moves a tile to a set of the monopoly owner of its group, or takes it out with Site::None. */
+    void setSite(unsigned int tile, Site site);
+
+    /** @brief Gets a set of a player. */
+    std::vector<std::uint16_t>& getSites(unsigned int player, Site site);
+
+    //* MEMBERS
+    const BoardDefinition* m_board;
+    unsigned int m_numPlayers;
+    std::vector<Group> m_groups;
+    std::vector<std::uint16_t> m_owned;            ///< The tiles of every group every player owns, numPlayers per group.
+    std::vector<std::uint8_t> m_levels;            ///< The building level of every tile, GameState shows a copy.
+    std::vector<Site> m_tileSites;                 ///< The set every tile is in.
+    std::vector<std::uint16_t> m_sitePositions;    ///< The position of every tile in its set.
+    std::vector<std::vector<std::uint16_t>> m_playerSites; ///< The house set, then the hotel set, of every player.
+    std::vector<BuildingCounts> m_counts;          ///< The buildings of every player.
+    std::vector<std::uint8_t> m_newLevels;         ///< The levels of a group being sold down, as big as the biggest group.
+    unsigned int m_bankHouses;
+    unsigned int m_bankHotels;
+};
@@ -0,0 +1,62 @@
+#include <utility>
+#include "CardDeck.hpp"
+
+static_assert(BoardDefinition::MAX_CARDS <= 32, "CardDeck keeps the held cards in a 32 bit mask");
+
+CardDeck::CardDeck()
+    : m_order(),
+      m_numCards(0),
+      m_cursor(0),
+      m_held(0)
+{
+}
+
+void CardDeck::reset(unsigned int numCards, Dice& dice){
+    m_numCards = static_cast<std::uint8_t>(numCards < BoardDefinition::MAX_CARDS ? numCards : BoardDefinition::MAX_CARDS);
+    for (unsigned int i = 0; i < m_numCards; i++) {
+        m_order[i] = static_cast<std::uint8_t>(i);
+    }
+    m_held = 0;
+    shuffle(dice);
+}
+
+unsigned int CardDeck::draw(Dice& dice){
+    // at most the held cards are skipped, so this ends unless every card is held
+    for (unsigned int tries = 0; tries <= m_numCards; tries++) {
+        if (m_cursor >= m_numCards) {
+            if (m_numCards == 0) {
+                return NO_CARD;
+            }
+            shuffle(dice);
+        }
+        unsigned int card = m_order[m_cursor++];
+        if (!(m_held & (1u << card))) {
+            return card;
+        }
+    }
+    return NO_CARD;
+}
+
+void CardDeck::hold(unsigned int card){
+    if (card < m_numCards) {
+        m_held |= 1u << card;
+    }
+}
+
+void CardDeck::returnHeldCard(unsigned int card){
+    if (card < m_numCards) {
+        m_held &= ~(1u << card);
+    }
+}
+
+unsigned int CardDeck::getNumCards() const {
+    return m_numCards;
+}
+
+void CardDeck::shuffle(Dice& dice){
+    for (unsigned int i = m_numCards; i > 1; i--) {
+        unsigned int j = dice.nextBelow(i);
+        std::swap(m_order[i - 1], m_order[j]);
+    }
+    m_cursor = 0;
+}
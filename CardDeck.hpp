@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "BoardDefinition.hpp"
+#include "Dice.hpp"
+
+/** @class CardDeck
+ *
+ * @brief The order of the cards of one deck in one game.
+ *
+ * The cards themselves are data of the board (see BoardDefinition::getCards()), a deck only keeps their indices
+ * in a fixed array and a cursor into it. Drawing takes the card under the cursor. When the cursor reaches the end,
+ * the deck is shuffled again with Fisher-Yates, using the random stream of the game's dice, so a game replays
+ * the same cards from the same seed. Nothing is ever allocated.
+ *
+ * A "get out of jail free" card stays with the player who drew it until it's used: it's marked as held, and
+ * skipped by the draws until it's returned.
+ */
+class CardDeck {
+public:
+    /** @brief What draw() returns when there is no card to draw. */
+    static constexpr unsigned int NO_CARD = BoardDefinition::MAX_CARDS;
+
+    /** @brief Creates an empty deck, see reset(). */
+    CardDeck();
+
+    /** @brief Fills the deck with the cards [0, numCards) and shuffles it.
+     *
+     * @param numCards The number of cards, at most BoardDefinition::MAX_CARDS.
+     * @param dice The random stream of the game.
+     */
+    void reset(unsigned int numCards, Dice& dice);
+
+    /** @brief Draws the next card that isn't held, shuffling the deck when it ran out.
+     *
+     * @param dice The random stream of the game.
+     * @return The index of the card in the deck's cards, NO_CARD if the deck is empty or all its cards are held.
+     */
+    unsigned int draw(Dice& dice);
+
+    /** @brief Marks a drawn card as held by a player, so it isn't drawn again until it's returned. */
+    void hold(unsigned int card);
+
+    /** @brief Returns a held card to the deck, so it can be drawn again. */
+    void returnHeldCard(unsigned int card);
+
+    /** @brief Gets the number of cards in the deck, held cards included. */
+    unsigned int getNumCards() const;
+
+private:
+    /** @brief Shuffles the whole deck and moves the cursor to its top. */
+    void shuffle(Dice& dice);
+
+    //* MEMBERS
+    std::uint8_t m_order[BoardDefinition::MAX_CARDS];  ///< The indices of the cards, in the order they are drawn.
+    std::uint8_t m_numCards;
+    std::uint8_t m_cursor;                             ///< The position of the next card in m_order.
+    std::uint32_t m_held;                              ///< A bit for every held card, by card index.
+};
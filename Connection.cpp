@@ -0,0 +1,172 @@
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "Connection.hpp"
+
+namespace {
+    // the most buffers handed to one writev
+    constexpr std::size_t MAX_IOVECS = 64;
+}
+
+Connection::Connection(int fd, int epollFd)
+    : m_fd(fd),
+      m_epollFd(epollFd),
+      m_outOffset(0),
+      m_queuedBytes(0),
+      m_wantsWrite(false)
+{
+}
+
+void Connection::send(const SharedBuffer* buffers, std::size_t count){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0) {
+        return;
+    }
+    std::size_t added = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (buffers[i] && !buffers[i]->empty()) {
+            m_outQueue.push_back(buffers[i]);
+            added += buffers[i]->size();
+        }
+    }
+    m_queuedBytes += added;
+
+    // nothing was waiting before, so the socket may take it right away
+    if (!m_wantsWrite) {
+        flushLocked();
+        if (!m_outQueue.empty()) {
+            setWantsWrite(true);
+        }
+    }
+}
+
+void Connection::onWritable(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0) {
+        return;
+    }
+    flushLocked();
+    if (m_outQueue.empty()) {
+        setWantsWrite(false);
+    }
+}
+
+void Connection::close(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0) {
+        return;
+    }
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_fd, nullptr);
+    ::close(m_fd);
+    m_fd = -1;
+    m_outQueue.clear();
+    m_queuedBytes = 0;
+}
+
+bool Connection::isClosed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fd < 0;
+}
+
+std::size_t Connection::getQueuedBytes() const {
+    return m_queuedBytes.load(std::memory_order_relaxed);
+}
+
+int Connection::getFd() const {
+    return m_fd;
+}
+
+Protocol::FrameDecoder& Connection::getDecoder(){
+    return m_decoder;
+}
+
+void Connection::flushLocked(){
+    iovec vectors[MAX_IOVECS];
+    while (!m_outQueue.empty()) {
+        // gather the front of the queue
+        std::size_t count = 0;
+        for (auto it = m_outQueue.begin(); it != m_outQueue.end() && count < MAX_IOVECS; ++it, ++count) {
+            std::size_t skip = (count == 0) ? m_outOffset : 0;
+            vectors[count].iov_base = const_cast<std::uint8_t*>((*it)->data() + skip);
+            vectors[count].iov_len = (*it)->size() - skip;
+        }
+
+        msghdr message{};
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(m_fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN: wait for EPOLLOUT, other errors: the network thread will see EPOLLERR/EPOLLHUP
+            return;
+        }
+        m_queuedBytes -= static_cast<std::size_t>(sent);
+
+        // drop the buffers that were fully written
+        std::size_t remaining = static_cast<std::size_t>(sent);
+        while (remaining > 0) {
+            std::size_t frontLeft = m_outQueue.front()->size() - m_outOffset;
+            if (remaining < frontLeft) {
+                m_outOffset += remaining;
+                break;
+            }
+            remaining -= frontLeft;
+            m_outQueue.pop_front();
+            m_outOffset = 0;
+        }
+    }
+}
+
+void Connection::setWantsWrite(bool wantsWrite){
+    if (m_wantsWrite == wantsWrite) {
+        return;
+    }
+    m_wantsWrite = wantsWrite;
+    epoll_event event{};
+    event.events = wantsWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.fd = m_fd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_MOD, m_fd, &event);
+}
+
+//* SendBatch
+SendBatch::Pending& SendBatch::pendingFor(const std::shared_ptr<Connection>& connection){
+    auto found = m_index.find(connection.get());
+    if (found != m_index.end()) {
+        return m_pending[found->second];
+    }
+    m_index.emplace(connection.get(), m_pending.size());
+    m_pending.push_back(Pending{ connection, {}, {} });
+    return m_pending.back();
+}
+
+Connection::Buffer& SendBatch::replyBuffer(const std::shared_ptr<Connection>& connection){
+    return pendingFor(connection).reply;
+}
+
+void SendBatch::add(const std::shared_ptr<Connection>& connection, const Connection::SharedBuffer& buffer){
+    Pending& pending = pendingFor(connection);
+    sealReply(pending);
+    pending.buffers.push_back(buffer);
+}
+
+void SendBatch::sealReply(Pending& pending){
+    if (!pending.reply.empty()) {
+        pending.buffers.push_back(std::make_shared<const Connection::Buffer>(std::move(pending.reply)));
+        pending.reply = Connection::Buffer();
+    }
+}
+
+void SendBatch::flush(){
+    for (auto& pending : m_pending) {
+        sealReply(pending);
+        if (!pending.buffers.empty()) {
+            pending.connection->send(pending.buffers.data(), pending.buffers.size());
+        }
+    }
+    m_pending.clear();
+    m_index.clear();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Protocol.hpp"
+
+/** @class Connection
+ *
+ * @brief A client socket of the GameServer with a zero-copy outgoing queue.
+ *
+ * The queue holds shared, immutable buffers: a frame broadcast to many clients (e.g. a spectator delta)
+ * is encoded once and referenced by the queue of every recipient, then written with writev.
+ * Any thread may send; reading and closing belong to the network thread.
+ */
+class Connection {
+public:
+    using Buffer = std::vector<std::uint8_t>;
+    using SharedBuffer = std::shared_ptr<const Buffer>;
+
+    /** @brief Wraps a connected, non blocking socket.
+     *
+     * @param fd The socket.
+     * @param epollFd The epoll instance of the network thread, used to wait for the socket to drain.
+     */
+    Connection(int fd, int epollFd);
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    /** @brief Queues buffers and writes as much of the queue as the socket accepts.
+     *
+     * What the socket does not accept now is written by the network thread once it is writable.
+     */
+    void send(const SharedBuffer* buffers, std::size_t count);
+
+    /** @brief Writes the queued buffers, called by the network thread when the socket is writable. */
+    void onWritable();
+
+    /** @brief Closes the socket, later sends are dropped. */
+    void close();
+
+    /** @brief Whether the connection was closed. */
+    bool isClosed() const;
+
+    /** @brief Gets the number of queued bytes the socket did not accept yet. */
+    std::size_t getQueuedBytes() const;
+
+    /** @brief Gets the socket. */
+    int getFd() const;
+
+    /** @brief Gets the frame decoder of the incoming stream, only used by the network thread. */
+    Protocol::FrameDecoder& getDecoder();
+
+private:
+    /** @brief Writes as much of the queue as possible. Expects m_mutex to be locked. */
+    void flushLocked();
+
+    /** @brief Arms or disarms EPOLLOUT for the socket. Expects m_mutex to be locked. */
+    void setWantsWrite(bool wantsWrite);
+
+    //* MEMBERS
+    int m_fd;
+    int m_epollFd;
+    mutable std::mutex m_mutex;              ///< Guards m_fd, the queue and m_wantsWrite.
+    std::deque<SharedBuffer> m_outQueue;     ///< The buffers waiting to be written, in order.
+    std::size_t m_outOffset;                 ///< The number of bytes of the front buffer already written.
+    std::atomic<std::size_t> m_queuedBytes;  ///< The unwritten bytes in the queue.
+    bool m_wantsWrite;                       ///< Whether EPOLLOUT is armed for the socket.
+    Protocol::FrameDecoder m_decoder;
+};
+
+/** @class SendBatch
+ *
+ * @brief Gathers everything a shard sends while handling one batch of events.
+ *
+ * Each connection then gets a single send() per batch, whatever the number of frames queued for it.
+ * Frames for one connection keep the order they were added in.
+ */
+class SendBatch {
+public:
+    /** @brief Gets a buffer to encode frames that are only sent to this connection (e.g. replies). */
+    Connection::Buffer& replyBuffer(const std::shared_ptr<Connection>& connection);
+
+    /** @brief Adds a shared buffer (e.g. a broadcast frame) for this connection, without copying it. */
+    void add(const std::shared_ptr<Connection>& connection, const Connection::SharedBuffer& buffer);
+
+    /** @brief Sends everything gathered so far and empties the batch. */
+    void flush();
+
+private:
+    /** @brief What is waiting for one connection. */
+    struct Pending {
+        std::shared_ptr<Connection> connection;
+        Connection::Buffer reply;                   ///< Reply frames added after the last shared buffer.
+        std::vector<Connection::SharedBuffer> buffers;
+    };
+
+    /** @brief Finds or creates the pending entry of a connection. */
+    Pending& pendingFor(const std::shared_ptr<Connection>& connection);
+
+    /** @brief Moves the reply bytes of an entry into its list of buffers. */
+    static void sealReply(Pending& pending);
+
+    //* MEMBERS
+    std::vector<Pending> m_pending;
+    std::unordered_map<const Connection*, std::size_t> m_index; ///< Connection -> index in m_pending.
+};
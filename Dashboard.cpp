@@ -0,0 +1,204 @@
+#include <algorithm>
+#include "Board.hpp"
+#include "Dashboard.hpp"
+#include "Player.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    // the owner of a tile tints it, so the board stays readable under it
+    constexpr sf::Uint8 OWNER_ALPHA = 150;
+    const sf::Color HOUSE_COLOR(20, 120, 20);
+    const sf::Color HOTEL_COLOR(200, 0, 0);
+    // the building level of a hotel
+    constexpr unsigned int HOTEL_LEVEL = 5;
+    // the share of a cell taken by its thumbnail, the rest is the gap between the thumbnails
+    constexpr float THUMBNAIL_FILL = 0.96f;
+}
+
+Dashboard::Dashboard(const sf::Vector2f& size, unsigned int numGames, float cornersRatio, sf::Font& font,
+                     const BoardDefinition& definition)
+    : m_size(size),
+      m_numGames(numGames),
+      m_numTiles(definition.getNumTiles()),
+      m_quadsPerGame(2 * definition.getNumTiles() + GameState::MAX_PLAYERS),
+      m_columns(1),
+      m_cellSize(0.f),
+      m_thumbnailSize(0.f),
+      m_thumbnails(sf::Quads, numGames * 4),
+      m_overlay(sf::Quads, numGames * m_quadsPerGame * 4)
+{
+    createBoardImage(cornersRatio, font, definition);
+
+    ShownGame empty;
+    empty.tiles.assign(m_numTiles, GameState::TileState{ -1, 0, false });
+    std::fill(std::begin(empty.positions), std::end(empty.positions), -1);
+    m_shownGames.assign(numGames, empty);
+
+    layoutThumbnails();
+}
+
+void Dashboard::createBoardImage(float cornersRatio, sf::Font& font, const BoardDefinition& definition){
+    PROFILE_ZONE("Dashboard::createBoardImage");
+    Board board(static_cast<float>(BOARD_IMAGE_SIZE), cornersRatio, font, definition);
+    m_tileRects.resize(m_numTiles);
+    for (unsigned int i = 0; i < m_numTiles; i++) {
+        sf::FloatRect bounds = board.getTile(i)->getBounds();
+        m_tileRects[i] = sf::FloatRect(bounds.left / BOARD_IMAGE_SIZE, bounds.top / BOARD_IMAGE_SIZE,
+                                       bounds.width / BOARD_IMAGE_SIZE, bounds.height / BOARD_IMAGE_SIZE);
+    }
+
+    // a thumbnail is a fraction of the image's size, the mipmaps keep the scaled down board smooth
+    if (m_boardImage.create(BOARD_IMAGE_SIZE, BOARD_IMAGE_SIZE)) {
+        m_boardImage.clear(sf::Color::White);
+        m_boardImage.draw(board);
+        m_boardImage.display();
+        m_boardImage.setSmooth(true);
+        m_boardImage.generateMipmap();
+    }
+}
+
+void Dashboard::resize(const sf::Vector2f& size){
+    m_size = size;
+    layoutThumbnails();
+}
+
+void Dashboard::layoutThumbnails(){
+    PROFILE_ZONE("Dashboard::layoutThumbnails");
+    // the number of columns that gives the biggest square cells
+    m_columns = 1;
+    m_cellSize = 0.f;
+    for (unsigned int columns = 1; columns <= std::max(1u, m_numGames); columns++) {
+        unsigned int rows = (m_numGames + columns - 1) / columns;
+        float cellSize = std::min(m_size.x / columns, m_size.y / std::max(1u, rows));
+        if (cellSize > m_cellSize) {
+            m_cellSize = cellSize;
+            m_columns = columns;
+        }
+    }
+    m_thumbnailSize = m_cellSize * THUMBNAIL_FILL;
+
+    const float imageSize = static_cast<float>(BOARD_IMAGE_SIZE);
+    for (unsigned int game = 0; game < m_numGames; game++) {
+        sf::Vertex* quad = &m_thumbnails[game * 4];
+        sf::FloatRect rect((game % m_columns) * m_cellSize, (game / m_columns) * m_cellSize, m_thumbnailSize, m_thumbnailSize);
+        writeQuad(quad, rect, sf::Color::White);
+        quad[0].texCoords = sf::Vector2f(0.f, 0.f);
+        quad[1].texCoords = sf::Vector2f(imageSize, 0.f);
+        quad[2].texCoords = sf::Vector2f(imageSize, imageSize);
+        quad[3].texCoords = sf::Vector2f(0.f, imageSize);
+
+        for (unsigned int tile = 0; tile < m_numTiles; tile++) {
+            writeTile(game, tile);
+        }
+        for (unsigned int player = 0; player < GameState::MAX_PLAYERS; player++) {
+            writeToken(game, player);
+        }
+    }
+}
+
+void Dashboard::setGame(unsigned int index, const GameState& game){
+    if (index >= m_numGames) {
+        return;
+    }
+    ShownGame& shown = m_shownGames[index];
+
+    unsigned int numTiles = std::min(m_numTiles, game.getNumTiles());
+    for (unsigned int tile = 0; tile < numTiles; tile++) {
+        const GameState::TileState& state = game.getTile(tile);
+        if (state.owner != shown.tiles[tile].owner || state.buildingLevel != shown.tiles[tile].buildingLevel) {
+            shown.tiles[tile] = state;
+            writeTile(index, tile);
+        }
+    }
+
+    for (unsigned int player = 0; player < GameState::MAX_PLAYERS; player++) {
+        std::int16_t position = -1;
+        if (player < game.getNumPlayers() && !game.getPlayer(player).bankrupt && game.getPlayer(player).position < numTiles) {
+            position = static_cast<std::int16_t>(game.getPlayer(player).position);
+        }
+        if (position != shown.positions[player]) {
+            shown.positions[player] = position;
+            writeToken(index, player);
+        }
+    }
+}
+
+void Dashboard::writeTile(unsigned int game, unsigned int tile){
+    const GameState::TileState& state = m_shownGames[game].tiles[tile];
+    sf::Vertex* quads = &m_overlay[game * m_quadsPerGame * 4];
+    sf::FloatRect rect = getTileRect(game, tile);
+
+    // the whole tile tinted in the color of its owner
+    if (state.owner >= 0 && static_cast<unsigned int>(state.owner) < GameState::MAX_PLAYERS) {
+        sf::Color color = Player::getSeatColor(state.owner);
+        color.a = OWNER_ALPHA;
+        writeQuad(&quads[tile * 4], rect, color);
+    } else {
+        writeQuad(&quads[tile * 4], sf::FloatRect(), sf::Color::Transparent);
+    }
+
+    // a square in the middle of the tile, bigger with every house, a hotel in red
+    sf::FloatRect building;
+    sf::Color color = HOUSE_COLOR;
+    if (state.buildingLevel > 0) {
+        float side = std::min(rect.width, rect.height);
+        if (state.buildingLevel >= HOTEL_LEVEL) {
+            side *= 0.7f;
+            color = HOTEL_COLOR;
+        } else {
+            side *= 0.25f + 0.1f * state.buildingLevel;
+        }
+        building = sf::FloatRect(rect.left + (rect.width - side) / 2.f, rect.top + (rect.height - side) / 2.f, side, side);
+    }
+    writeQuad(&quads[(m_numTiles + tile) * 4], building, color);
+}
+
+void Dashboard::writeToken(unsigned int game, unsigned int player){
+    std::int16_t position = m_shownGames[game].positions[player];
+    sf::Vertex* quad = &m_overlay[(game * m_quadsPerGame + 2 * m_numTiles + player) * 4];
+    if (position < 0) {
+        writeQuad(quad, sf::FloatRect(), sf::Color::Transparent);
+        return;
+    }
+
+    // the tokens of a tile are spread on a 3x3 grid, so they don't hide each other
+    sf::FloatRect rect = getTileRect(game, static_cast<unsigned int>(position));
+    float side = std::max(2.f, std::min(rect.width, rect.height) * 0.3f);
+    float centerX = rect.left + rect.width * ((player % 3) + 1) / 4.f;
+    float centerY = rect.top + rect.height * ((player / 3) + 1) / 4.f;
+    writeQuad(quad, sf::FloatRect(centerX - side / 2.f, centerY - side / 2.f, side, side), Player::getSeatColor(player));
+}
+
+void Dashboard::writeQuad(sf::Vertex* quad, const sf::FloatRect& rect, const sf::Color& color){
+    quad[0].position = sf::Vector2f(rect.left, rect.top);
+    quad[1].position = sf::Vector2f(rect.left + rect.width, rect.top);
+    quad[2].position = sf::Vector2f(rect.left + rect.width, rect.top + rect.height);
+    quad[3].position = sf::Vector2f(rect.left, rect.top + rect.height);
+    for (int i = 0; i < 4; i++) {
+        quad[i].color = color;
+    }
+}
+
+sf::FloatRect Dashboard::getTileRect(unsigned int game, unsigned int tile) const {
+    const sf::FloatRect& fraction = m_tileRects[tile];
+    float left = (game % m_columns) * m_cellSize;
+    float top = (game / m_columns) * m_cellSize;
+    return sf::FloatRect(left + fraction.left * m_thumbnailSize, top + fraction.top * m_thumbnailSize,
+                         fraction.width * m_thumbnailSize, fraction.height * m_thumbnailSize);
+}
+
+unsigned int Dashboard::getNumGames() const {
+    return m_numGames;
+}
+
+std::size_t Dashboard::getVertexCount() const {
+    return m_thumbnails.getVertexCount() + m_overlay.getVertexCount();
+}
+
+void Dashboard::draw(sf::RenderTarget& target, sf::RenderStates states) const{
+    PROFILE_ZONE("Dashboard::draw");
+    states.texture = &m_boardImage.getTexture();
+    target.draw(m_thumbnails, states);
+    states.texture = nullptr;
+    target.draw(m_overlay, states);
+}
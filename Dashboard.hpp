@@ -0,0 +1,100 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "BoardDefinition.hpp"
+#include "GameState.hpp"
+
+/** @class Dashboard
+ *
+ * @brief Shows many live games at once, as a grid of board thumbnails.
+ *
+ * Drawing a Board per game would draw every tile and text box of every game, thousands of draw calls a frame.
+ * Instead the empty board is drawn once into a texture shared by all the thumbnails, and what changes during a
+ * game (the owners of the tiles, the buildings and the tokens of the players) is drawn over it as plain colored
+ * quads. All the thumbnails go in one vertex array and all the changing quads in another, so a frame is two draw
+ * calls however many games there are.
+ *
+ * Every game has a fixed range of quads in the vertex array, so a change of a game only rewrites its own quads,
+ * and only the quads of the tiles and tokens that changed.
+ */
+class Dashboard : public sf::Drawable {
+public:
+    /** @brief The size of the texture the board is drawn into, it's scaled down (with mipmaps) to the thumbnails. */
+    static constexpr unsigned int BOARD_IMAGE_SIZE = 1024;
+
+    /** @brief Creates the dashboard, with empty boards until the games are set.
+     *
+     * @param size The size of the area the thumbnails are laid out in.
+     * @param numGames The number of games shown.
+     * @param cornersRatio The ratio of the corners of the board to its edges.
+     * @param font The font of the board image.
+     * @param definition The tiles of the board all the games are played on.
+     */
+    Dashboard(const sf::Vector2f& size, unsigned int numGames, float cornersRatio, sf::Font& font,
+              const BoardDefinition& definition = BoardDefinition::standard());
+
+    /** @brief Shows the current state of a game, rewriting only the quads of what changed since it was last set.
+     *
+     * @param index The index of the game, smaller than getNumGames().
+     * @param game The game, played on the board of the dashboard.
+     */
+    void setGame(unsigned int index, const GameState& game);
+
+    /** @brief Lays the thumbnails out in a new area, e.g. after the window was resized. */
+    void resize(const sf::Vector2f& size);
+
+    //* Getters
+    unsigned int getNumGames() const;
+    /** @brief Gets the number of vertices drawn every frame, in both vertex arrays. */
+    std::size_t getVertexCount() const;
+
+private:
+    /** @brief What a game shows, to find what changed since it was last set. */
+    struct ShownGame {
+        std::vector<GameState::TileState> tiles;
+        std::int16_t positions[GameState::MAX_PLAYERS];  ///< The tile of every player, -1 when not on the board.
+    };
+
+    /** @brief Draws the empty board into the shared texture and measures its tiles. */
+    void createBoardImage(float cornersRatio, sf::Font& font, const BoardDefinition& definition);
+
+    /** @brief Computes the grid of the thumbnails and rewrites all the quads. */
+    void layoutThumbnails();
+
+    /** @brief Rewrites the quads of the owner and the building of a tile of a game. */
+    void writeTile(unsigned int game, unsigned int tile);
+
+    /** @brief Rewrites the quad of the token of a player of a game. */
+    void writeToken(unsigned int game, unsigned int player);
+
+    /** @brief Sets the 4 vertices of a quad, an empty rect hides it. */
+    static void writeQuad(sf::Vertex* quad, const sf::FloatRect& rect, const sf::Color& color);
+
+    /** @brief Gets the rect of a tile of a game in the area, from its rect in the board image. */
+    sf::FloatRect getTileRect(unsigned int game, unsigned int tile) const;
+
+    /** @brief Draws the thumbnails and the games over them.
+     *
+     * this functions is of the sf::Drawable interface.
+     */
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    //* MEMBERS
+    sf::Vector2f m_size;
+    unsigned int m_numGames;
+    unsigned int m_numTiles;
+    unsigned int m_quadsPerGame;              ///< The owners and buildings of the tiles, then the tokens.
+
+    sf::RenderTexture m_boardImage;           ///< The empty board, shared by all the thumbnails.
+    std::vector<sf::FloatRect> m_tileRects;   ///< The rects of the tiles, as fractions of the board.
+
+    unsigned int m_columns;                   ///< The grid of the thumbnails.
+    float m_cellSize;
+    float m_thumbnailSize;
+
+    sf::VertexArray m_thumbnails;             ///< A textured quad per game.
+    sf::VertexArray m_overlay;                ///< m_quadsPerGame quads per game.
+    std::vector<ShownGame> m_shownGames;
+};
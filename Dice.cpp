@@ -0,0 +1,31 @@
+#include "Dice.hpp"
+
+Dice::Dice(std::uint64_t seed)
+    : m_seed(seed), m_state(seed)
+{
+}
+
+unsigned int Dice::roll()
+{
+    return nextBelow(6) + 1;
+}
+
+std::uint64_t Dice::next()
+{
+    // SplitMix64: advance the state by the golden gamma and mix it
+    std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::uint32_t Dice::nextBelow(std::uint32_t bound)
+{
+    // Lemire's multiply-shift reduction, the bias is negligible for the small bounds we use
+    return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+}
+
+std::uint64_t Dice::getSeed() const
+{
+    return m_seed;
+}
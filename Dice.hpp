@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+/** @class Dice
+ *
+ * @brief A pair of six sided dice driven by a deterministic random stream.
+ *
+ * The stream is a SplitMix64 generator, so its whole state is the seed and the number of
+ * values drawn so far. Two Dice with the same seed always roll the same sequence.
+ */
+class Dice {
+public:
+    /** @brief Constructs the dice with the given seed.
+     *
+     * @param seed The seed of the random stream.
+     */
+    explicit Dice(std::uint64_t seed = 0);
+
+    /** @brief Rolls a single die.
+     *
+     * @return A value between 1 and 6.
+     */
+    unsigned int roll();
+
+    /** @brief Draws the next raw 64 bit value of the random stream. */
+    std::uint64_t next();
+
+    /** @brief Draws a uniform value in [0, bound).
+     *
+     * @param bound The exclusive upper bound, must be greater than 0.
+     */
+    std::uint32_t nextBelow(std::uint32_t bound);
+
+    /** @brief Gets the seed of the random stream. */
+    std::uint64_t getSeed() const;
+
+private:
+    //* MEMBERS
+    std::uint64_t m_seed;  ///< The seed the stream started from.
+    std::uint64_t m_state; ///< The current SplitMix64 state.
+};
@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "GameServer.hpp"
+#include "Simulation.hpp"
+
+namespace {
+    // an epoll tag that can't be a socket fd
+    constexpr std::uint64_t WAKE_TAG = ~0ull;
+
+    void setNonBlocking(int fd){
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+}
+
+GameServer::GameServer(const Config& config)
+    : m_config(config),
+      m_epollFd(-1),
+      m_wakeFd(-1),
+      m_unixListenFd(-1),
+      m_tcpListenFd(-1),
+      m_nextShard(0),
+      m_running(false)
+{
+    if (m_config.shardCount == 0) {
+        m_config.shardCount = 1;
+    }
+    if (m_config.unixPath.empty() && m_config.tcpPort == 0) {
+        throw std::runtime_error("GameServer: neither a Unix socket nor a TCP port was configured");
+    }
+
+    // the destructor doesn't run when the constructor throws, so the fds opened so far are closed here
+    try {
+        m_epollFd = epoll_create1(0);
+        m_wakeFd = eventfd(0, EFD_NONBLOCK);
+        if (m_epollFd < 0 || m_wakeFd < 0) {
+            throw std::runtime_error("GameServer: failed to create the event loop");
+        }
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.u64 = WAKE_TAG;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wakeEvent);
+
+        if (!m_config.unixPath.empty()) {
+            m_unixListenFd = listenUnix(m_config.unixPath);
+        }
+        if (m_config.tcpPort != 0) {
+            m_tcpListenFd = listenTcp(m_config.tcpPort);
+        }
+    } catch (...) {
+        closeFds();
+        throw;
+    }
+
+    for (unsigned int i = 0; i < m_config.shardCount; i++) {
+        m_shards.push_back(std::make_unique<Shard>());
+        m_shards.back()->index = i;
+    }
+}
+
+GameServer::~GameServer(){
+    stop();
+    for (auto& shard : m_shards) {
+        if (shard->thread.joinable()) {
+            shard->wakeUp.notify_all();
+            shard->thread.join();
+        }
+    }
+    for (auto& entry : m_connections) {
+        entry.second->close();
+    }
+    closeFds();
+}
+
+void GameServer::closeFds(){
+    if (m_unixListenFd >= 0) {
+        close(m_unixListenFd);
+        unlink(m_config.unixPath.c_str());
+        m_unixListenFd = -1;
+    }
+    if (m_tcpListenFd >= 0) {
+        close(m_tcpListenFd);
+        m_tcpListenFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    if (m_epollFd >= 0) {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+int GameServer::listenUnix(const std::string& path){
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("GameServer: Unix socket path is too long");
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("GameServer: failed to create a socket for " + path + ": " + std::strerror(errno));
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        int error = errno;
+        close(fd);
+        throw std::runtime_error("GameServer: failed to listen on " + path + ": " + std::strerror(error));
+    }
+    setNonBlocking(fd);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    return fd;
+}
+
+int GameServer::listenTcp(std::uint16_t port){
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("GameServer: failed to create a socket for port " + std::to_string(port) + ": " + std::strerror(errno));
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        int error = errno;
+        close(fd);
+        throw std::runtime_error("GameServer: failed to listen on port " + std::to_string(port) + ": " + std::strerror(error));
+    }
+    setNonBlocking(fd);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    return fd;
+}
+
+void GameServer::run(){
+    m_running = true;
+    for (auto& shard : m_shards) {
+        Shard* shardPtr = shard.get();
+        shard->thread = std::thread([this, shardPtr]{ shardLoop(*shardPtr); });
+    }
+
+    std::vector<epoll_event> events(256);
+    while (m_running) {
+        int count = epoll_wait(m_epollFd, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            const epoll_event& event = events[i];
+            if (event.data.u64 == WAKE_TAG) {
+                std::uint64_t value;
+                while (read(m_wakeFd, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+            int fd = event.data.fd;
+            if (fd == m_unixListenFd || fd == m_tcpListenFd) {
+                acceptClients(fd);
+                continue;
+            }
+            auto found = m_connections.find(fd);
+            if (found == m_connections.end()) {
+                continue;
+            }
+            std::shared_ptr<Connection> connection = found->second;
+            if (event.events & (EPOLLERR | EPOLLHUP)) {
+                closeClient(connection);
+                continue;
+            }
+            if (event.events & EPOLLOUT) {
+                connection->onWritable();
+            }
+            if (event.events & EPOLLIN) {
+                readClient(connection);
+            }
+        }
+    }
+
+    // stop the shards
+    m_running = false;
+    for (auto& shard : m_shards) {
+        shard->wakeUp.notify_all();
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+void GameServer::stop(){
+    m_running = false;
+    std::uint64_t one = 1;
+    // write() is async-signal-safe, so stop() can be called from a signal handler
+    [[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+}
+
+unsigned int GameServer::getShardCount() const {
+    return static_cast<unsigned int>(m_shards.size());
+}
+
+const GameServer::ShardStats& GameServer::getShardStats(unsigned int shard) const {
+    return m_shards.at(shard)->stats;
+}
+
+void GameServer::acceptClients(int listenFd){
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        setNonBlocking(fd);
+        if (listenFd == m_tcpListenFd) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        m_connections[fd] = std::make_shared<Connection>(fd, m_epollFd);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void GameServer::readClient(const std::shared_ptr<Connection>& connection){
+    // the events routed to each shard by this read, pushed at once to take each queue lock only once
+    std::vector<std::vector<Event>> routed(m_shards.size());
+    std::uint8_t buffer[64 * 1024];
+    bool closed = false;
+    Protocol::FrameDecoder& decoder = connection->getDecoder();
+
+    while (true) {
+        ssize_t received = read(connection->getFd(), buffer, sizeof(buffer));
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+            closed = true;
+            break;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        decoder.feed(buffer, static_cast<std::size_t>(received));
+
+        Protocol::MessageType type;
+        const std::uint8_t* payload;
+        std::size_t payloadSize;
+        while (decoder.next(type, payload, payloadSize)) {
+            Protocol::Reader reader(payload, payloadSize);
+            Event event{};
+            event.connection = connection;
+
+            switch (type) {
+                case Protocol::MessageType::Hello: {
+                    Protocol::Hello hello;
+                    if (!Protocol::decode(reader, hello)) {
+                        closed = true;
+                        break;
+                    }
+                    auto reply = std::make_shared<Connection::Buffer>();
+                    Protocol::encode(*reply, Protocol::Welcome{ Protocol::VERSION, static_cast<std::uint16_t>(m_shards.size()) });
+                    Connection::SharedBuffer shared = reply;
+                    connection->send(&shared, 1);
+                    continue;
+                }
+                case Protocol::MessageType::CreateGame:
+                    if (!Protocol::decode(reader, event.createGame)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::CreateGame;
+                    routed[m_nextShard].push_back(std::move(event));
+                    m_nextShard = (m_nextShard + 1) % m_shards.size();
+                    continue;
+                case Protocol::MessageType::Action:
+                    if (!Protocol::decode(reader, event.action)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::Action;
+                    routed[event.action.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::TileAction:
+                    if (!Protocol::decode(reader, event.tileAction)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::TileAction;
+                    routed[event.tileAction.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::Trade:
+                    if (!Protocol::decode(reader, event.trade)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::Trade;
+                    routed[event.trade.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::BotAction:
+                    if (!Protocol::decode(reader, event.botAction)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::BotAction;
+                    routed[event.botAction.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::CloseGame:
+                    if (!Protocol::decode(reader, event.closeGame)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::CloseGame;
+                    routed[event.closeGame.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::Spectate:
+                    if (!Protocol::decode(reader, event.spectate)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::Spectate;
+                    routed[event.spectate.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                case Protocol::MessageType::AckKeyframe:
+                    if (!Protocol::decode(reader, event.ackKeyframe)) {
+                        closed = true;
+                        break;
+                    }
+                    event.kind = Event::Kind::AckKeyframe;
+                    routed[event.ackKeyframe.gameId % m_shards.size()].push_back(std::move(event));
+                    continue;
+                default:
+                    // unknown or server side message: the client does not speak our protocol
+                    closed = true;
+                    break;
+            }
+            break;
+        }
+        if (closed) {
+            break;
+        }
+    }
+
+    for (unsigned int i = 0; i < m_shards.size(); i++) {
+        if (!routed[i].empty()) {
+            pushEvents(*m_shards[i], routed[i]);
+        }
+    }
+    if (closed) {
+        closeClient(connection);
+    }
+}
+
+void GameServer::closeClient(const std::shared_ptr<Connection>& connection){
+    if (connection->isClosed()) {
+        return;
+    }
+    m_connections.erase(connection->getFd());
+    connection->close();
+
+    // every shard may host games (or spectators) of the client
+    for (auto& shard : m_shards) {
+        std::vector<Event> events(1);
+        events[0].kind = Event::Kind::ConnectionClosed;
+        events[0].connection = connection;
+        pushEvents(*shard, events);
+    }
+}
+
+void GameServer::pushEvents(Shard& shard, std::vector<Event>& events){
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.queue.empty()) {
+            shard.queue.swap(events);
+        } else {
+            for (auto& event : events) {
+                shard.queue.push_back(std::move(event));
+            }
+        }
+    }
+    shard.wakeUp.notify_one();
+}
+
+void GameServer::shardLoop(Shard& shard){
+    std::vector<Event> batch;
+    // everything sent while handling a batch, so each client gets a single write
+    SendBatch sends;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.wakeUp.wait(lock, [&]{ return !shard.queue.empty() || !m_running; });
+            if (shard.queue.empty() && !m_running) {
+                return;
+            }
+            batch.swap(shard.queue);
+        }
+
+        for (const Event& event : batch) {
+            handleEvent(shard, event, sends);
+        }
+        batch.clear();
+        sends.flush();
+    }
+}
+
+void GameServer::handleEvent(Shard& shard, const Event& event, SendBatch& batch){
+    switch (event.kind) {
+        case Event::Kind::CreateGame: {
+            std::uint32_t numPlayers = event.createGame.numPlayers;
+            if (numPlayers < 2 || numPlayers > GameState::MAX_PLAYERS) {
+                numPlayers = 4;
+            }
+            // the game id encodes its shard, so the network thread can route without a lookup
+            std::uint32_t gameId = shard.nextLocalId++ * static_cast<std::uint32_t>(m_shards.size()) + shard.index;
+            shard.games.emplace(gameId, HostedGame{ GameState(numPlayers, event.createGame.seed), event.connection.get(), nullptr });
+            shard.stats.games = static_cast<std::uint32_t>(shard.games.size());
+            Protocol::encode(batch.replyBuffer(event.connection), Protocol::GameCreated{ event.createGame.requestId, gameId });
+            break;
+        }
+        case Event::Kind::Action:
+        case Event::Kind::TileAction:
+        case Event::Kind::Trade:
+        case Event::Kind::BotAction:
+            handleAction(shard, event, batch);
+            break;
+        case Event::Kind::CloseGame: {
+            auto found = shard.games.find(event.closeGame.gameId);
+            if (found != shard.games.end() && found->second.owner == event.connection.get()) {
+                closeGame(shard, found, batch);
+            }
+            Protocol::encode(batch.replyBuffer(event.connection), Protocol::GameClosed{ event.closeGame.requestId, event.closeGame.gameId });
+            break;
+        }
+        case Event::Kind::Spectate: {
+            auto found = shard.games.find(event.spectate.gameId);
+            if (found == shard.games.end()) {
+                Protocol::encode(batch.replyBuffer(event.connection), Protocol::GameClosed{ event.spectate.requestId, event.spectate.gameId });
+                break;
+            }
+            HostedGame& hosted = found->second;
+            if (!hosted.feed) {
+                hosted.feed = std::make_unique<SpectatorFeed>(event.spectate.gameId);
+            }
+            std::uint64_t before = hosted.feed->getBroadcastBytes();
+            hosted.feed->addSpectator(event.connection, hosted.state, batch);
+            shard.stats.broadcastBytes.fetch_add(hosted.feed->getBroadcastBytes() - before, std::memory_order_relaxed);
+            shard.stats.spectators.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        case Event::Kind::AckKeyframe: {
+            auto found = shard.games.find(event.ackKeyframe.gameId);
+            if (found != shard.games.end() && found->second.feed) {
+                found->second.feed->acknowledge(event.connection.get(), event.ackKeyframe.keyframeId);
+            }
+            break;
+        }
+        case Event::Kind::ConnectionClosed: {
+            for (auto it = shard.games.begin(); it != shard.games.end();) {
+                auto current = it++;
+                if (current->second.owner == event.connection.get()) {
+                    closeGame(shard, current, batch);
+                } else if (current->second.feed) {
+                    std::size_t before = current->second.feed->getSpectatorCount();
+                    current->second.feed->removeSpectator(event.connection.get());
+                    shard.stats.spectators.fetch_sub(static_cast<std::uint32_t>(before - current->second.feed->getSpectatorCount()),
+                                                     std::memory_order_relaxed);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void GameServer::handleAction(Shard& shard, const Event& event, SendBatch& batch){
+    static_assert(Protocol::MAX_TRADE_TILES == GameState::TradeOffer::MAX_TILES, "a Trade carries a whole TradeOffer");
+
+    // the kinds of action share their header and their reply
+    Protocol::ActionResult result{};
+    unsigned int player;
+    switch (event.kind) {
+        case Event::Kind::TileAction:
+            result.requestId = event.tileAction.requestId;
+            result.gameId = event.tileAction.gameId;
+            player = event.tileAction.player;
+            break;
+        case Event::Kind::Trade:
+            result.requestId = event.trade.requestId;
+            result.gameId = event.trade.gameId;
+            player = event.trade.player;
+            break;
+        case Event::Kind::BotAction:
+            result.requestId = event.botAction.requestId;
+            result.gameId = event.botAction.gameId;
+            player = event.botAction.player;
+            break;
+        default:
+            result.requestId = event.action.requestId;
+            result.gameId = event.action.gameId;
+            player = event.action.player;
+            break;
+    }
+
+    auto found = shard.games.find(result.gameId);
+    if (found == shard.games.end() || found->second.owner != event.connection.get()) {
+        result.status = Protocol::STATUS_UNKNOWN_GAME;
+        Protocol::encode(batch.replyBuffer(event.connection), result);
+        return;
+    }
+    HostedGame& hosted = found->second;
+    GameState& game = hosted.state;
+    GameState::Status status = GameState::Status::IllegalAction;
+    switch (event.kind) {
+        case Event::Kind::TileAction: {
+            unsigned int tile = event.tileAction.tile;
+            switch (static_cast<Protocol::TileActionKind>(event.tileAction.action)) {
+                case Protocol::TileActionKind::Build:
+                    status = game.build(player, tile);
+                    break;
+                case Protocol::TileActionKind::SellBuilding:
+                    status = game.sellBuilding(player, tile);
+                    break;
+                case Protocol::TileActionKind::Mortgage:
+                    status = game.mortgage(player, tile);
+                    break;
+                case Protocol::TileActionKind::Redeem:
+                    status = game.redeem(player, tile);
+                    break;
+            }
+            break;
+        }
+        case Event::Kind::Trade: {
+            const Protocol::Trade& trade = event.trade;
+            GameState::TradeOffer offer{};
+            offer.partner = trade.partner;
+            offer.numGiven = trade.numGiven;
+            offer.numTaken = trade.numTaken;
+            std::copy(trade.given, trade.given + trade.numGiven, offer.given);
+            std::copy(trade.taken, trade.taken + trade.numTaken, offer.taken);
+            offer.cash = trade.cash;
+            status = game.trade(player, offer);
+            break;
+        }
+        case Event::Kind::BotAction:
+            // the bot plays for the current player, so it is refused like any other action out of turn
+            if (game.getPhase() == GameState::Phase::GameOver) {
+                status = GameState::Status::GameOver;
+            } else if (player != game.getCurrentPlayer()) {
+                status = GameState::Status::NotYourTurn;
+            } else {
+                status = Simulation::applyBotAction(game);
+            }
+            break;
+        default:
+            status = game.apply(player, static_cast<GameState::Action>(event.action.action));
+            break;
+    }
+    result.status = static_cast<std::uint8_t>(status);
+    result.phase = static_cast<std::uint8_t>(game.getPhase());
+    result.currentPlayer = static_cast<std::uint8_t>(game.getCurrentPlayer());
+    result.die1 = static_cast<std::uint8_t>(game.getLastDie1());
+    result.die2 = static_cast<std::uint8_t>(game.getLastDie2());
+    if (player < game.getNumPlayers()) {
+        result.position = static_cast<std::uint8_t>(game.getPlayer(player).position);
+        result.money = game.getPlayer(player).money;
+    }
+    shard.stats.actions.fetch_add(1, std::memory_order_relaxed);
+    Protocol::encode(batch.replyBuffer(event.connection), result);
+
+    if (hosted.feed && status == GameState::Status::Ok) {
+        std::uint64_t before = hosted.feed->getBroadcastBytes();
+        hosted.feed->publish(game, batch);
+        shard.stats.broadcastBytes.fetch_add(hosted.feed->getBroadcastBytes() - before, std::memory_order_relaxed);
+    }
+}
+
+void GameServer::closeGame(Shard& shard, std::unordered_map<std::uint32_t, HostedGame>::iterator game, SendBatch& batch){
+    if (game->second.feed) {
+        shard.stats.spectators.fetch_sub(static_cast<std::uint32_t>(game->second.feed->getSpectatorCount()), std::memory_order_relaxed);
+        game->second.feed->close(batch);
+    }
+    shard.games.erase(game);
+    shard.stats.games = static_cast<std::uint32_t>(shard.games.size());
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Connection.hpp"
+#include "GameState.hpp"
+#include "Protocol.hpp"
+#include "SpectatorFeed.hpp"
+
+/** @class GameServer
+ *
+ * @brief Hosts many independent headless games in one process.
+ *
+ * The games are sharded across a fixed number of threads, each shard owns its games and an event queue,
+ * so a game is only ever touched by its own shard and needs no locking.
+ * One network thread (the one calling run()) accepts clients on a Unix socket and/or a loopback TCP port,
+ * decodes their frames (see Protocol) and routes each request to the shard owning the game.
+ * Shards write their replies straight to the client sockets.
+ * Clients may also spectate any game, getting its changes as deltas (see SpectatorFeed).
+ */
+class GameServer {
+public:
+    /** @brief The configuration of the server. */
+    struct Config {
+        unsigned int shardCount = 1;   ///< The number of threads running games.
+        std::string unixPath;          ///< Path of the Unix socket to listen on, empty to disable.
+        std::uint16_t tcpPort = 0;     ///< Loopback TCP port to listen on, 0 to disable.
+    };
+
+    /** @brief Counters of one shard, readable while the server runs. */
+    struct ShardStats {
+        std::atomic<std::uint64_t> actions{0}; ///< The number of actions applied.
+        std::atomic<std::uint32_t> games{0};   ///< The number of games currently hosted.
+        std::atomic<std::uint32_t> spectators{0};      ///< The number of spectators watching.
+        std::atomic<std::uint64_t> broadcastBytes{0};  ///< The bytes queued for spectators.
+    };
+
+    /** @brief Creates the server and opens its listening sockets.
+     *
+     * @param config The configuration of the server.
+     * @throws std::runtime_error if a listening socket can't be opened.
+     */
+    explicit GameServer(const Config& config);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    /** @brief Runs the shards and the network loop until stop() is called. */
+    void run();
+
+    /** @brief Asks run() to return. Safe to call from another thread or a signal handler. */
+    void stop();
+
+    /** @brief Gets the number of shards. */
+    unsigned int getShardCount() const;
+
+    /** @brief Gets the counters of a shard. */
+    const ShardStats& getShardStats(unsigned int shard) const;
+
+private:
+    /** @brief A request routed to a shard. */
+    struct Event {
+        enum class Kind : std::uint8_t { CreateGame, Action, TileAction, Trade, BotAction, CloseGame, Spectate, AckKeyframe, ConnectionClosed };
+
+        Kind kind;
+        std::shared_ptr<Connection> connection;
+        Protocol::CreateGame createGame;
+        Protocol::Action action;
+        Protocol::TileAction tileAction;
+        Protocol::Trade trade;
+        Protocol::BotAction botAction;
+        Protocol::CloseGame closeGame;
+        Protocol::Spectate spectate;
+        Protocol::AckKeyframe ackKeyframe;
+    };
+
+    /** @brief A game, the connection that created it and its spectators (created on the first one). */
+    struct HostedGame {
+        GameState state;
+        const Connection* owner;
+        std::unique_ptr<SpectatorFeed> feed;
+    };
+
+    /** @brief A thread running a subset of the games. */
+    struct Shard {
+        unsigned int index = 0;
+        std::thread thread;
+        std::mutex mutex;                      ///< Guards queue.
+        std::condition_variable wakeUp;        ///< Signaled when events are queued.
+        std::vector<Event> queue;              ///< The events waiting for the shard.
+        std::unordered_map<std::uint32_t, HostedGame> games; ///< Only used by the shard's thread.
+        std::uint32_t nextLocalId = 0;         ///< Only used by the shard's thread.
+        ShardStats stats;
+    };
+
+    /** @brief The loop of a shard: waits for events and applies them in batches. */
+    void shardLoop(Shard& shard);
+
+    /** @brief Applies one event, queueing the reply and the spectator frames in the batch. */
+    void handleEvent(Shard& shard, const Event& event, SendBatch& batch);
+
+    /** @brief Applies an Action, TileAction, Trade or BotAction event to its game and queues the ActionResult. */
+    void handleAction(Shard& shard, const Event& event, SendBatch& batch);
+
+    /** @brief Drops a game, telling its spectators. */
+    void closeGame(Shard& shard, std::unordered_map<std::uint32_t, HostedGame>::iterator game, SendBatch& batch);
+
+    /** @brief Queues a batch of events for a shard. */
+    void pushEvents(Shard& shard, std::vector<Event>& events);
+
+    /** @brief Opens a listening socket, returns its fd.
+     *
+     * @throws std::runtime_error if it can't be opened, with no fd left open.
+     */
+    int listenUnix(const std::string& path);
+    int listenTcp(std::uint16_t port);
+
+    /** @brief Closes the listening sockets and the event loop fds that are open. */
+    void closeFds();
+
+    /** @brief Accepts all pending clients of a listening socket. */
+    void acceptClients(int listenFd);
+
+    /** @brief Reads from a client and routes its complete frames. */
+    void readClient(const std::shared_ptr<Connection>& connection);
+
+    /** @brief Closes a client and tells the shards to drop its games. */
+    void closeClient(const std::shared_ptr<Connection>& connection);
+
+    //* MEMBERS
+    Config m_config;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::unordered_map<int, std::shared_ptr<Connection>> m_connections; ///< Only used by the network thread.
+    int m_epollFd;
+    int m_wakeFd;                  ///< eventfd used by stop() to wake the network loop.
+    int m_unixListenFd;
+    int m_tcpListenFd;
+    unsigned int m_nextShard;      ///< Round robin shard for the next created game.
+    std::atomic<bool> m_running;
+};
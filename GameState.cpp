@@ -0,0 +1,707 @@
+#include <algorithm>
+#include <stdexcept>
+#include "GameState.hpp"
+#include "LiquidationPlanner.hpp"
+
+GameState::GameState(unsigned int numPlayers, std::uint64_t seed, const BoardDefinition& board)
+    : m_board(&board),
+      m_tiles(board.getNumTiles(), TileState{ -1, 0, false }),
+      m_dice(seed),
+      m_buildings(board, checkedNumPlayers(numPlayers)),
+      m_lastAuction{ -1, 0 },
+      m_auctionCount(0),
+      m_auctionKind(AuctionEngine::Kind::Ascending),
+      m_lastCard(nullptr),
+      m_counters(nullptr),
+      m_phase(Phase::RollDice),
+      m_currentPlayerIndex(0),
+      m_doublesCount(0),
+      m_lastDie1(0),
+      m_lastDie2(0),
+      m_turnCount(0),
+      m_activePlayers(numPlayers)
+{
+    m_players.assign(numPlayers, PlayerState{ STARTING_MONEY, 0, false, 0, false, { 0, 0 }, 0 });
+    for (unsigned int deck = 0; deck < BoardDefinition::NUM_DECKS; deck++) {
+        m_decks[deck].reset(static_cast<unsigned int>(board.getCards(static_cast<DeckKind>(deck)).size()), m_dice);
+    }
+}
+
+unsigned int GameState::checkedNumPlayers(unsigned int numPlayers){
+    if (numPlayers < 2 || numPlayers > MAX_PLAYERS) {
+        throw std::invalid_argument("GameState: the number of players must be between 2 and MAX_PLAYERS");
+    }
+    return numPlayers;
+}
+
+GameState::Status GameState::apply(unsigned int player, Action action){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+
+    switch (m_phase) {
+        // the player can only roll the dice
+        case Phase::RollDice:
+            if (action != Action::RollDice) {
+                return Status::IllegalAction;
+            }
+            rollDice();
+            return Status::Ok;
+
+        // the player landed on an unowned street: buttons are "Buy" and "Do Not Buy" (which auctions it)
+        case Phase::BuyMenu: {
+            if (action == Action::DoNotBuy) {
+                auctionTile(m_players[m_currentPlayerIndex].position);
+                setPreEndTurnPhase();
+                return Status::Ok;
+            }
+            if (action != Action::Buy) {
+                return Status::IllegalAction;
+            }
+            PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+            const TileDefinition& definition = m_board->getTile(currPlayer.position);
+            if (currPlayer.money < definition.price) {
+                return Status::NotEnoughMoney;
+            }
+            currPlayer.money -= definition.price;
+            m_tiles[currPlayer.position].owner = static_cast<std::int8_t>(m_currentPlayerIndex);
+            m_buildings.setOwner(currPlayer.position, -1, static_cast<int>(m_currentPlayerIndex));
+            setPreEndTurnPhase();
+            return Status::Ok;
+        }
+
+        // the player's turn has ended: button is "End Turn"
+        case Phase::EndTurn:
+            if (action != Action::EndTurn) {
+                return Status::IllegalAction;
+            }
+            advanceToNextPlayer();
+            return Status::Ok;
+
+        default:
+            return Status::IllegalAction;
+    }
+}
+
+GameState::Status GameState::build(unsigned int player, unsigned int tile){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+    if (!canManageBuildings(player) || !m_buildings.canBuild(player, tile)) {
+        return Status::IllegalAction;
+    }
+    unsigned int price = m_board->getTile(tile).housePrice;
+    if (m_players[player].money < price) {
+        return Status::NotEnoughMoney;
+    }
+    m_players[player].money -= price;
+    m_tiles[tile].buildingLevel = static_cast<std::uint8_t>(m_buildings.build(tile));
+    return Status::Ok;
+}
+
+GameState::Status GameState::sellBuilding(unsigned int player, unsigned int tile){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+    if (!canManageBuildings(player) || !m_buildings.canSell(player, tile)) {
+        return Status::IllegalAction;
+    }
+    m_players[player].money += m_board->getTile(tile).housePrice / 2;
+    m_tiles[tile].buildingLevel = static_cast<std::uint8_t>(m_buildings.sell(tile));
+    return Status::Ok;
+}
+
+GameState::Status GameState::mortgage(unsigned int player, unsigned int tile){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+    if (!canManageBuildings(player) || tile >= m_tiles.size() || m_tiles[tile].owner != static_cast<int>(player)
+        || m_tiles[tile].mortgaged || m_buildings.hasBuildings(m_board->getTile(tile).group)) {
+        return Status::IllegalAction;
+    }
+    mortgageTile(tile);
+    return Status::Ok;
+}
+
+GameState::Status GameState::redeem(unsigned int player, unsigned int tile){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+    if (!canManageBuildings(player) || tile >= m_tiles.size() || m_tiles[tile].owner != static_cast<int>(player)
+        || !m_tiles[tile].mortgaged) {
+        return Status::IllegalAction;
+    }
+    unsigned int cost = getRedeemCost(m_board->getTile(tile));
+    if (m_players[player].money < cost) {
+        return Status::NotEnoughMoney;
+    }
+    m_players[player].money -= cost;
+    m_players[player].mortgagedTiles--;
+    m_tiles[tile].mortgaged = false;
+    m_buildings.setMortgaged(tile, false);
+    return Status::Ok;
+}
+
+GameState::Status GameState::trade(unsigned int player, const TradeOffer& offer){
+    if (m_phase == Phase::GameOver) {
+        return Status::GameOver;
+    }
+    if (player != m_currentPlayerIndex) {
+        return Status::NotYourTurn;
+    }
+    unsigned int partner = offer.partner;
+    if (!canManageBuildings(player) || partner >= m_players.size() || partner == player || m_players[partner].bankrupt
+        || offer.numGiven > TradeOffer::MAX_TILES || offer.numTaken > TradeOffer::MAX_TILES) {
+        return Status::IllegalAction;
+    }
+    for (unsigned int i = 0; i < offer.numGiven; i++) {
+        if (!canTradeTile(offer.given[i], player) || std::count(offer.given, offer.given + i, offer.given[i]) > 0) {
+            return Status::IllegalAction;
+        }
+    }
+    for (unsigned int i = 0; i < offer.numTaken; i++) {
+        if (!canTradeTile(offer.taken[i], partner) || std::count(offer.taken, offer.taken + i, offer.taken[i]) > 0) {
+            return Status::IllegalAction;
+        }
+    }
+    unsigned int cash = static_cast<unsigned int>(offer.cash < 0 ? -static_cast<std::int64_t>(offer.cash) : offer.cash);
+    if (m_players[offer.cash < 0 ? partner : player].money < cash) {
+        return Status::NotEnoughMoney;
+    }
+
+    for (unsigned int i = 0; i < offer.numGiven; i++) {
+        transferTile(offer.given[i], partner);
+    }
+    for (unsigned int i = 0; i < offer.numTaken; i++) {
+        transferTile(offer.taken[i], player);
+    }
+    if (offer.cash < 0) {
+        m_players[partner].money -= cash;
+        m_players[player].money += cash;
+    } else {
+        m_players[player].money -= cash;
+        m_players[partner].money += cash;
+    }
+    return Status::Ok;
+}
+
+void GameState::setCounters(Counters* counters){
+    m_counters = counters;
+}
+
+void GameState::setAuctionKind(AuctionEngine::Kind kind){
+    m_auctionKind = kind;
+}
+
+unsigned int GameState::calcRent(const TileDefinition& definition, const TileState& tile){
+    if (tile.mortgaged) {
+        return 0;
+    }
+    return tile.buildingLevel < 6 ? definition.rents[tile.buildingLevel] : 0;
+}
+
+unsigned int GameState::getMortgageValue(const TileDefinition& definition){
+    return definition.price / 2;
+}
+
+unsigned int GameState::getRedeemCost(const TileDefinition& definition){
+    unsigned int value = getMortgageValue(definition);
+    return value + (value * MORTGAGE_INTEREST_PERCENT + 99) / 100;
+}
+
+void GameState::rollDice(){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    m_lastDie1 = m_dice.roll();
+    m_lastDie2 = m_dice.roll();
+    bool isDouble = (m_lastDie1 == m_lastDie2);
+
+    // a held "get out of jail free" card is used right away, and the roll counts as a normal one
+    if (currPlayer.inJail && returnJailFreeCard(m_currentPlayerIndex)) {
+        currPlayer.inJail = false;
+        currPlayer.jailTurns = 0;
+    }
+
+    // a player in jail leaves it by rolling a double, or by paying the fine on the third try
+    if (currPlayer.inJail) {
+        if (!isDouble && ++currPlayer.jailTurns < 3) {
+            m_phase = Phase::EndTurn;
+            return;
+        }
+        if (!isDouble) {
+            pay(m_currentPlayerIndex, JAIL_FINE, -1);
+            if (currPlayer.bankrupt) {
+                return;
+            }
+        }
+        currPlayer.inJail = false;
+        currPlayer.jailTurns = 0;
+        // leaving the jail does not grant another roll
+        m_doublesCount = 0;
+        moveCurrentPlayer(m_lastDie1 + m_lastDie2);
+        landOnTile();
+        return;
+    }
+
+    // if the player rolled 3 doubles - move them to jail
+    m_doublesCount = isDouble ? m_doublesCount + 1 : 0;
+    if (m_doublesCount == 3) {
+        sendToJail();
+        return;
+    }
+
+    moveCurrentPlayer(m_lastDie1 + m_lastDie2);
+    landOnTile();
+}
+
+void GameState::moveCurrentPlayer(unsigned int steps){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    unsigned int newPosition = currPlayer.position + steps;
+    // passing (or landing on) Go pays the salary
+    if (newPosition >= m_tiles.size()) {
+        newPosition %= m_tiles.size();
+        currPlayer.money += GO_SALARY;
+    }
+    currPlayer.position = newPosition;
+}
+
+void GameState::landOnTile(){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    const TileState& currTile = m_tiles[currPlayer.position];
+    const TileDefinition& definition = m_board->getTile(currPlayer.position);
+    countLanding(currPlayer.position);
+
+    switch (definition.kind) {
+        case TileKind::GoToJail:
+            sendToJail();
+            return;
+        case TileKind::Street:
+            // if the street is unowned, enable the player to buy it
+            if (currTile.owner < 0) {
+                m_phase = Phase::BuyMenu;
+                return;
+            }
+            // if the street is owned by another player, pay the rent
+            if (currTile.owner != static_cast<int>(m_currentPlayerIndex)) {
+                unsigned int rent = calcRent(definition, currTile);
+                int owner = currTile.owner;
+                pay(m_currentPlayerIndex, rent, owner);
+                if (m_counters) {
+                    m_counters->rentCollected[owner] += currPlayer.bankrupt ? 0 : rent;
+                }
+                if (currPlayer.bankrupt) {
+                    return;
+                }
+            }
+            break;
+        case TileKind::Chance:
+            drawCard(DeckKind::Chance);
+            return;
+        case TileKind::CommunityChest:
+            drawCard(DeckKind::CommunityChest);
+            return;
+        default:
+            break;
+    }
+    setPreEndTurnPhase();
+}
+
+void GameState::countLanding(unsigned int tile){
+    if (m_counters && tile < m_counters->landings.size()) {
+        m_counters->landings[tile]++;
+    }
+}
+
+void GameState::drawCard(DeckKind deck){
+    unsigned int index = m_decks[static_cast<unsigned int>(deck)].draw(m_dice);
+    if (index == CardDeck::NO_CARD) {
+        setPreEndTurnPhase();
+        return;
+    }
+    m_lastCard = &m_board->getCards(deck)[index];
+    runCard(*m_lastCard, deck, index);
+}
+
+void GameState::runCard(const Card& card, DeckKind deck, unsigned int index){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    unsigned int numTiles = static_cast<unsigned int>(m_tiles.size());
+    unsigned int amount = card.value > 0 ? static_cast<unsigned int>(card.value) : 0;
+
+    switch (card.op) {
+        case CardOp::Collect:
+            currPlayer.money += amount;
+            break;
+        case CardOp::Pay:
+            pay(m_currentPlayerIndex, amount, -1);
+            if (currPlayer.bankrupt) {
+                return;
+            }
+            break;
+        case CardOp::CollectFromEach:
+            for (unsigned int i = 0; i < m_players.size(); i++) {
+                if (i != m_currentPlayerIndex && !m_players[i].bankrupt) {
+                    pay(i, amount, static_cast<int>(m_currentPlayerIndex));
+                }
+            }
+            if (m_phase == Phase::GameOver) {
+                return;
+            }
+            break;
+        case CardOp::PayEach:
+            for (unsigned int i = 0; i < m_players.size() && !currPlayer.bankrupt; i++) {
+                if (i != m_currentPlayerIndex && !m_players[i].bankrupt) {
+                    pay(m_currentPlayerIndex, amount, static_cast<int>(i));
+                }
+            }
+            if (currPlayer.bankrupt) {
+                return;
+            }
+            break;
+        case CardOp::AdvanceTo:
+            if (amount < numTiles) {
+                moveCurrentPlayerTo(amount, true);
+                return;
+            }
+            break;
+        case CardOp::AdvanceToNearest:
+            for (unsigned int step = 1; step < numTiles; step++) {
+                unsigned int tile = (currPlayer.position + step) % numTiles;
+                if (m_board->getTile(tile).group == card.value) {
+                    moveCurrentPlayerTo(tile, true);
+                    return;
+                }
+            }
+            break;
+        case CardOp::MoveBy: {
+            int steps = card.value % static_cast<int>(numTiles);
+            moveCurrentPlayerTo((currPlayer.position + numTiles + steps) % numTiles, false);
+            return;
+        }
+        case CardOp::GoToJail:
+            sendToJail();
+            return;
+        case CardOp::GetOutOfJail:
+            m_decks[static_cast<unsigned int>(deck)].hold(index);
+            currPlayer.jailFreeCards[static_cast<unsigned int>(deck)] |= 1u << index;
+            break;
+        case CardOp::Repairs: {
+            BuildingEngine::BuildingCounts counts = m_buildings.getBuildingCounts(m_currentPlayerIndex);
+            unsigned int cost = counts.houses * amount + counts.hotels * static_cast<unsigned int>(card.value2);
+            pay(m_currentPlayerIndex, cost, -1);
+            if (currPlayer.bankrupt) {
+                return;
+            }
+            break;
+        }
+    }
+    setPreEndTurnPhase();
+}
+
+void GameState::moveCurrentPlayerTo(unsigned int tile, bool collectSalary){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    if (collectSalary) {
+        moveCurrentPlayer((tile + m_tiles.size() - currPlayer.position) % m_tiles.size());
+    } else {
+        currPlayer.position = tile;
+    }
+    // a card never leads to another card
+    TileKind kind = m_board->getTile(tile).kind;
+    if (kind == TileKind::Chance || kind == TileKind::CommunityChest) {
+        countLanding(tile);
+        setPreEndTurnPhase();
+        return;
+    }
+    landOnTile();
+}
+
+bool GameState::returnJailFreeCard(unsigned int player){
+    // the card goes back to its own deck, another player may still hold a card of the other one
+    std::uint32_t* held = m_players[player].jailFreeCards;
+    for (unsigned int deck = 0; deck < BoardDefinition::NUM_DECKS; deck++) {
+        if (held[deck] != 0) {
+            unsigned int card = 0;
+            while (!(held[deck] & (1u << card))) {
+                card++;
+            }
+            held[deck] &= ~(1u << card);
+            m_decks[deck].returnHeldCard(card);
+            return true;
+        }
+    }
+    return false;
+}
+
+void GameState::sendToJail(){
+    PlayerState& currPlayer = m_players[m_currentPlayerIndex];
+    if (m_board->getJailIndex() < m_tiles.size()) {
+        currPlayer.position = m_board->getJailIndex();
+        countLanding(currPlayer.position);
+    }
+    currPlayer.inJail = true;
+    currPlayer.jailTurns = 0;
+    m_doublesCount = 0;
+    m_phase = Phase::EndTurn;
+}
+
+void GameState::auctionTile(unsigned int tile){
+    // a bidder that would complete the group, or stop the one player a tile away from completing it, bids higher
+    const TileDefinition& definition = m_board->getTile(tile);
+    std::uint8_t group = definition.group;
+    unsigned int groupSize = m_board->getGroupSize(group);
+    unsigned int owned[MAX_PLAYERS];
+    unsigned int nearlyComplete = 0;
+    for (unsigned int i = 0; i < m_players.size(); i++) {
+        owned[i] = m_buildings.getOwnedCount(group, i);
+        nearlyComplete += (groupSize > 1 && owned[i] + 1 == groupSize) ? 1 : 0;
+    }
+    unsigned int limits[MAX_PLAYERS];
+    for (unsigned int i = 0; i < m_players.size(); i++) {
+        bool others = nearlyComplete > ((groupSize > 1 && owned[i] + 1 == groupSize) ? 1u : 0u);
+        limits[i] = m_players[i].bankrupt ? 0 : std::min(m_players[i].money, m_board->getAuctions().getValue(definition.price, group, owned[i], others));
+    }
+
+    m_lastAuction = AuctionEngine::resolve(m_auctionKind, limits, static_cast<unsigned int>(m_players.size()), m_currentPlayerIndex);
+    m_auctionCount++;
+    if (m_lastAuction.winner < 0) {
+        return;
+    }
+    m_players[m_lastAuction.winner].money -= m_lastAuction.price;
+    m_tiles[tile].owner = static_cast<std::int8_t>(m_lastAuction.winner);
+    m_buildings.setOwner(tile, -1, m_lastAuction.winner);
+}
+
+void GameState::setPreEndTurnPhase(){
+    m_phase = (m_doublesCount > 0) ? Phase::RollDice : Phase::EndTurn;
+}
+
+bool GameState::canManageBuildings(unsigned int player) const {
+    return player == m_currentPlayerIndex && (m_phase == Phase::RollDice || m_phase == Phase::EndTurn)
+        && !m_players[player].bankrupt;
+}
+
+void GameState::pay(unsigned int debtor, unsigned int amount, int creditor){
+    PlayerState& payer = m_players[debtor];
+    if (payer.money < amount && !raiseCash(debtor, amount - payer.money)) {
+        declareBankrupt(debtor, creditor);
+        return;
+    }
+    payer.money -= amount;
+    if (creditor >= 0) {
+        m_players[creditor].money += amount;
+    }
+}
+
+bool GameState::raiseCash(unsigned int player, unsigned int amount){
+    // one planner per thread, it keeps its buffers between the games the thread plays
+    thread_local LiquidationPlanner planner;
+    if (!planner.plan(*this, player, amount)) {
+        return false;
+    }
+    unsigned int target = m_players[player].money + amount;
+    for (const LiquidationPlanner::Sale& sale : planner.getSales()) {
+        // the sales of two groups may need more houses than the bank has together, selling all never needs any
+        if (!m_buildings.sellDown(sale.group, sale.count)) {
+            m_buildings.sellAll(sale.group);
+        }
+        for (unsigned int tile : m_board->getGroupTiles(sale.group)) {
+            unsigned int level = m_buildings.getLevel(tile);
+            m_players[player].money += (m_tiles[tile].buildingLevel - level) * (m_board->getTile(tile).housePrice / 2);
+            m_tiles[tile].buildingLevel = static_cast<std::uint8_t>(level);
+        }
+    }
+    for (unsigned int tile : planner.getMortgages()) {
+        mortgageTile(tile);
+    }
+    return m_players[player].money >= target;
+}
+
+bool GameState::canTradeTile(unsigned int tile, unsigned int owner) const {
+    return tile < m_tiles.size() && m_tiles[tile].owner == static_cast<int>(owner)
+        && !m_buildings.hasBuildings(m_board->getTile(tile).group);
+}
+
+void GameState::transferTile(unsigned int tile, unsigned int newOwner){
+    TileState& state = m_tiles[tile];
+    if (state.mortgaged) {
+        m_players[state.owner].mortgagedTiles--;
+        m_players[newOwner].mortgagedTiles++;
+    }
+    m_buildings.setOwner(tile, state.owner, static_cast<int>(newOwner));
+    state.owner = static_cast<std::int8_t>(newOwner);
+}
+
+void GameState::mortgageTile(unsigned int tile){
+    TileState& state = m_tiles[tile];
+    state.mortgaged = true;
+    m_buildings.setMortgaged(tile, true);
+    m_players[state.owner].mortgagedTiles++;
+    m_players[state.owner].money += getMortgageValue(m_board->getTile(tile));
+}
+
+void GameState::declareBankrupt(unsigned int player, int creditor){
+    PlayerState& bankrupt = m_players[player];
+    while (returnJailFreeCard(player)) {
+    }
+
+    // the buildings go back to the bank's supply for half their price, tiles only change hands in groups without buildings
+    for (unsigned int group = 0; group < m_board->getNumGroups(); group++) {
+        std::uint8_t id = static_cast<std::uint8_t>(group);
+        if (m_buildings.getMonopolyOwner(id) != static_cast<int>(player) || !m_buildings.hasBuildings(id)) {
+            continue;
+        }
+        for (unsigned int tile : m_board->getGroupTiles(id)) {
+            bankrupt.money += m_tiles[tile].buildingLevel * (m_board->getTile(tile).housePrice / 2);
+            m_tiles[tile].buildingLevel = 0;
+        }
+        m_buildings.sellAll(id);
+    }
+
+    // a player creditor takes everything as it is, the bank takes the tiles back clear
+    if (creditor >= 0) {
+        m_players[creditor].money += bankrupt.money;
+    }
+    for (unsigned int i = 0; i < m_tiles.size(); i++) {
+        TileState& tile = m_tiles[i];
+        if (tile.owner != static_cast<int>(player)) {
+            continue;
+        }
+        m_buildings.setOwner(i, static_cast<int>(player), creditor);
+        tile.owner = static_cast<std::int8_t>(creditor);
+        if (creditor >= 0) {
+            m_players[creditor].mortgagedTiles += tile.mortgaged ? 1 : 0;
+        } else if (tile.mortgaged) {
+            m_buildings.setMortgaged(i, false);
+            tile.mortgaged = false;
+        }
+    }
+    bankrupt.money = 0;
+    bankrupt.mortgagedTiles = 0;
+    bankrupt.bankrupt = true;
+
+    m_activePlayers--;
+    if (m_activePlayers <= 1) {
+        m_phase = Phase::GameOver;
+        return;
+    }
+    if (player == m_currentPlayerIndex) {
+        advanceToNextPlayer();
+    }
+}
+
+void GameState::advanceToNextPlayer(){
+    m_doublesCount = 0;
+    m_turnCount++;
+    do {
+        m_currentPlayerIndex = (m_currentPlayerIndex + 1) % m_players.size();
+    } while (m_players[m_currentPlayerIndex].bankrupt);
+    m_phase = Phase::RollDice;
+}
+
+GameState::Phase GameState::getPhase() const {
+    return m_phase;
+}
+
+unsigned int GameState::getCurrentPlayer() const {
+    return m_currentPlayerIndex;
+}
+
+unsigned int GameState::getNumPlayers() const {
+    return static_cast<unsigned int>(m_players.size());
+}
+
+unsigned int GameState::getNumTiles() const {
+    return static_cast<unsigned int>(m_tiles.size());
+}
+
+const GameState::PlayerState& GameState::getPlayer(unsigned int index) const {
+    return m_players.at(index);
+}
+
+const GameState::TileState& GameState::getTile(unsigned int index) const {
+    return m_tiles.at(index);
+}
+
+const GameState::TileDefinition& GameState::getTileDefinition(unsigned int index) const {
+    return m_board->getTile(index);
+}
+
+const BoardDefinition& GameState::getBoard() const {
+    return *m_board;
+}
+
+const BuildingEngine& GameState::getBuildings() const {
+    return m_buildings;
+}
+
+unsigned int GameState::getLastDie1() const {
+    return m_lastDie1;
+}
+
+unsigned int GameState::getLastDie2() const {
+    return m_lastDie2;
+}
+
+unsigned int GameState::getTurnCount() const {
+    return m_turnCount;
+}
+
+AuctionEngine::Kind GameState::getAuctionKind() const {
+    return m_auctionKind;
+}
+
+unsigned int GameState::getAuctionCount() const {
+    return m_auctionCount;
+}
+
+const AuctionEngine::Result& GameState::getLastAuction() const {
+    return m_lastAuction;
+}
+
+const GameState::Card* GameState::getLastCard() const {
+    return m_lastCard;
+}
+
+int GameState::getWinner() const {
+    if (m_phase != Phase::GameOver) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < m_players.size(); i++) {
+        if (!m_players[i].bankrupt) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::uint64_t GameState::getNetWorth(unsigned int player) const {
+    std::uint64_t worth = m_players.at(player).money;
+    for (unsigned int tile = 0; tile < m_tiles.size(); tile++) {
+        const TileState& state = m_tiles[tile];
+        if (state.owner != static_cast<int>(player)) {
+            continue;
+        }
+        const TileDefinition& definition = m_board->getTile(tile);
+        worth += definition.price - (state.mortgaged ? getMortgageValue(definition) : 0);
+        worth += static_cast<std::uint64_t>(state.buildingLevel) * definition.housePrice;
+    }
+    return worth;
+}
+
+std::size_t GameState::getMemoryUsage() const {
+    return sizeof(*this) + m_tiles.capacity() * sizeof(TileState) + m_players.capacity() * sizeof(PlayerState)
+        + m_buildings.getMemoryUsage();
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AuctionEngine.hpp"
+#include "BoardDefinition.hpp"
+#include "BuildingEngine.hpp"
+#include "CardDeck.hpp"
+#include "Dice.hpp"
+
+/** @class GameState
+ *
+ * @brief The rules of a single Monopoly game without any graphics.
+ *
+ * GameState walks the same flow as the menus of MonopolyGame (roll the dice, move, buy or pay rent,
+ * end the turn) but keeps only plain data, so it can run without a window or a font.
+ * Many GameStates can be hosted in one process, e.g. by the GameServer.
+ *
+ * A street whose purchase is declined is auctioned right away among all the players still in the game, who bid
+ * with the bot valuations of the AuctionEngine, so "Do Not Buy" no longer leaves it with the bank.
+ */
+class GameState {
+public:
+    /** @brief The maximal number of players in one game. */
+    static constexpr unsigned int MAX_PLAYERS = 8;
+
+    /** @brief The money every player starts with. */
+    static constexpr unsigned int STARTING_MONEY = 1500;
+
+    /** @brief The money a player collects when passing Go. */
+    static constexpr unsigned int GO_SALARY = 200;
+
+    /** @brief The fine a player pays to leave the jail after failing to roll a double. */
+    static constexpr unsigned int JAIL_FINE = 50;
+
+    /** @brief The interest paid on top of the mortgage value to redeem a mortgaged tile, in percent. */
+    static constexpr unsigned int MORTGAGE_INTEREST_PERCENT = 10;
+
+    /** @brief What happens when a player lands on a tile. */
+    using TileKind = BoardDefinition::TileKind;
+
+    /** @brief What never changes about a tile, shared by all the games on the board. */
+    using TileDefinition = BoardDefinition::Tile;
+
+    /** @brief The decks of cards, and their cards. */
+    using DeckKind = BoardDefinition::DeckKind;
+    using CardOp = BoardDefinition::CardOp;
+    using Card = BoardDefinition::Card;
+
+    /** @enum Phase
+     *  @brief The decision the current player has to make, named after the matching menu.
+     */
+    enum class Phase : std::uint8_t { RollDice, BuyMenu, EndTurn, GameOver };
+
+    /** @enum Action
+     *  @brief The actions (menu buttons) a player can take.
+     */
+    enum class Action : std::uint8_t { RollDice, Buy, DoNotBuy, EndTurn };
+
+    /** @enum Status
+     *  @brief The result of applying an action.
+     */
+    enum class Status : std::uint8_t { Ok, NotYourTurn, IllegalAction, NotEnoughMoney, GameOver };
+
+    /** @brief The state of one tile in one game, the rest of the tile is in its TileDefinition. */
+    struct TileState {
+        std::int8_t owner;         ///< Index of the owning player, -1 if owned by the bank.
+        std::uint8_t buildingLevel;///< 0 for no buildings, 1-4 for houses and 5 for a hotel.
+        bool mortgaged;            ///< Whether the tile is mortgaged (no rent is collected).
+    };
+
+    /** @brief The state of one player. */
+    struct PlayerState {
+        unsigned int money;        ///< Amount of money the player has.
+        unsigned int position;     ///< Index of the tile the player is on.
+        bool inJail;               ///< Jail status of the player.
+        unsigned int jailTurns;    ///< Number of turns the player already spent in jail.
+        bool bankrupt;             ///< Whether the player is out of the game.
+        std::uint32_t jailFreeCards[BoardDefinition::NUM_DECKS]; ///< The "get out of jail free" cards the player holds, a bit per card of every deck.
+        std::uint16_t mortgagedTiles; ///< The number of the player's tiles that are mortgaged.
+    };
+
+    /** @brief A trade between the current player and another one: tiles both ways, and cash. */
+    struct TradeOffer {
+        /** @brief The most tiles going each way. */
+        static constexpr unsigned int MAX_TILES = 4;
+
+        std::uint8_t partner;      ///< The index of the player the trade is with.
+        std::uint8_t numGiven;     ///< The number of tiles the current player gives.
+        std::uint8_t numTaken;     ///< The number of tiles the partner gives.
+        std::uint16_t given[MAX_TILES];
+        std::uint16_t taken[MAX_TILES];
+        std::int32_t cash;         ///< Paid by the current player to the partner, the other way when negative.
+    };
+
+    /** @brief Counts of what happens in a game, kept by the caller (see GameStats), the game only adds to them. */
+    struct Counters {
+        std::vector<std::uint64_t> landings;       ///< The moves that ended on every tile, getNumTiles() of them.
+        std::uint64_t rentCollected[MAX_PLAYERS];  ///< The rent every player collected.
+    };
+
+    /** @brief Creates a game.
+     *
+     * @param numPlayers The number of players, between 2 and MAX_PLAYERS.
+     * @param seed The seed of the game's dice.
+     * @param board The tiles of the board, it must outlive the game.
+     */
+    GameState(unsigned int numPlayers, std::uint64_t seed, const BoardDefinition& board = BoardDefinition::standard());
+
+    /** @brief Applies an action of the given player.
+     *
+     * @param player The index of the acting player.
+     * @param action The action to apply.
+     * @return Status::Ok if the action was applied, otherwise the reason it was refused.
+     */
+    Status apply(unsigned int player, Action action);
+
+    /** @brief Builds a house (or a hotel over 4 houses) for the given player, on their turn before rolling or ending it.
+     *
+     * @param player The index of the acting player.
+     * @param tile The index of the tile, the player must be able to build on it (see BuildingEngine::canBuild()).
+     * @return Status::Ok if the building was bought, otherwise the reason it was refused.
+     */
+    Status build(unsigned int player, unsigned int tile);
+
+    /** @brief Sells a building of the given player back to the bank for half its price, on their turn.
+     *
+     * @param player The index of the acting player.
+     * @param tile The index of the tile, the player must be able to sell on it (see BuildingEngine::canSell()).
+     * @return Status::Ok if the building was sold, otherwise the reason it was refused.
+     */
+    Status sellBuilding(unsigned int player, unsigned int tile);
+
+    /** @brief Mortgages a tile of the given player for its mortgage value, on their turn.
+     *
+     * @param player The index of the acting player.
+     * @param tile The index of the tile, owned by the player, unmortgaged, and in a group without buildings.
+     * @return Status::Ok if the tile was mortgaged, otherwise the reason it was refused.
+     */
+    Status mortgage(unsigned int player, unsigned int tile);
+
+    /** @brief Redeems a mortgaged tile of the given player for its mortgage value plus the interest, on their turn.
+     *
+     * @param player The index of the acting player.
+     * @param tile The index of the tile, owned by the player and mortgaged.
+     * @return Status::Ok if the tile was redeemed, otherwise the reason it was refused.
+     */
+    Status redeem(unsigned int player, unsigned int tile);
+
+    /** @brief Sets the counters the game adds to from now on, nullptr (the default) to count nothing.
+     *
+     * @param counters The counters, their landings sized to the board. They must outlive the game, or be replaced.
+     */
+    void setCounters(Counters* counters);
+
+    /** @brief Sets how the auctions of the declined purchases are bid, ascending by default. */
+    void setAuctionKind(AuctionEngine::Kind kind);
+
+    /** @brief Trades tiles and cash with another player, on the given player's turn. The partner must have agreed.
+     *
+     * the tiles keep their mortgages. Tiles of groups with buildings can't be traded.
+     * @param player The index of the acting player.
+     * @param offer The trade, every tile must be owned by the player giving it and appear once.
+     * @return Status::Ok if the trade was made, otherwise the reason it was refused.
+     */
+    Status trade(unsigned int player, const TradeOffer& offer);
+
+    /** @brief Calculates the rent of a tile according to its building level, none while it's mortgaged. */
+    static unsigned int calcRent(const TileDefinition& definition, const TileState& tile);
+
+    /** @brief Gets the cash mortgaging a tile raises, half its price. */
+    static unsigned int getMortgageValue(const TileDefinition& definition);
+
+    /** @brief Gets the cost of redeeming a mortgaged tile, its mortgage value plus the interest (rounded up). */
+    static unsigned int getRedeemCost(const TileDefinition& definition);
+
+    //* Getters
+    Phase getPhase() const;
+    unsigned int getCurrentPlayer() const;
+    unsigned int getNumPlayers() const;
+    unsigned int getNumTiles() const;
+    const PlayerState& getPlayer(unsigned int index) const;
+    const TileState& getTile(unsigned int index) const;
+    const TileDefinition& getTileDefinition(unsigned int index) const;
+    const BoardDefinition& getBoard() const;
+    /** @brief Gets the building rules of the game: where every player can build now, and the bank's supply. */
+    const BuildingEngine& getBuildings() const;
+    unsigned int getLastDie1() const;
+    unsigned int getLastDie2() const;
+    unsigned int getTurnCount() const;
+    AuctionEngine::Kind getAuctionKind() const;
+    /** @brief Gets the number of auctions held so far, with or without a winner. */
+    unsigned int getAuctionCount() const;
+    /** @brief Gets the outcome of the last auction, meaningless before the first one. */
+    const AuctionEngine::Result& getLastAuction() const;
+    /** @brief Gets the last card drawn, nullptr before the first one. */
+    const Card* getLastCard() const;
+    /** @brief Gets the index of the winner, or -1 while the game is still running. */
+    int getWinner() const;
+    /** @brief Gets what a player would have by selling everything: cash, tiles at their price (less the mortgages)
+     *  and buildings at theirs. */
+    std::uint64_t getNetWorth(unsigned int player) const;
+
+    /** @brief Gets the bytes one game takes, without the board definition it shares with the other games. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /** @brief Checks the number of players before any member is sized with it.
+     *
+     * @throws std::invalid_argument if it isn't between 2 and MAX_PLAYERS.
+     */
+    static unsigned int checkedNumPlayers(unsigned int numPlayers);
+
+    /** @brief Rolls the dice for the current player and moves them. */
+    void rollDice();
+
+    /** @brief Moves the current player the given number of steps, collecting the Go salary on the way. */
+    void moveCurrentPlayer(unsigned int steps);
+
+    /** @brief Applies the effect of the tile the current player landed on and sets the next phase. */
+    void landOnTile();
+
+    /** @brief Counts a move of the current player that ended on a tile. */
+    void countLanding(unsigned int tile);
+
+    /** @brief Draws a card of a deck for the current player and runs it. */
+    void drawCard(DeckKind deck);
+
+    /** @brief Runs the op of a card drawn by the current player, and sets the next phase.
+     *
+     * @param card The card.
+     * @param deck The deck the card was drawn from.
+     * @param index The index of the card in its deck.
+     */
+    void runCard(const Card& card, DeckKind deck, unsigned int index);
+
+    /** @brief Moves the current player to a tile a card sent them to, and lands there.
+     *
+     * a card tile reached this way doesn't draw another card.
+     * @param tile The tile.
+     * @param collectSalary Whether passing Go on the way pays the salary.
+     */
+    void moveCurrentPlayerTo(unsigned int tile, bool collectSalary);
+
+    /** @brief Returns a "get out of jail free" card the player holds to the deck it was drawn from.
+     *
+     * @return Whether the player held one.
+     */
+    bool returnJailFreeCard(unsigned int player);
+
+    /** @brief Moves the current player to the jail and ends their rolling. */
+    void sendToJail();
+
+    /** @brief Auctions the tile the current player declined to buy, and gives it to the winner. */
+    void auctionTile(unsigned int tile);
+
+    /** @brief Sets the phase that follows the landing: roll again after a double, otherwise end the turn. */
+    void setPreEndTurnPhase();
+
+    /** @brief Checks if the player can build or sell now: it's their turn, and they aren't in the middle of a move. */
+    bool canManageBuildings(unsigned int player) const;
+
+    /** @brief Makes a player pay the given amount to the creditor (-1 for the bank).
+     *
+     * a player short of cash first sells buildings and mortgages tiles as planned by a LiquidationPlanner,
+     * and is declared bankrupt only if all their holdings can't cover the debt.
+     */
+    void pay(unsigned int debtor, unsigned int amount, int creditor);
+
+    /** @brief Sells the buildings and mortgages the tiles a LiquidationPlanner chose to raise an amount of cash.
+     *
+     * @return Whether the player's holdings raised it, nothing is sold if the planner found they can't.
+     */
+    bool raiseCash(unsigned int player, unsigned int amount);
+
+    /** @brief Checks if a tile can be traded by its owner: owned by them and in a group without buildings. */
+    bool canTradeTile(unsigned int tile, unsigned int owner) const;
+
+    /** @brief Hands a tile and its mortgage over to another player. */
+    void transferTile(unsigned int tile, unsigned int newOwner);
+
+    /** @brief Mortgages a tile and pays its owner the mortgage value. */
+    void mortgageTile(unsigned int tile);
+
+    /** @brief Removes the player from the game and hands everything they have to their creditor.
+     *
+     * their buildings are sold to the bank first. A player creditor gets the cash and the tiles (still mortgaged),
+     * the bank takes the tiles back unmortgaged.
+     * @param player The bankrupt player.
+     * @param creditor The index of the player they owe, -1 for the bank.
+     */
+    void declareBankrupt(unsigned int player, int creditor);
+
+    /** @brief Passes the turn to the next player that is still in the game. */
+    void advanceToNextPlayer();
+
+    //* MEMBERS
+    const BoardDefinition* m_board;       ///< The tiles of the board, shared by all the games on it.
+    std::vector<TileState> m_tiles;       ///< The state of every tile, in the order of the board.
+    std::vector<PlayerState> m_players;   ///< The players of the game.
+    Dice m_dice;                          ///< The dice of the game, they also shuffle the decks.
+    CardDeck m_decks[BoardDefinition::NUM_DECKS]; ///< The order of the cards of every deck, indexed by DeckKind.
+    BuildingEngine m_buildings;           ///< The monopolies, the buildings and the bank's supply of them.
+    AuctionEngine::Result m_lastAuction;  ///< The outcome of the last auction.
+    unsigned int m_auctionCount;          ///< The number of auctions held so far.
+    AuctionEngine::Kind m_auctionKind;    ///< How the auctions are bid.
+    const Card* m_lastCard;               ///< The last card drawn, nullptr before the first one.
+    Counters* m_counters;                 ///< The counters of what happens, nullptr to count nothing.
+    Phase m_phase;                        ///< The decision the current player has to make.
+    unsigned int m_currentPlayerIndex;    ///< The player whose turn it is.
+    unsigned int m_doublesCount;          ///< The number of doubles the current player rolled this turn.
+    unsigned int m_lastDie1;              ///< The first die of the last roll.
+    unsigned int m_lastDie2;              ///< The second die of the last roll.
+    unsigned int m_turnCount;             ///< The number of turns played so far.
+    unsigned int m_activePlayers;         ///< The number of players that are not bankrupt.
+};
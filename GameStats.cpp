@@ -0,0 +1,133 @@
+#include <algorithm>
+#include "GameStats.hpp"
+
+GameStats::GameStats(unsigned int numTiles)
+    : m_numGames(0),
+      m_numTurns(0)
+{
+    m_counters.landings.assign(numTiles, 0);
+    std::fill(std::begin(m_counters.rentCollected), std::end(m_counters.rentCollected), 0);
+    std::fill(std::begin(m_income), std::end(m_income), 0);
+    std::fill(std::begin(m_seatGames), std::end(m_seatGames), 0);
+    std::fill(std::begin(m_seatWins), std::end(m_seatWins), 0);
+}
+
+void GameStats::beginGame(GameState& game){
+    std::fill(std::begin(m_counters.rentCollected), std::end(m_counters.rentCollected), 0);
+    game.setCounters(&m_counters);
+}
+
+void GameStats::endGame(GameState& game, int winner){
+    game.setCounters(nullptr);
+    m_numGames++;
+    m_numTurns += game.getTurnCount();
+    m_lengths.add(game.getTurnCount());
+    for (unsigned int player = 0; player < game.getNumPlayers(); player++) {
+        m_wealth.add(static_cast<double>(game.getNetWorth(player)));
+        m_seatGames[player]++;
+        m_seatWins[player] += winner == static_cast<int>(player) ? 1 : 0;
+
+        // the bucket of a rent is the number of bits it takes
+        std::uint64_t rent = m_counters.rentCollected[player];
+        unsigned int bucket = 0;
+        while (rent > 0 && bucket + 1 < INCOME_BUCKETS) {
+            rent >>= 1;
+            bucket++;
+        }
+        m_income[bucket]++;
+    }
+}
+
+void GameStats::merge(const GameStats& other){
+    m_numGames += other.m_numGames;
+    m_numTurns += other.m_numTurns;
+    for (std::size_t tile = 0; tile < m_counters.landings.size() && tile < other.m_counters.landings.size(); tile++) {
+        m_counters.landings[tile] += other.m_counters.landings[tile];
+    }
+    for (unsigned int bucket = 0; bucket < INCOME_BUCKETS; bucket++) {
+        m_income[bucket] += other.m_income[bucket];
+    }
+    m_lengths.merge(other.m_lengths);
+    m_wealth.merge(other.m_wealth);
+    for (unsigned int seat = 0; seat < GameState::MAX_PLAYERS; seat++) {
+        m_seatGames[seat] += other.m_seatGames[seat];
+        m_seatWins[seat] += other.m_seatWins[seat];
+    }
+}
+
+void GameStats::save(Protocol::Writer& writer) const {
+    writer.u64(m_numGames);
+    writer.u64(m_numTurns);
+    writer.u32(static_cast<std::uint32_t>(m_counters.landings.size()));
+    for (std::uint64_t landings : m_counters.landings) {
+        writer.u64(landings);
+    }
+    for (std::uint64_t count : m_income) {
+        writer.u64(count);
+    }
+    m_lengths.save(writer);
+    m_wealth.save(writer);
+    for (unsigned int seat = 0; seat < GameState::MAX_PLAYERS; seat++) {
+        writer.u64(m_seatGames[seat]);
+        writer.u64(m_seatWins[seat]);
+    }
+}
+
+bool GameStats::load(Protocol::Reader& reader){
+    m_numGames = reader.u64();
+    m_numTurns = reader.u64();
+    if (reader.u32() != m_counters.landings.size()) {
+        return false;
+    }
+    for (std::uint64_t& landings : m_counters.landings) {
+        landings = reader.u64();
+    }
+    for (std::uint64_t& count : m_income) {
+        count = reader.u64();
+    }
+    if (!m_lengths.load(reader) || !m_wealth.load(reader)) {
+        return false;
+    }
+    for (unsigned int seat = 0; seat < GameState::MAX_PLAYERS; seat++) {
+        m_seatGames[seat] = reader.u64();
+        m_seatWins[seat] = reader.u64();
+    }
+    return reader.ok();
+}
+
+double GameStats::getLengthQuantile(double quantile){
+    return m_lengths.getQuantile(quantile);
+}
+
+double GameStats::getWealthQuantile(double quantile){
+    return m_wealth.getQuantile(quantile);
+}
+
+std::uint64_t GameStats::getNumGames() const {
+    return m_numGames;
+}
+
+std::uint64_t GameStats::getNumTurns() const {
+    return m_numTurns;
+}
+
+const std::vector<std::uint64_t>& GameStats::getLandings() const {
+    return m_counters.landings;
+}
+
+const std::uint64_t* GameStats::getIncomeHistogram() const {
+    return m_income;
+}
+
+std::uint64_t GameStats::getSeatGames(unsigned int seat) const {
+    return seat < GameState::MAX_PLAYERS ? m_seatGames[seat] : 0;
+}
+
+std::uint64_t GameStats::getSeatWins(unsigned int seat) const {
+    return seat < GameState::MAX_PLAYERS ? m_seatWins[seat] : 0;
+}
+
+std::size_t GameStats::getMemoryUsage() const {
+    return sizeof(*this) - 2 * sizeof(TDigest) + m_lengths.getMemoryUsage() + m_wealth.getMemoryUsage()
+        + m_counters.landings.capacity() * sizeof(std::uint64_t);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.hpp"
+#include "TDigest.hpp"
+
+/** @class GameStats
+ *
+ * @brief A summary of many finished games that takes the same memory after 10 games or after 100 million.
+ *
+ * It keeps the landings on every tile, a histogram of the rent every player collected in a game (in powers of 2),
+ * the quantiles of the length of the games and of the final net worth of the players (as TDigests), and the games
+ * and the wins of every seat. Every part is a sum or a mergeable sketch, so a simulation gives every worker thread
+ * its own summary, with nothing shared while the games run, and merges them once at the end.
+ *
+ * A game counts into the summary through its GameState::Counters: beginGame() hands them to the game, and
+ * endGame() adds the game's result and clears the rents for the next one. The games add their landings straight
+ * to the totals. A summary must not move while a game counts into it.
+ */
+class GameStats {
+public:
+    /** @brief The buckets of the rent histogram: 0, then [2^(i-1), 2^i) for the bucket i. */
+    static constexpr unsigned int INCOME_BUCKETS = 32;
+
+    /** @brief Creates an empty summary of the games of a board.
+     *
+     * @param numTiles The number of tiles of the board.
+     */
+    explicit GameStats(unsigned int numTiles);
+
+    /** @brief Starts counting a game, the game adds to the counters of the summary until endGame(). */
+    void beginGame(GameState& game);
+
+    /** @brief Adds a finished (or stopped) game to the summary.
+     *
+     * @param game The game, it stops counting.
+     * @param winner The index of the winning player, -1 for a draw.
+     */
+    void endGame(GameState& game, int winner);
+
+    /** @brief Adds the games of another summary of the same board. */
+    void merge(const GameStats& other);
+
+    /** @brief Writes the summary, so load() gives back the very same one. */
+    void save(Protocol::Writer& writer) const;
+
+    /** @brief Reads a summary written by save() for a board with the same number of tiles.
+     *
+     * @return If the summary read is whole.
+     */
+    bool load(Protocol::Reader& reader);
+
+    /** @brief Estimates a quantile of the length of the games, in turns. */
+    double getLengthQuantile(double quantile);
+
+    /** @brief Estimates a quantile of the final net worth of the players. */
+    double getWealthQuantile(double quantile);
+
+    //* Getters
+    std::uint64_t getNumGames() const;
+    /** @brief Gets the turns of all the games. */
+    std::uint64_t getNumTurns() const;
+    const std::vector<std::uint64_t>& getLandings() const;
+    /** @brief Gets the number of players whose rent of a game fell in every bucket. */
+    const std::uint64_t* getIncomeHistogram() const;
+    /** @brief Gets the games a seat was played in, and the games it won. */
+    std::uint64_t getSeatGames(unsigned int seat) const;
+    std::uint64_t getSeatWins(unsigned int seat) const;
+    /** @brief Gets the bytes the summary takes, it doesn't grow with the games. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    //* MEMBERS
+    std::uint64_t m_numGames;
+    std::uint64_t m_numTurns;
+    GameState::Counters m_counters;        ///< The landings of all the games, and the rents of the game being played.
+    std::uint64_t m_income[INCOME_BUCKETS];
+    TDigest m_lengths;
+    TDigest m_wealth;
+    std::uint64_t m_seatGames[GameState::MAX_PLAYERS];
+    std::uint64_t m_seatWins[GameState::MAX_PLAYERS];
+};
@@ -0,0 +1,78 @@
+#include <mutex>
+#include <unordered_map>
+#include "LabelTable.hpp"
+
+namespace {
+    // the maximal building level, a hotel
+    constexpr unsigned int HOTEL_LEVEL = 5;
+
+    struct Table {
+        std::mutex mutex;
+        std::unordered_map<std::u32string, sf::String> strings;     // a node based map, so the strings never move
+        std::unordered_map<std::string, const sf::String*> byText;  // the strings interned from std::string, found without converting
+        std::unordered_map<unsigned int, const sf::String*> prices;
+        const sf::String* buildings[HOTEL_LEVEL + 1] = {};
+    };
+
+    Table& getTable(){
+        // never destroyed, the labels may be referenced by static objects
+        static Table* table = new Table();
+        return *table;
+    }
+
+    // interns a string, the table's mutex must be held
+    const sf::String& internLocked(Table& table, const sf::String& text){
+        std::u32string key(text.getData(), text.getData() + text.getSize());
+        auto found = table.strings.find(key);
+        if (found == table.strings.end()) {
+            found = table.strings.emplace(std::move(key), text).first;
+        }
+        return found->second;
+    }
+}
+
+const sf::String& LabelTable::intern(const std::string& text){
+    Table& table = getTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto found = table.byText.find(text);
+    if (found == table.byText.end()) {
+        found = table.byText.emplace(text, &internLocked(table, sf::String(text))).first;
+    }
+    return *found->second;
+}
+
+const sf::String& LabelTable::intern(const sf::String& text){
+    Table& table = getTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return internLocked(table, text);
+}
+
+const sf::String& LabelTable::price(unsigned int price){
+    Table& table = getTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    const sf::String*& label = table.prices[price];
+    if (!label) {
+        label = &internLocked(table, sf::String("$" + std::to_string(price)));
+    }
+    return *label;
+}
+
+const sf::String& LabelTable::buildings(unsigned int level){
+    if (level > HOTEL_LEVEL) {
+        level = HOTEL_LEVEL;
+    }
+    Table& table = getTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    const sf::String*& label = table.buildings[level];
+    if (!label) {
+        std::string text = level == 0 ? "" : level == HOTEL_LEVEL ? "Hotel" : "Houses: " + std::to_string(level);
+        label = &internLocked(table, sf::String(text));
+    }
+    return *label;
+}
+
+std::size_t LabelTable::size(){
+    Table& table = getTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.strings.size();
+}
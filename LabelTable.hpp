@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+
+/** @class LabelTable
+ *
+ * @brief Interns the strings shown on the board, so every tile references one shared copy of each label.
+ *
+ * An interned string lives (at the same address) until the program exits, so a TextBox::TextSpec can point
+ * at it instead of owning a copy. The price and building labels are looked up by number, which never allocates
+ * once the label exists. The table is safe to use from several threads.
+ */
+class LabelTable {
+public:
+    /** @brief Gets the interned copy of a string, adding it on first use. */
+    static const sf::String& intern(const std::string& text);
+    static const sf::String& intern(const sf::String& text);
+
+    /** @brief Gets the label of a price, e.g. "$200". */
+    static const sf::String& price(unsigned int price);
+
+    /** @brief Gets the label of a building level: empty for none, "Houses: 1" to "Houses: 4", or "Hotel" for 5 and above. */
+    static const sf::String& buildings(unsigned int level);
+
+    /** @brief Gets the number of interned strings. */
+    static std::size_t size();
+};
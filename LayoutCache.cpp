@@ -0,0 +1,171 @@
+#include <cstring>
+#include <fstream>
+#include "LayoutCache.hpp"
+
+namespace {
+    // the first bytes of a cache file, bump the version when the layout algorithm or the format changes
+    const char CACHE_MAGIC[4] = { 'M', 'L', 'C', '1' };
+    constexpr std::uint32_t MAX_PLACEMENTS = 64;
+
+    template <typename T>
+    void writeValue(std::ostream& out, const T& value){
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool readValue(std::istream& in, T& value){
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+LayoutCache::LayoutCache()
+    : m_dirty(false),
+      m_hits(0),
+      m_misses(0)
+{
+}
+
+bool LayoutCache::load(const std::string& path){
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(CACHE_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    // read everything first, so a truncated file leaves the cache untouched
+    std::uint32_t count;
+    if (!readValue(in, count)) {
+        return false;
+    }
+    std::unordered_map<std::uint64_t, Entry> entries;
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint64_t key;
+        std::uint32_t fontSize;
+        std::uint32_t placements;
+        if (!readValue(in, key) || !readValue(in, fontSize) || !readValue(in, placements) || placements > MAX_PLACEMENTS) {
+            return false;
+        }
+        Entry entry{ TextLayout(), false };
+        entry.layout.fontSize = fontSize;
+        entry.layout.placements.resize(placements);
+        for (auto& placement : entry.layout.placements) {
+            if (!readValue(in, placement.origin.x) || !readValue(in, placement.origin.y)
+                || !readValue(in, placement.position.x) || !readValue(in, placement.position.y)) {
+                return false;
+            }
+        }
+        entries.emplace(key, std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.swap(entries);
+    m_dirty = false;
+    return true;
+}
+
+bool LayoutCache::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    std::uint32_t count = 0;
+    for (const auto& entry : m_entries) {
+        count += entry.second.used ? 1 : 0;
+    }
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    writeValue(out, count);
+    for (const auto& entry : m_entries) {
+        if (!entry.second.used) {
+            continue;
+        }
+        const TextLayout& layout = entry.second.layout;
+        writeValue(out, entry.first);
+        writeValue(out, static_cast<std::uint32_t>(layout.fontSize));
+        writeValue(out, static_cast<std::uint32_t>(layout.placements.size()));
+        for (const auto& placement : layout.placements) {
+            writeValue(out, placement.origin.x);
+            writeValue(out, placement.origin.y);
+            writeValue(out, placement.position.x);
+            writeValue(out, placement.position.y);
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+void LayoutCache::registerFont(const sf::Font* font, std::uint64_t fontId){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fontIds[font] = fontId;
+}
+
+void LayoutCache::unregisterFont(const sf::Font* font){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fontIds.erase(font);
+}
+
+bool LayoutCache::getFontId(const sf::Font* font, std::uint64_t& fontId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_fontIds.find(font);
+    if (found == m_fontIds.end()) {
+        return false;
+    }
+    fontId = found->second;
+    return true;
+}
+
+bool LayoutCache::find(std::uint64_t key, TextLayout& layout){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_entries.find(key);
+    if (found == m_entries.end()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    found->second.used = true;
+    layout = found->second.layout;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void LayoutCache::insert(std::uint64_t key, const TextLayout& layout){
+    if (layout.placements.size() > MAX_PLACEMENTS) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[key] = Entry{ layout, true };
+    m_dirty = true;
+}
+
+bool LayoutCache::isDirty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dirty;
+}
+
+std::uint64_t LayoutCache::getHits() const {
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LayoutCache::getMisses() const {
+    return m_misses.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LayoutCache::hashFile(const std::string& path){
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return 0;
+    }
+    std::uint64_t hash = HASH_SEED;
+    char buffer[64 * 1024];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        hash = hashBytes(hash, buffer, static_cast<std::size_t>(in.gcount()));
+    }
+    return hash;
+}
+
+std::uint64_t LayoutCache::hashBytes(std::uint64_t hash, const void* data, std::size_t size){
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
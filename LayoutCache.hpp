@@ -0,0 +1,108 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** @brief The result of laying out a TextBox: its font size and where each of its texts goes. */
+struct TextLayout {
+    /** @brief The origin and the position of one text. */
+    struct Placement {
+        sf::Vector2f origin;
+        sf::Vector2f position;
+    };
+
+    unsigned int fontSize = 0;
+    std::vector<Placement> placements; ///< One per text entry, in order.
+};
+
+/** @class LayoutCache
+ *
+ * @brief Remembers TextBox layouts across runs, so a warm start skips all the text measurement.
+ *
+ * A layout only depends on the font, the strings (and their style), the alignments, the direction and
+ * the bounds of the text box, so it's stored under a 64 bit hash of those. Fonts are identified by the
+ * id they were registered with (e.g. a hash of the font file), text boxes using an unregistered font
+ * are never cached. The cache is safe to use from several threads.
+ */
+class LayoutCache {
+public:
+    LayoutCache();
+
+    /** @brief Loads the layouts saved by an earlier run.
+     *
+     * @param path The path of the cache file.
+     * @return Whether the file was read, false if it's missing, of another version or corrupt.
+     */
+    bool load(const std::string& path);
+
+    /** @brief Saves the layouts used in this run, dropping the ones that weren't (so the file never grows stale).
+     *
+     * @param path The path of the cache file.
+     * @return Whether the file was written.
+     */
+    bool save(const std::string& path) const;
+
+    /** @brief Registers a font, so the layouts of its texts are cached.
+     *
+     * @param font The font.
+     * @param fontId An id that changes whenever the font changes, see hashFile().
+     */
+    void registerFont(const sf::Font* font, std::uint64_t fontId);
+
+    /** @brief Forgets a registered font, call it before the font is destroyed. */
+    void unregisterFont(const sf::Font* font);
+
+    /** @brief Gets the id a font was registered with.
+     *
+     * @return Whether the font is registered.
+     */
+    bool getFontId(const sf::Font* font, std::uint64_t& fontId) const;
+
+    /** @brief Looks up a layout, marking it as used.
+     *
+     * @return Whether the layout was found.
+     */
+    bool find(std::uint64_t key, TextLayout& layout);
+
+    /** @brief Stores a layout. */
+    void insert(std::uint64_t key, const TextLayout& layout);
+
+    /** @brief Whether layouts were inserted since the last load. */
+    bool isDirty() const;
+
+    /** @brief Gets the number of lookups that found (hits) or missed (misses) their layout. */
+    std::uint64_t getHits() const;
+    std::uint64_t getMisses() const;
+
+    /** @brief Hashes the content of a file, e.g. to identify a font.
+     *
+     * @return The hash, or 0 if the file can't be read.
+     */
+    static std::uint64_t hashFile(const std::string& path);
+
+    /** @brief Mixes bytes into a running FNV-1a hash. */
+    static std::uint64_t hashBytes(std::uint64_t hash, const void* data, std::size_t size);
+
+    /** @brief The starting value of a hash built with hashBytes(). */
+    static constexpr std::uint64_t HASH_SEED = 14695981039346656037ull;
+
+private:
+    /** @brief A stored layout and whether it was used in this run. */
+    struct Entry {
+        TextLayout layout;
+        bool used;
+    };
+
+    //* MEMBERS
+    mutable std::mutex m_mutex;                                  ///< Guards every member below except the counters.
+    std::unordered_map<std::uint64_t, Entry> m_entries;
+    std::unordered_map<const sf::Font*, std::uint64_t> m_fontIds;
+    bool m_dirty;
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
+};
@@ -0,0 +1,49 @@
+#include "LayoutPass.hpp"
+#include "Profiler.hpp"
+
+LayoutPass::LayoutPass(unsigned int numWorkers)
+    : m_pool(numWorkers),
+      m_substitutes(m_pool.getNumWorkers()),
+      m_parallel(true)
+{
+}
+
+bool LayoutPass::addFont(const sf::Font& font, const std::string& path){
+    for (unsigned int worker = 1; worker < m_pool.getNumWorkers(); worker++) {
+        auto copy = std::make_unique<sf::Font>();
+        if (!copy->loadFromFile(path)) {
+            m_parallel = false;
+            return false;
+        }
+        m_substitutes[worker][&font] = copy.get();
+        m_fontCopies.push_back(std::move(copy));
+    }
+    return true;
+}
+
+std::size_t LayoutPass::run(const std::vector<const TextBox*>& textBoxes){
+    PROFILE_ZONE("LayoutPass::run");
+    m_pending.clear();
+    for (const TextBox* textBox : textBoxes) {
+        if (textBox->needsLayout()) {
+            m_pending.push_back(textBox);
+        }
+    }
+
+    if (!m_parallel) {
+        for (const TextBox* textBox : m_pending) {
+            textBox->layout();
+        }
+        return m_pending.size();
+    }
+
+    m_pool.parallelFor(m_pending.size(), [this](std::size_t index, unsigned int worker){
+        // worker 0 is the calling thread, which owns the original fonts
+        m_pending[index]->layout(worker == 0 ? nullptr : &m_substitutes[worker]);
+    });
+    return m_pending.size();
+}
+
+unsigned int LayoutPass::getNumWorkers() const {
+    return m_parallel ? m_pool.getNumWorkers() : 1;
+}
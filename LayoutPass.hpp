@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TextBox.hpp"
+#include "ThreadPool.hpp"
+
+/** @class LayoutPass
+ *
+ * @brief Lays out the text boxes that changed before the frame is drawn, spread over a ThreadPool.
+ *
+ * Without it, every text box is laid out lazily inside its draw, one after another on the window thread,
+ * so the first frame after the board is built (or resized) pays for all of them. Text boxes are independent,
+ * so each worker lays out whole text boxes. sf::Font isn't thread safe (it loads glyphs on first use), so every
+ * worker but the calling thread measures with its own copy of each font, loaded from the same file
+ * (the same metrics, so the same layouts).
+ */
+class LayoutPass {
+public:
+    /** @brief Starts the workers of the pass.
+     *
+     * @param numWorkers The number of workers including the calling thread, 0 for one per core.
+     */
+    explicit LayoutPass(unsigned int numWorkers = 0);
+
+    /** @brief Adds a font the text boxes use, loading a copy of it for every worker.
+     *
+     * Every font of the laid out text boxes must be added, otherwise the pass runs on the calling thread only.
+     * @param font The font, as used by the texts.
+     * @param path The file the font was loaded from.
+     * @return Whether the copies were loaded, the pass stays on the calling thread if not.
+     */
+    bool addFont(const sf::Font& font, const std::string& path);
+
+    /** @brief Lays out the text boxes that need it and waits for them.
+     *
+     * @param textBoxes The text boxes to check, they must not be drawn or changed during the pass.
+     * @return The number of text boxes laid out.
+     */
+    std::size_t run(const std::vector<const TextBox*>& textBoxes);
+
+    /** @brief Gets the number of workers, including the calling thread. */
+    unsigned int getNumWorkers() const;
+
+private:
+    //* MEMBERS
+    ThreadPool m_pool;
+    std::vector<std::unique_ptr<sf::Font>> m_fontCopies;       ///< The fonts the workers measure with.
+    std::vector<TextBox::FontSubstitutes> m_substitutes;       ///< Per worker, empty for worker 0 (the calling thread).
+    bool m_parallel;                                           ///< False once a font failed to load for the workers.
+    std::vector<const TextBox*> m_pending;                     ///< The text boxes of the current run, kept to reuse the memory.
+};
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include "LiquidationPlanner.hpp"
+
+namespace {
+    constexpr std::uint64_t NO_PLAN = std::numeric_limits<std::uint64_t>::max();
+    // a cost is the rent lost above the cash raised, so the cash only breaks the ties
+    constexpr unsigned int CASH_BITS = 32;
+    // the choice of a group that sold all its buildings and went on to mortgage, above any count of buildings
+    constexpr std::uint32_t MORTGAGE_BRANCH = std::numeric_limits<std::uint32_t>::max();
+    static_assert(std::uint64_t(BuildingEngine::HOTEL_LEVEL) * BoardDefinition::MAX_TILES < MORTGAGE_BRANCH,
+                  "a count of buildings can't be taken for the mortgage branch");
+    // a row for every tile, and two more for every group
+    constexpr std::uint64_t MAX_ROWS = BoardDefinition::MAX_TILES + 2 * std::uint64_t(BoardDefinition::NO_GROUP);
+
+    std::uint64_t getCost(unsigned int rentLost, unsigned int cash){
+        return (static_cast<std::uint64_t>(rentLost) << CASH_BITS) + cash;
+    }
+}
+
+LiquidationPlanner::LiquidationPlanner()
+    : m_numCells(0),
+      m_numRows(0),
+      m_cash(0),
+      m_rentLost(0)
+{
+}
+
+bool LiquidationPlanner::plan(const GameState& game, unsigned int player, unsigned int amount){
+    m_sales.clear();
+    m_mortgages.clear();
+    m_cash = 0;
+    m_rentLost = 0;
+    if (amount == 0) {
+        return true;
+    }
+    const BoardDefinition& board = game.getBoard();
+    const BuildingEngine& buildings = game.getBuildings();
+
+    // the groups the player holds tiles in, the most cash they can raise, and the unit it's counted in
+    m_groups.clear();
+    unsigned int unit = 0;
+    std::uint64_t total = 0;
+    for (unsigned int group = 0; group < board.getNumGroups(); group++) {
+        std::uint8_t id = static_cast<std::uint8_t>(group);
+        if (buildings.getOwnedCount(id, player) == 0) {
+            continue;
+        }
+        bool built = buildings.getMonopolyOwner(id) == static_cast<int>(player) && buildings.hasBuildings(id);
+        m_groups.push_back(GroupRows{ id, built ? buildings.getGroupBuildings(id) : 0, 0, 0 });
+        for (unsigned int tile : board.getGroupTiles(id)) {
+            const GameState::TileState& state = game.getTile(tile);
+            const GameState::TileDefinition& definition = board.getTile(tile);
+            if (built && state.buildingLevel > 0) {
+                unit = std::gcd(unit, definition.housePrice / 2);
+                total += state.buildingLevel * (definition.housePrice / 2);
+            }
+            if (state.owner == static_cast<int>(player) && !state.mortgaged && GameState::getMortgageValue(definition) > 0) {
+                unit = std::gcd(unit, GameState::getMortgageValue(definition));
+                total += GameState::getMortgageValue(definition);
+                m_groups.back().numTiles++;
+            }
+        }
+    }
+    if (unit == 0 || total < amount) {
+        return false;
+    }
+    // the cash of a plan fits below the rent lost in a cost
+    assert(total / unit < (std::uint64_t(1) << CASH_BITS));
+
+    // the last cell is the debt, or more
+    m_numCells = (amount + unit - 1) / unit + 1;
+    m_best.assign(m_numCells, NO_PLAN);
+    m_best[0] = 0;
+    m_next.resize(m_numCells);
+    m_branch.resize(m_numCells);
+    m_numRows = 0;
+    // the cells above the cash raised so far are out of reach, the rows skip them
+    unsigned int reach = 1;
+
+    for (GroupRows& rows : m_groups) {
+        const std::vector<unsigned int>& tiles = board.getGroupTiles(rows.group);
+        m_levels.resize(std::max<std::size_t>(m_levels.size(), tiles.size()));
+
+        // selling all the buildings, the first step of mortgaging the group
+        unsigned int rentLost = 0;
+        unsigned int cash = 0;
+        for (unsigned int tile : tiles) {
+            const GameState::TileDefinition& definition = board.getTile(tile);
+            unsigned int level = rows.buildings > 0 ? game.getTile(tile).buildingLevel : 0;
+            rentLost += definition.rents[level] - std::min(definition.rents[level], definition.rents[0]);
+            cash += level * (definition.housePrice / 2);
+        }
+        rows.firstRow = addRow();
+        std::fill(m_branch.begin(), m_branch.end(), NO_PLAN);
+        relax(m_best, reach, m_branch, rows.firstRow, cash / unit, getCost(rentLost, cash / unit), 1);
+        unsigned int branchReach = std::min(m_numCells, reach + cash / unit);
+
+        // then mortgaging any of its tiles, each a 0/1 item
+        for (unsigned int tile : tiles) {
+            const GameState::TileState& state = game.getTile(tile);
+            const GameState::TileDefinition& definition = board.getTile(tile);
+            unsigned int value = GameState::getMortgageValue(definition);
+            if (state.owner != static_cast<int>(player) || state.mortgaged || value == 0) {
+                continue;
+            }
+            unsigned int row = addRow();
+            m_rowTiles[row] = tile;
+            std::copy(m_branch.begin(), m_branch.begin() + branchReach, m_next.begin());
+            std::fill(m_next.begin() + branchReach, m_next.end(), NO_PLAN);
+            relax(m_branch, branchReach, m_next, row, value / unit, getCost(definition.rents[0], value / unit), 1);
+            branchReach = std::min(m_numCells, branchReach + value / unit);
+            std::swap(m_branch, m_next);
+        }
+
+        // or selling only some of the buildings, evenly
+        unsigned int groupRow = addRow();
+        m_next = m_best;
+        for (unsigned int count = 1; count < rows.buildings; count++) {
+            if (!buildings.getLevelsAfterSelling(rows.group, count, m_levels.data())) {
+                continue;
+            }
+            rentLost = 0;
+            cash = 0;
+            for (unsigned int i = 0; i < tiles.size(); i++) {
+                const GameState::TileDefinition& definition = board.getTile(tiles[i]);
+                unsigned int level = game.getTile(tiles[i]).buildingLevel;
+                rentLost += definition.rents[level] - std::min(definition.rents[level], definition.rents[m_levels[i]]);
+                cash += (level - m_levels[i]) * (definition.housePrice / 2);
+            }
+            relax(m_best, reach, m_next, groupRow, cash / unit, getCost(rentLost, cash / unit), count);
+        }
+        reach = std::max(reach, branchReach);
+        std::size_t base = getIndex(groupRow, 0);
+        for (unsigned int cell = 0; cell < reach; cell++) {
+            if (m_branch[cell] < m_next[cell]) {
+                m_next[cell] = m_branch[cell];
+                m_choices[base + cell] = MORTGAGE_BRANCH;
+                m_from[base + cell] = cell;
+            }
+        }
+        std::swap(m_best, m_next);
+    }
+
+    unsigned int cell = m_numCells - 1;
+    if (m_best[cell] == NO_PLAN) {
+        return false;
+    }
+    m_rentLost = static_cast<unsigned int>(m_best[cell] >> CASH_BITS);
+    m_cash = static_cast<unsigned int>((m_best[cell] & ((std::uint64_t(1) << CASH_BITS) - 1)) * unit);
+
+    // walk the rows back from the debt to the choices that reached it
+    for (auto rows = m_groups.rbegin(); rows != m_groups.rend(); ++rows) {
+        unsigned int groupRow = rows->firstRow + rows->numTiles + 1;
+        std::uint32_t choice = m_choices[getIndex(groupRow, cell)];
+        if (choice != MORTGAGE_BRANCH) {
+            if (choice > 0) {
+                m_sales.push_back(Sale{ rows->group, choice });
+            }
+            cell = m_from[getIndex(groupRow, cell)];
+            continue;
+        }
+        for (unsigned int row = groupRow - 1; row > rows->firstRow; row--) {
+            if (m_choices[getIndex(row, cell)] == 1) {
+                m_mortgages.push_back(m_rowTiles[row]);
+            }
+            cell = m_from[getIndex(row, cell)];
+        }
+        if (rows->buildings > 0) {
+            m_sales.push_back(Sale{ rows->group, rows->buildings });
+        }
+        cell = m_from[getIndex(rows->firstRow, cell)];
+    }
+    return true;
+}
+
+unsigned int LiquidationPlanner::addRow(){
+    unsigned int row = m_numRows++;
+    assert(m_numRows <= MAX_ROWS);
+    std::size_t size = getIndex(m_numRows, 0);
+    if (m_from.size() < size) {
+        m_from.resize(size);
+        m_choices.resize(size);
+    }
+    if (m_rowTiles.size() < m_numRows) {
+        m_rowTiles.resize(m_numRows);
+    }
+    std::size_t base = getIndex(row, 0);
+    for (unsigned int cell = 0; cell < m_numCells; cell++) {
+        m_from[base + cell] = cell;
+        m_choices[base + cell] = 0;
+    }
+    return row;
+}
+
+std::size_t LiquidationPlanner::getIndex(unsigned int row, unsigned int cell) const {
+    return static_cast<std::size_t>(row) * m_numCells + cell;
+}
+
+void LiquidationPlanner::relax(const std::vector<std::uint64_t>& from, unsigned int reach, std::vector<std::uint64_t>& to,
+                               unsigned int row, unsigned int cash, std::uint64_t cost, std::uint32_t choice){
+    std::size_t base = getIndex(row, 0);
+    unsigned int last = m_numCells - 1;
+    for (unsigned int cell = 0; cell < reach; cell++) {
+        if (from[cell] == NO_PLAN) {
+            continue;
+        }
+        unsigned int target = std::min(last, cell + cash);
+        std::uint64_t value = from[cell] + cost;
+        if (value < to[target]) {
+            to[target] = value;
+            m_from[base + target] = cell;
+            m_choices[base + target] = choice;
+        }
+    }
+}
+
+const std::vector<LiquidationPlanner::Sale>& LiquidationPlanner::getSales() const {
+    return m_sales;
+}
+
+const std::vector<unsigned int>& LiquidationPlanner::getMortgages() const {
+    return m_mortgages;
+}
+
+unsigned int LiquidationPlanner::getCash() const {
+    return m_cash;
+}
+
+unsigned int LiquidationPlanner::getRentLost() const {
+    return m_rentLost;
+}
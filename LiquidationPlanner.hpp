@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GameState.hpp"
+
+/** @class LiquidationPlanner
+ *
+ * @brief Plans how a player who owes more than they hold raises the rest, losing as little rent as possible.
+ *
+ * A player raises cash by selling buildings back to the bank (half their price, evenly within a group) and by
+ * mortgaging tiles (half the tile's price, once the group has no buildings). Every way of doing that costs the rent
+ * the tiles would have collected, and the plan is the one that covers the debt at the least rent lost, ties going to
+ * the plan that raises the least cash.
+ *
+ * It's a bounded multiple choice knapsack over the groups the player holds tiles in: a group either sells some of
+ * its buildings, or sells them all and then mortgages any of its tiles (0/1 items). The cash is counted in units of
+ * the greatest common divisor of all the amounts involved, and capped at the debt, so the table is as wide as the
+ * debt in those units (a few hundred cells on the standard board) and solving takes microseconds. The buffers are
+ * kept between the plans, so a planner that's reused (one per thread) doesn't allocate once warmed up.
+ */
+class LiquidationPlanner {
+public:
+    LiquidationPlanner();
+
+    /** @brief Selling some of the buildings of a group. */
+    struct Sale {
+        std::uint8_t group;
+        unsigned int count;        ///< Counting a hotel as BuildingEngine::HOTEL_LEVEL.
+    };
+
+    /** @brief Plans how a player raises an amount of cash from their holdings.
+     *
+     * @param game The game.
+     * @param player The index of the player.
+     * @param amount The cash to raise, on top of what the player holds.
+     * @return Whether the holdings of the player can raise it, then the plan is in getSales() and getMortgages().
+     */
+    bool plan(const GameState& game, unsigned int player, unsigned int amount);
+
+    //* Getters
+    /** @brief Gets the sales of the plan, the groups that keep all their buildings aren't listed. */
+    const std::vector<Sale>& getSales() const;
+    /** @brief Gets the tiles the plan mortgages, after the sales. */
+    const std::vector<unsigned int>& getMortgages() const;
+    /** @brief Gets the cash the plan raises, at least the amount. */
+    unsigned int getCash() const;
+    /** @brief Gets the rent the tiles of the player collect per landing that the plan gives up. */
+    unsigned int getRentLost() const;
+
+private:
+    /** @brief Where a group's choices are in the table: the sale of all its buildings, its mortgages, then its choice. */
+    struct GroupRows {
+        std::uint8_t group;
+        unsigned int buildings;    ///< The buildings of the group, all sold when the group is mortgaged.
+        unsigned int firstRow;     ///< The row of the sale of all its buildings.
+        unsigned int numTiles;     ///< The tiles that can be mortgaged, a row each after the first row.
+    };
+
+    /** @brief Starts a row of the table, every cell coming from the same cell of the previous row. */
+    unsigned int addRow();
+
+    /** @brief Gets where a cell of a row is in the table. */
+    std::size_t getIndex(unsigned int row, unsigned int cell) const;
+
+    /** @brief Relaxes the cells of a row with an option that raises cash at a cost.
+     *
+     * @param reach The cells of from that can be reached, the ones above it are all out of reach.
+     */
+    void relax(const std::vector<std::uint64_t>& from, unsigned int reach, std::vector<std::uint64_t>& to,
+               unsigned int row, unsigned int cash, std::uint64_t cost, std::uint32_t choice);
+
+    //* MEMBERS
+    unsigned int m_numCells;                  ///< The cells of a row, the last one is the debt or more.
+    std::vector<std::uint64_t> m_best;        ///< The least cost to raise the cash of every cell, so far.
+    std::vector<std::uint64_t> m_next;
+    std::vector<std::uint64_t> m_branch;      ///< The costs of the current group when all its buildings are sold.
+    std::vector<std::uint32_t> m_from;        ///< The cell every cell of every row came from.
+    std::vector<std::uint32_t> m_choices;     ///< The choice of every cell of every row, a count of buildings or 0/1.
+    unsigned int m_numRows;
+    std::vector<GroupRows> m_groups;
+    std::vector<unsigned int> m_rowTiles;     ///< The tile every mortgage row mortgages.
+    std::vector<std::uint8_t> m_levels;       ///< The levels of a group after a sale.
+
+    std::vector<Sale> m_sales;
+    std::vector<unsigned int> m_mortgages;
+    unsigned int m_cash;
+    unsigned int m_rentLost;
+};
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include "MonopolyGame.hpp"
+#include "Profiler.hpp"
 
 MonopolyGame::MonopolyGame(const sf::Vector2u& windowSize, float cornersRatio, sf::Font& font)
     : m_board(windowSize.y, cornersRatio, font) 
@@ -9,7 +11,10 @@ MonopolyGame::MonopolyGame(const sf::Vector2u& windowSize, float cornersRatio, s
 
 //! UNCOMMENT
 void MonopolyGame::setPlayersNames(std::vector<std::string> names){
-    // clear the m_players vector
+    // take the old players off the board, and clear the m_players vector
+    for (auto& player : m_players){
+        m_board.removePlayer(player);
+    }
     m_players.clear(); //! UNCOMMENT
 
     // populate m_players with Player objects using the provided names
@@ -18,6 +23,23 @@ void MonopolyGame::setPlayersNames(std::vector<std::string> names){
     }                                //! UNCOMMENT
 }
 
+void MonopolyGame::resize(float boardSize){
+    PROFILE_ZONE("MonopolyGame::resize");
+    m_board.setEdgeSize(boardSize);
+}
+
+void MonopolyGame::update(float seconds){
+    m_board.update(seconds);
+}
+
+float MonopolyGame::getBoardSize() const{
+    return m_board.getEdgeSize();
+}
+
+void MonopolyGame::collectTextBoxes(std::vector<const TextBox*>& textBoxes) const{
+    m_board.collectTextBoxes(textBoxes);
+}
+
 void MonopolyGame::startGame(){
     // set the current player to the first player
     m_currentPlayerIndex = 0; //! UNCOMMENT
@@ -133,20 +155,16 @@ void MonopolyGame::handleMouseClick(sf::Vector2i &mousePos){
     //                 setMenu(Menu::Type::EndTurn);
     //             }
     //         }else{ 
-    //             // check what StreetTile the player chose to build on
-    //             properties = currPlayer.getProperties() //TODO:IMPLEMENT
-                
-    //             // check if one of the properties has that name
-    //             for(auto& property : properties){
-    //                 if(property.getName() == buttonPressed){
-    //                     // convert the property to StreetTile
-    //                     StreetTile* streetTile = dynamic_cast<StreetTile*>(property);
-    //                     // display the menu to affirm the PropertyTile to build on, and send the property selected
-    //                     setMenu(Menu::Type::AffirmBuild, streetTile);
+    //             // the buttons are the tiles the player can build on now, kept by the game's BuildingEngine
+    //             // (getHouseSites/getHotelSites), so there is no need to go over all the player's properties
+    //             for(unsigned int tile : buildings.getHouseSites(m_currentPlayerIndex)){
+    //                 if(m_board.getTile(tile)->getName() == buttonPressed){
+    //                     // display the menu to affirm the StreetTile to build on, and send the tile selected
+    //                     setMenu(Menu::Type::AffirmBuild, m_board.getTile(tile));
     //                 }
     //             }   
-    //             // if the buttonPressed is not a property name and not "Cancel" - an error accured
-    //             throw std::invalid_argument("The buttonPressed is not a property name and not 'Cancel'");
+    //             // if the buttonPressed is not a buildable tile and not "Cancel" - an error accured
+    //             throw std::invalid_argument("The buttonPressed is not a buildable tile and not 'Cancel'");
     //         }
     //     break;
     //     // display the player is bunkrupt and his game is over: button is "End Game"
@@ -157,6 +175,55 @@ void MonopolyGame::handleMouseClick(sf::Vector2i &mousePos){
     // }
 }
 
+void MonopolyGame::applySnapshot(const GameSnapshot& snapshot){
+    PROFILE_ZONE("MonopolyGame::applySnapshot");
+    unsigned int numTiles = std::min<unsigned int>(snapshot.tiles.size(), m_board.getNumTiles());
+    if (m_shownTiles.size() != numTiles){
+        m_shownTiles.assign(numTiles, GameSnapshot::TileView{ -1, 0 });
+    }
+
+    // owners and buildings
+    for (unsigned int i = 0; i < numTiles; i++){
+        const GameSnapshot::TileView& tile = snapshot.tiles[i];
+        GameSnapshot::TileView& shown = m_shownTiles[i];
+        StreetTile* streetTile = m_board.getTile(i);
+        if (tile.owner != shown.owner){
+            bool known = tile.owner >= 0 && static_cast<unsigned int>(tile.owner) < m_players.size();
+            streetTile->setOwner(known ? &m_players[tile.owner] : nullptr);
+            shown.owner = tile.owner;
+        }
+        if (tile.buildingLevel != shown.buildingLevel){
+            streetTile->setBuildingType(static_cast<StreetTile::BuildingType>(tile.buildingLevel));
+            shown.buildingLevel = tile.buildingLevel;
+        }
+    }
+
+    // the tokens walk to the new positions, the tiles show the players standing on them once the tokens arrive
+    unsigned int numPlayers = std::min<unsigned int>(snapshot.players.size(), m_players.size());
+    m_shownPositions.resize(m_players.size(), -1);
+    for (unsigned int i = 0; i < m_players.size(); i++){
+        int position = -1;
+        if (i < numPlayers && !snapshot.players[i].bankrupt && snapshot.players[i].position < numTiles){
+            position = static_cast<int>(snapshot.players[i].position);
+        }
+        if (position == m_shownPositions[i]){
+            continue;
+        }
+        Player& player = m_players[i];
+        if (position < 0){
+            m_board.removePlayer(player);
+        } else if (snapshot.players[i].inJail){
+            m_board.movePlayerToJail(player, i);
+        } else {
+            m_board.movePlayer(player, i, player.getStreetTile(), m_board.getTile(position));
+        }
+        m_shownPositions[i] = position;
+    }
+
+    m_currentPlayerIndex = snapshot.currentPlayer;
+    m_diceSum = snapshot.lastDie1 + snapshot.lastDie2;
+}
+
 void MonopolyGame::draw(sf::RenderTarget &target, sf::RenderStates states) const{
     // draw the board(before the menu)
     target.draw(m_board, states);
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include "Player.hpp"
 #include "Board.hpp"
+#include "Simulation.hpp"
 // #include "Menu.hpp"
 
 /** @class MonopolyGame
@@ -38,6 +39,38 @@ public:
      */
     void handleMouseClick(sf::Vector2i& mousePos); 
 
+    /** @brief show a snapshot of the game published by the Simulation.
+     * 
+     * only the tiles whose owner, buildings or landing players changed since the last shown snapshot are updated,
+     * so the expensive relayout of the tiles is skipped for everything else.
+     * @param snapshot The snapshot to show.
+     */
+    void applySnapshot(const GameSnapshot& snapshot);
+
+    /** @brief advance the animations of the game, e.g. the tokens walking to their tiles.
+     * 
+     * @param seconds The time since the last update.
+     */
+    void update(float seconds);
+
+    /** @brief lay the game out again for a new board size.
+     * 
+     * this is the exact (and expensive) relayout, while a window is being resized it's cheaper to draw
+     * the current layout scaled, see getBoardSize().
+     * @param boardSize The new size of the edges of the board.
+     */
+    void resize(float boardSize);
+
+    /** @brief get the size of the edges of the board the game is laid out for. */
+    float getBoardSize() const;
+
+    /** @brief add every text box of the game to a list, so a LayoutPass can lay them out before drawing.
+     * 
+     * the text boxes live as long as the game, so the list can be collected once.
+     * @param textBoxes The list to add to.
+     */
+    void collectTextBoxes(std::vector<const TextBox*>& textBoxes) const;
+
 private:
     
     /** @brief draw the game to the render target.
@@ -79,4 +112,9 @@ private:
         // the sum of the dice in the current roll
         unsigned int m_diceSum; //! UNCOMMENT
 
+        // the tiles as shown by the last applied snapshot
+        std::vector<GameSnapshot::TileView> m_shownTiles;
+        // the position of each player as shown by the last applied snapshot (-1 when not on the board)
+        std::vector<int> m_shownPositions;
+
 };
\ No newline at end of file
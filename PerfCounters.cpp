@@ -0,0 +1,122 @@
+#include <chrono>
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::uint64_t nowNs(){
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+#ifdef __linux__
+    // the type and config of every event, in the order of PerfCounters::Event
+    struct EventConfig {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    constexpr std::uint64_t cacheReadMisses(std::uint64_t cache){
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    const EventConfig EVENT_CONFIGS[PerfCounters::NUM_EVENTS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int openEvent(const EventConfig& event){
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = event.type;
+        attributes.config = event.config;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // this thread, on any cpu
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+#endif
+}
+
+PerfCounters::Reading PerfCounters::Reading::operator-(const Reading& start) const {
+    Reading difference;
+    difference.wallNs = wallNs - start.wallNs;
+    for (unsigned int event = 0; event < NUM_EVENTS; event++) {
+        difference.counts[event] = counts[event] - start.counts[event];
+    }
+    return difference;
+}
+
+PerfCounters::Reading& PerfCounters::Reading::operator+=(const Reading& other){
+    wallNs += other.wallNs;
+    for (unsigned int event = 0; event < NUM_EVENTS; event++) {
+        counts[event] += other.counts[event];
+    }
+    return *this;
+}
+
+PerfCounters::PerfCounters(){
+    for (unsigned int event = 0; event < NUM_EVENTS; event++) {
+#ifdef __linux__
+        m_fds[event] = openEvent(EVENT_CONFIGS[event]);
+#else
+        m_fds[event] = -1;
+#endif
+    }
+}
+
+PerfCounters::~PerfCounters(){
+#ifdef __linux__
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+PerfCounters::Reading PerfCounters::read() const {
+    Reading reading;
+    reading.wallNs = nowNs();
+    for (unsigned int event = 0; event < NUM_EVENTS; event++) {
+        reading.counts[event] = 0;
+#ifdef __linux__
+        // the count, and the time the event was enabled and counting, to scale it up when multiplexed
+        std::uint64_t values[3];
+        if (m_fds[event] >= 0 && ::read(m_fds[event], values, sizeof(values)) == sizeof(values)) {
+            reading.counts[event] = values[2] > 0 && values[2] < values[1]
+                ? static_cast<std::uint64_t>(static_cast<double>(values[0]) * values[1] / values[2])
+                : values[0];
+        }
+#endif
+    }
+    return reading;
+}
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PerfCounters::isAvailable(Event event) const {
+    return m_fds[event] >= 0;
+}
+
+const char* PerfCounters::getEventName(Event event){
+    static const char* const names[NUM_EVENTS] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+    return names[event];
+}
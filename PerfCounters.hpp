@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+/** @class PerfCounters
+ *
+ * @brief Counts the cycles, instructions, cache misses and branch misses of the calling thread with perf_event_open.
+ *
+ * The counters are opened for the thread that creates the object and count only it, in user space (which a
+ * perf_event_paranoid of up to 2 allows). A region is measured by reading before and after it and taking the
+ * difference. Every event is opened on its own, so an event the CPU or the kernel lacks is just missing; on a
+ * system without perf events (not Linux, a container that blocks the syscall) none is available and a Reading
+ * only holds the wall clock. When the kernel multiplexes more events than the CPU has counters, the counts are
+ * scaled by the share of the time they were counting.
+ */
+class PerfCounters {
+public:
+    /** @enum Event
+     *  @brief The events counted.
+     */
+    enum Event : unsigned int { Cycles, Instructions, L1DataMisses, LastLevelMisses, BranchMisses, NUM_EVENTS };
+
+    /** @brief The counts since the counters were opened, or between two readings. */
+    struct Reading {
+        std::uint64_t wallNs;
+        std::uint64_t counts[NUM_EVENTS];
+
+        /** @brief Gets the counts between an earlier reading and this one. */
+        Reading operator-(const Reading& start) const;
+        /** @brief Adds the counts of another region. */
+        Reading& operator+=(const Reading& other);
+    };
+
+    /** @brief Opens the counters of the calling thread. */
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /** @brief Reads the counters, must be called from the thread that created them. */
+    Reading read() const;
+
+    /** @brief Checks if any event could be opened. */
+    bool isAvailable() const;
+
+    /** @brief Checks if an event could be opened, its counts are 0 otherwise. */
+    bool isAvailable(Event event) const;
+
+    /** @brief Gets the short name of an event, e.g. "cycles". */
+    static const char* getEventName(Event event);
+
+private:
+    //* MEMBERS
+    int m_fds[NUM_EVENTS];      ///< -1 for the events that couldn't be opened.
+};
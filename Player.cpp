@@ -40,17 +40,14 @@ unsigned int Player::getMoney() const
     return m_money;
 }
 
-void Player::deductMoney(unsigned int amount)
+bool Player::deductMoney(unsigned int amount)
 {
-    if (amount >= m_money)
+    if (amount > m_money)
     {
-        m_money = 0;
-        // Handle bankruptcy if necessary
-    }
-    else
-    {
-        m_money -= amount;
+        return false;
     }
+    m_money -= amount;
+    return true;
 }
 
 void Player::addMoney(unsigned int amount)
@@ -72,3 +69,12 @@ void Player::addProperty(StreetTile* property)
 {
     m_ownedStreetTiles.push_back(property);
 }
+
+const sf::Color& Player::getSeatColor(unsigned int seat)
+{
+    static const sf::Color colors[] = {
+        sf::Color(220, 40, 40), sf::Color(40, 90, 220), sf::Color(30, 160, 60), sf::Color(230, 160, 20),
+        sf::Color(150, 50, 200), sf::Color(20, 180, 190), sf::Color(120, 80, 40), sf::Color(60, 60, 60)
+    };
+    return colors[seat % (sizeof(colors) / sizeof(colors[0]))];
+}
@@ -51,11 +51,14 @@ public:
      */
     unsigned int getMoney() const;
 
-    /** @brief Deducts a specified amount of money from the player.
+    /** @brief Deducts a specified amount of money from the player, if they have it.
      *
+     *  a debt the player can't pay is resolved by the game (selling buildings, mortgaging, or bankruptcy, see
+     *  GameState::pay), so the money is never clamped here.
      *  @param amount The amount to deduct.
+     *  @return True if the amount was deducted, false if the player has less and nothing was deducted.
      */
-    void deductMoney(unsigned int amount);
+    bool deductMoney(unsigned int amount);
 
     /** @brief Adds a specified amount of money to the player.
      *
@@ -81,6 +84,12 @@ public:
      */
     void addProperty(StreetTile* property);
 
+    /** @brief Gets the color of the token of the player in a seat, the same everywhere the players are drawn.
+     *
+     *  @param seat The index of the player in the game.
+     */
+    static const sf::Color& getSeatColor(unsigned int seat);
+
 private:
     //* MEMBERS
     std::string m_name;                          ///< Name of the player.
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include "Profiler.hpp"
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+namespace {
+    // guards the registry of the ring buffers and their names
+    std::mutex g_registryMutex;
+
+    // writes a string as a JSON string literal
+    void writeJsonString(std::ostream& out, const std::string& text){
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << ' ';
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+}
+
+void Profiler::setEnabled(bool enabled){
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const std::string& name){
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    buffer.name = name;
+}
+
+std::uint64_t Profiler::now(){
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record(const char* name, std::uint64_t startNs, std::uint64_t durationNs){
+    ThreadBuffer& buffer = getThreadBuffer();
+    // announce the slot before overwriting it, readers check the announcement after copying to drop it
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.writing.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event& event = buffer.events[head % RING_CAPACITY];
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(durationNs, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<Profiler::ZoneStats> Profiler::collectStats(std::uint64_t sinceNs){
+    std::unordered_map<std::string, ZoneStats> byName;
+    std::vector<EventCopy> events;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (const auto& buffer : getThreadBuffers()) {
+            copyEvents(*buffer, events);
+        }
+    }
+    for (const auto& event : events) {
+        if (event.startNs < sinceNs) {
+            continue;
+        }
+        auto inserted = byName.emplace(event.name, ZoneStats{ event.name, 0, 0, 0 });
+        ZoneStats& stats = inserted.first->second;
+        stats.count++;
+        stats.totalNs += event.durationNs;
+        stats.maxNs = std::max(stats.maxNs, event.durationNs);
+    }
+
+    std::vector<ZoneStats> result;
+    result.reserve(byName.size());
+    for (auto& entry : byName) {
+        result.push_back(std::move(entry.second));
+    }
+    std::sort(result.begin(), result.end(), [](const ZoneStats& a, const ZoneStats& b){ return a.totalNs > b.totalNs; });
+    return result;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path){
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    std::vector<EventCopy> events;
+    bool first = true;
+    auto separate = [&]{
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    // times in the trace are microseconds, relative to the first zone
+    std::uint64_t originNs = UINT64_MAX;
+    for (const auto& buffer : getThreadBuffers()) {
+        events.clear();
+        copyEvents(*buffer, events);
+        for (const auto& event : events) {
+            originNs = std::min(originNs, event.startNs);
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const auto& buffer : getThreadBuffers()) {
+        separate();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->name.empty() ? "thread " + std::to_string(buffer->threadId) : buffer->name);
+        out << "}}";
+
+        events.clear();
+        copyEvents(*buffer, events);
+        for (const auto& event : events) {
+            separate();
+            out << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << (event.startNs - originNs) / 1000.0
+                << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer(){
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        auto& buffers = getThreadBuffers();
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        buffer->threadId = static_cast<std::uint32_t>(buffers.size());
+    }
+    return *buffer;
+}
+
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>>& Profiler::getThreadBuffers(){
+    // never destroyed, so threads that record during static destruction still find it
+    static auto* buffers = new std::vector<std::unique_ptr<ThreadBuffer>>();
+    return *buffers;
+}
+
+void Profiler::copyEvents(const ThreadBuffer& buffer, std::vector<EventCopy>& events){
+    std::uint64_t end = buffer.head.load(std::memory_order_acquire);
+    std::uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+    std::size_t firstCopied = events.size();
+    for (std::uint64_t i = begin; i < end; i++) {
+        const Event& event = buffer.events[i % RING_CAPACITY];
+        events.push_back(EventCopy{ event.name.load(std::memory_order_relaxed),
+                                    event.startNs.load(std::memory_order_relaxed),
+                                    event.durationNs.load(std::memory_order_relaxed) });
+    }
+
+    // the writer may have lapped the oldest zones while they were copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t writing = buffer.writing.load(std::memory_order_relaxed);
+    std::uint64_t overwritten = writing > RING_CAPACITY ? writing - RING_CAPACITY : 0;
+    if (overwritten > begin) {
+        std::size_t drop = static_cast<std::size_t>(std::min(overwritten - begin, end - begin));
+        events.erase(events.begin() + firstCopied, events.begin() + firstCopied + drop);
+    }
+}
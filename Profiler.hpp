@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** @brief Times the rest of the enclosing scope as a profiler zone named by a string literal.
+ *
+ * Costs one relaxed atomic load while the profiler is disabled,
+ * and nothing at all when compiled with MONOPOLY_NO_PROFILER.
+ */
+#ifdef MONOPOLY_NO_PROFILER
+#define PROFILE_ZONE(name) ((void)0)
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#endif
+
+/** @class Profiler
+ *
+ * @brief Records timed zones of every thread, for the overlay and for Chrome's trace viewer.
+ *
+ * Every thread records into its own ring buffer, so recording takes no lock and the newest
+ * RING_CAPACITY zones of each thread are kept. The rings can be read from any thread while
+ * they are written; a zone overwritten during the read is dropped from the result.
+ */
+class Profiler {
+public:
+    /** @brief The number of zones kept per thread. */
+    static constexpr std::size_t RING_CAPACITY = 1 << 16;
+
+    /** @brief The zones of one name, summed over every thread. */
+    struct ZoneStats {
+        std::string name;
+        std::uint64_t count;       ///< The number of times the zone ran.
+        std::uint64_t totalNs;     ///< The time spent in the zone.
+        std::uint64_t maxNs;       ///< The longest run of the zone.
+    };
+
+    /** @class Zone
+     * @brief Records the time between its construction and destruction, use PROFILE_ZONE to create one.
+     */
+    class Zone {
+    public:
+        explicit Zone(const char* name)
+            : m_name(name),
+              m_active(isEnabled()),
+              m_startNs(m_active ? now() : 0)
+        {
+        }
+
+        ~Zone(){
+            if (m_active) {
+                record(m_name, m_startNs, now() - m_startNs);
+            }
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* m_name;
+        bool m_active;
+        std::uint64_t m_startNs;
+    };
+
+    /** @brief Starts or stops recording zones (stopped by default). */
+    static void setEnabled(bool enabled);
+
+    /** @brief Whether zones are recorded. */
+    static bool isEnabled(){
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Names the calling thread in the exported trace. */
+    static void setThreadName(const std::string& name);
+
+    /** @brief Gets the time of the profiler's clock, in nanoseconds. */
+    static std::uint64_t now();
+
+    /** @brief Records a zone of the calling thread.
+     *
+     * @param name The name of the zone, must outlive the profiler (e.g. a string literal).
+     * @param startNs The start of the zone, from now().
+     * @param durationNs The duration of the zone.
+     */
+    static void record(const char* name, std::uint64_t startNs, std::uint64_t durationNs);
+
+    /** @brief Sums the recorded zones that started at or after sinceNs, by name.
+     *
+     * @return The stats of every zone name, the most total time first.
+     */
+    static std::vector<ZoneStats> collectStats(std::uint64_t sinceNs);
+
+    /** @brief Writes every recorded zone to a Chrome trace JSON file (chrome://tracing, Perfetto).
+     *
+     * @param path The path of the file to write.
+     * @return Whether the file was written.
+     */
+    static bool exportChromeTrace(const std::string& path);
+
+private:
+    /** @brief A recorded zone. The fields are atomic since another thread may read the ring while it's written. */
+    struct Event {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> startNs{0};
+        std::atomic<std::uint64_t> durationNs{0};
+    };
+
+    /** @brief A copy of a recorded zone. */
+    struct EventCopy {
+        const char* name;
+        std::uint64_t startNs;
+        std::uint64_t durationNs;
+    };
+
+    /** @brief The ring buffer of one thread, kept after the thread exits so its zones can still be exported. */
+    struct ThreadBuffer {
+        std::uint32_t threadId = 0;
+        std::string name;                     ///< Guarded by the registry's mutex.
+        std::atomic<std::uint64_t> head{0};   ///< The number of zones ever recorded by the thread.
+        std::atomic<std::uint64_t> writing{0};///< head + 1 while a zone is being written, so readers can drop it.
+        std::unique_ptr<Event[]> events{new Event[RING_CAPACITY]};
+    };
+
+    /** @brief Gets the ring buffer of the calling thread, registering it on first use. */
+    static ThreadBuffer& getThreadBuffer();
+
+    /** @brief Gets the ring buffers of every thread that ever recorded a zone, guarded by a mutex in Profiler.cpp. */
+    static std::vector<std::unique_ptr<ThreadBuffer>>& getThreadBuffers();
+
+    /** @brief Copies the zones of a ring that were not overwritten while copying. */
+    static void copyEvents(const ThreadBuffer& buffer, std::vector<EventCopy>& events);
+
+    //* MEMBERS
+    static std::atomic<bool> s_enabled;
+};
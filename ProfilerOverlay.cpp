@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdio>
+#include "Profiler.hpp"
+#include "ProfilerOverlay.hpp"
+
+namespace {
+    // how often the zone table is rebuilt
+    constexpr std::uint64_t REFRESH_INTERVAL_NS = 250000000;
+    // the height of the frame time graph, and the frame time at its top
+    constexpr float GRAPH_HEIGHT = 120.f;
+    constexpr float GRAPH_MAX_US = 33333.f;
+    constexpr float FRAME_BUDGET_US = 16667.f;
+    // the most zones listed in the table
+    constexpr std::size_t MAX_TABLE_ROWS = 24;
+    constexpr unsigned int TABLE_CHARACTER_SIZE = 13;
+}
+
+ProfilerOverlay::ProfilerOverlay(const sf::FloatRect& bounds, const sf::Font& font)
+    : m_bounds(bounds),
+      m_graph(sf::Quads, FRAME_HISTORY * 4),
+      m_budgetLine(sf::Lines, 2),
+      m_frameTimes(FRAME_HISTORY, 0),
+      m_nextFrame(0),
+      m_framesSinceRefresh(0),
+      m_lastRefreshNs(Profiler::now())
+{
+    m_background.setPosition(bounds.left, bounds.top);
+    m_background.setSize(sf::Vector2f(bounds.width, bounds.height));
+    m_background.setFillColor(sf::Color(20, 20, 20));
+
+    m_table.setFont(font);
+    m_table.setCharacterSize(TABLE_CHARACTER_SIZE);
+    m_table.setFillColor(sf::Color::White);
+    m_table.setPosition(bounds.left + 8.f, bounds.top + GRAPH_HEIGHT + 16.f);
+
+    float budgetY = bounds.top + 8.f + GRAPH_HEIGHT * (1.f - FRAME_BUDGET_US / GRAPH_MAX_US);
+    m_budgetLine[0] = sf::Vertex(sf::Vector2f(bounds.left + 8.f, budgetY), sf::Color::Red);
+    m_budgetLine[1] = sf::Vertex(sf::Vector2f(bounds.left + bounds.width - 8.f, budgetY), sf::Color::Red);
+}
+
+void ProfilerOverlay::addFrame(std::int64_t frameUs){
+    m_frameTimes[m_nextFrame] = frameUs;
+    m_nextFrame = (m_nextFrame + 1) % FRAME_HISTORY;
+    m_framesSinceRefresh++;
+    refreshGraph();
+
+    if (Profiler::now() - m_lastRefreshNs >= REFRESH_INTERVAL_NS) {
+        refreshTable();
+    }
+}
+
+void ProfilerOverlay::addCount(const char* name, std::uint64_t count){
+    for (auto& counter : m_counts) {
+        if (counter.first == name) {
+            counter.second += count;
+            return;
+        }
+    }
+    m_counts.emplace_back(name, count);
+}
+
+void ProfilerOverlay::refreshTable(){
+    PROFILE_ZONE("ProfilerOverlay::refreshTable");
+    std::uint64_t nowNs = Profiler::now();
+    std::vector<Profiler::ZoneStats> stats = Profiler::collectStats(m_lastRefreshNs);
+    double frames = static_cast<double>(std::max<std::uint64_t>(1, m_framesSinceRefresh));
+
+    std::int64_t worstUs = *std::max_element(m_frameTimes.begin(), m_frameTimes.end());
+    std::int64_t totalUs = 0;
+    for (std::int64_t frameUs : m_frameTimes) {
+        totalUs += frameUs;
+    }
+
+    char line[128];
+    std::string table;
+    std::snprintf(line, sizeof(line), "frame avg %.2f ms  worst %.2f ms\n\n",
+                  totalUs / 1000.0 / FRAME_HISTORY, worstUs / 1000.0);
+    table += line;
+    for (auto& counter : m_counts) {
+        std::snprintf(line, sizeof(line), "%s  %.1f/frame\n", counter.first, counter.second / frames);
+        table += line;
+        counter.second = 0;
+    }
+    if (!m_counts.empty()) {
+        table += "\n";
+    }
+    table += Profiler::isEnabled() ? "zone  calls/frame  ms/frame  max us\n" : "profiler disabled (F3)\n";
+    for (std::size_t i = 0; i < stats.size() && i < MAX_TABLE_ROWS; i++) {
+        std::snprintf(line, sizeof(line), "%s  %.1f  %.3f  %.0f\n", stats[i].name.c_str(),
+                      stats[i].count / frames, stats[i].totalNs / 1e6 / frames, stats[i].maxNs / 1e3);
+        table += line;
+    }
+    m_table.setString(table);
+
+    m_lastRefreshNs = nowNs;
+    m_framesSinceRefresh = 0;
+}
+
+void ProfilerOverlay::refreshGraph(){
+    float left = m_bounds.left + 8.f;
+    float bottom = m_bounds.top + 8.f + GRAPH_HEIGHT;
+    float barWidth = (m_bounds.width - 16.f) / FRAME_HISTORY;
+    // the oldest frame on the left
+    for (std::size_t i = 0; i < FRAME_HISTORY; i++) {
+        std::int64_t frameUs = m_frameTimes[(m_nextFrame + i) % FRAME_HISTORY];
+        float height = GRAPH_HEIGHT * std::min(1.f, frameUs / GRAPH_MAX_US);
+        sf::Color color = frameUs > FRAME_BUDGET_US ? sf::Color(230, 80, 60) : sf::Color(90, 200, 90);
+        float x = left + i * barWidth;
+        m_graph[i * 4 + 0] = sf::Vertex(sf::Vector2f(x, bottom - height), color);
+        m_graph[i * 4 + 1] = sf::Vertex(sf::Vector2f(x + barWidth, bottom - height), color);
+        m_graph[i * 4 + 2] = sf::Vertex(sf::Vector2f(x + barWidth, bottom), color);
+        m_graph[i * 4 + 3] = sf::Vertex(sf::Vector2f(x, bottom), color);
+    }
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const{
+    target.draw(m_background, states);
+    target.draw(m_graph, states);
+    target.draw(m_budgetLine, states);
+    target.draw(m_table, states);
+}
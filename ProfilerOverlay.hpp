@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @class ProfilerOverlay
+ *
+ * @brief Shows the frame times and the hottest Profiler zones in a panel beside the board.
+ *
+ * The panel holds a graph of the last frame times and a table of the zones recorded over the last
+ * refresh interval, per frame. The table is rebuilt a few times a second, not every frame,
+ * so the overlay itself barely shows up in the numbers it displays.
+ */
+class ProfilerOverlay : public sf::Drawable {
+public:
+    /** @brief The number of frames in the frame time graph. */
+    static constexpr std::size_t FRAME_HISTORY = 240;
+
+    /** @brief Creates the overlay in the given bounds.
+     *
+     * @param bounds The bounds of the panel in the window.
+     * @param font The font of the table.
+     */
+    ProfilerOverlay(const sf::FloatRect& bounds, const sf::Font& font);
+
+    /** @brief Adds the time of a frame to the graph, and refreshes the table when it's due.
+     *
+     * @param frameUs The time of the frame, in microseconds.
+     */
+    void addFrame(std::int64_t frameUs);
+
+    /** @brief Adds to a counter listed per frame above the zone table, e.g. the text box updates of a frame.
+     *
+     * @param name The name of the counter, a string literal.
+     * @param count The count to add.
+     */
+    void addCount(const char* name, std::uint64_t count);
+
+private:
+    /** @brief Rebuilds the table from the zones recorded since the last refresh. */
+    void refreshTable();
+
+    /** @brief Rebuilds the vertices of the frame time graph. */
+    void refreshGraph();
+
+    /** @brief draw the overlay to the render target.
+     *
+     * this functions is of the sf::Drawable interface.
+    */
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    //* MEMBERS
+    sf::FloatRect m_bounds;
+    sf::RectangleShape m_background;
+    sf::Text m_table;                       ///< The zone table, one line per zone.
+    sf::VertexArray m_graph;                ///< One bar per frame, as quads.
+    sf::VertexArray m_budgetLine;           ///< The 60 FPS frame budget.
+    std::vector<std::int64_t> m_frameTimes; ///< A ring of the last FRAME_HISTORY frame times.
+    std::size_t m_nextFrame;                ///< The slot of the next frame in m_frameTimes.
+    std::uint64_t m_framesSinceRefresh;
+    std::uint64_t m_lastRefreshNs;          ///< Profiler::now() at the last refresh.
+    std::vector<std::pair<const char*, std::uint64_t>> m_counts;  ///< The counters, since the last refresh.
+};
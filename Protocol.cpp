@@ -0,0 +1,471 @@
+#include <cstring>
+#include "Protocol.hpp"
+
+namespace Protocol {
+
+//* Writer
+Writer::Writer(std::vector<std::uint8_t>& buffer)
+    : m_buffer(buffer), m_frameStart(0)
+{
+}
+
+void Writer::u8(std::uint8_t value){
+    m_buffer.push_back(value);
+}
+
+void Writer::u16(std::uint16_t value){
+    m_buffer.push_back(static_cast<std::uint8_t>(value));
+    m_buffer.push_back(static_cast<std::uint8_t>(value >> 8));
+}
+
+void Writer::u32(std::uint32_t value){
+    for (int i = 0; i < 4; i++) {
+        m_buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Writer::u64(std::uint64_t value){
+    for (int i = 0; i < 8; i++) {
+        m_buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Writer::f64(double value){
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u64(bits);
+}
+
+void Writer::bytes(const std::uint8_t* data, std::size_t size){
+    m_buffer.insert(m_buffer.end(), data, data + size);
+}
+
+void Writer::beginFrame(MessageType type){
+    m_frameStart = m_buffer.size();
+    u16(0); // patched by endFrame
+    u8(static_cast<std::uint8_t>(type));
+}
+
+void Writer::endFrame(){
+    std::size_t payloadSize = m_buffer.size() - m_frameStart - HEADER_SIZE;
+    m_buffer[m_frameStart] = static_cast<std::uint8_t>(payloadSize);
+    m_buffer[m_frameStart + 1] = static_cast<std::uint8_t>(payloadSize >> 8);
+}
+
+//* Reader
+Reader::Reader(const std::uint8_t* data, std::size_t size)
+    : m_data(data), m_size(size), m_offset(0), m_ok(true)
+{
+}
+
+bool Reader::has(std::size_t n){
+    if (m_offset + n > m_size) {
+        m_ok = false;
+    }
+    return m_ok;
+}
+
+std::uint8_t Reader::u8(){
+    if (!has(1)) {
+        return 0;
+    }
+    return m_data[m_offset++];
+}
+
+std::uint16_t Reader::u16(){
+    if (!has(2)) {
+        return 0;
+    }
+    std::uint16_t value = static_cast<std::uint16_t>(m_data[m_offset] | (m_data[m_offset + 1] << 8));
+    m_offset += 2;
+    return value;
+}
+
+std::uint32_t Reader::u32(){
+    if (!has(4)) {
+        return 0;
+    }
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<std::uint32_t>(m_data[m_offset + i]) << (8 * i);
+    }
+    m_offset += 4;
+    return value;
+}
+
+std::uint64_t Reader::u64(){
+    if (!has(8)) {
+        return 0;
+    }
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<std::uint64_t>(m_data[m_offset + i]) << (8 * i);
+    }
+    m_offset += 8;
+    return value;
+}
+
+double Reader::f64(){
+    std::uint64_t bits = u64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void Reader::bytes(std::uint8_t* data, std::size_t size){
+    if (!has(size)) {
+        std::memset(data, 0, size);
+        return;
+    }
+    std::memcpy(data, m_data + m_offset, size);
+    m_offset += size;
+}
+
+bool Reader::ok() const {
+    return m_ok;
+}
+
+//* ENCODING
+void encode(std::vector<std::uint8_t>& out, const Hello& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Hello);
+    w.u16(message.version);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Welcome& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Welcome);
+    w.u16(message.version);
+    w.u16(message.shardCount);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const CreateGame& message){
+    Writer w(out);
+    w.beginFrame(MessageType::CreateGame);
+    w.u32(message.requestId);
+    w.u8(message.numPlayers);
+    w.u64(message.seed);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const GameCreated& message){
+    Writer w(out);
+    w.beginFrame(MessageType::GameCreated);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Action& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Action);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.u8(message.player);
+    w.u8(message.action);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const ActionResult& message){
+    Writer w(out);
+    w.beginFrame(MessageType::ActionResult);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.u8(message.status);
+    w.u8(message.phase);
+    w.u8(message.currentPlayer);
+    w.u8(message.die1);
+    w.u8(message.die2);
+    w.u8(message.position);
+    w.u32(message.money);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const CloseGame& message){
+    Writer w(out);
+    w.beginFrame(MessageType::CloseGame);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const GameClosed& message){
+    Writer w(out);
+    w.beginFrame(MessageType::GameClosed);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Spectate& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Spectate);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Keyframe& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Keyframe);
+    w.u32(message.gameId);
+    w.u32(message.keyframeId);
+    w.u8(message.currentPlayer);
+    w.u8(static_cast<std::uint8_t>(message.players.size()));
+    for (const auto& player : message.players) {
+        w.u32(player.money);
+        w.u16(player.position);
+    }
+    w.u16(static_cast<std::uint16_t>(message.tiles.size()));
+    for (const auto& tile : message.tiles) {
+        w.u8(tile.owner);
+        w.u8(tile.buildingLevel);
+    }
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Delta& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Delta);
+    w.u32(message.gameId);
+    w.u32(message.keyframeId);
+    w.u32(message.sequence);
+    w.u8(message.currentPlayer);
+    w.u8(static_cast<std::uint8_t>(message.players.size()));
+    for (const auto& player : message.players) {
+        w.u8(player.first);
+        w.u32(player.second.money);
+        w.u16(player.second.position);
+    }
+    w.u16(static_cast<std::uint16_t>(message.tiles.size()));
+    for (const auto& tile : message.tiles) {
+        w.u16(tile.first);
+        w.u8(tile.second.owner);
+        w.u8(tile.second.buildingLevel);
+    }
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const AckKeyframe& message){
+    Writer w(out);
+    w.beginFrame(MessageType::AckKeyframe);
+    w.u32(message.gameId);
+    w.u32(message.keyframeId);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const TileAction& message){
+    Writer w(out);
+    w.beginFrame(MessageType::TileAction);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.u8(message.player);
+    w.u8(message.action);
+    w.u16(message.tile);
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const Trade& message){
+    Writer w(out);
+    w.beginFrame(MessageType::Trade);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.u8(message.player);
+    w.u8(message.partner);
+    w.u8(message.numGiven);
+    for (unsigned int i = 0; i < message.numGiven && i < MAX_TRADE_TILES; i++) {
+        w.u16(message.given[i]);
+    }
+    w.u8(message.numTaken);
+    for (unsigned int i = 0; i < message.numTaken && i < MAX_TRADE_TILES; i++) {
+        w.u16(message.taken[i]);
+    }
+    w.u32(static_cast<std::uint32_t>(message.cash));
+    w.endFrame();
+}
+
+void encode(std::vector<std::uint8_t>& out, const BotAction& message){
+    Writer w(out);
+    w.beginFrame(MessageType::BotAction);
+    w.u32(message.requestId);
+    w.u32(message.gameId);
+    w.u8(message.player);
+    w.endFrame();
+}
+
+//* DECODING
+bool decode(Reader& in, Hello& message){
+    message.version = in.u16();
+    return in.ok();
+}
+
+bool decode(Reader& in, Welcome& message){
+    message.version = in.u16();
+    message.shardCount = in.u16();
+    return in.ok();
+}
+
+bool decode(Reader& in, CreateGame& message){
+    message.requestId = in.u32();
+    message.numPlayers = in.u8();
+    message.seed = in.u64();
+    return in.ok();
+}
+
+bool decode(Reader& in, GameCreated& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, Action& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    message.player = in.u8();
+    message.action = in.u8();
+    return in.ok();
+}
+
+bool decode(Reader& in, ActionResult& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    message.status = in.u8();
+    message.phase = in.u8();
+    message.currentPlayer = in.u8();
+    message.die1 = in.u8();
+    message.die2 = in.u8();
+    message.position = in.u8();
+    message.money = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, CloseGame& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, GameClosed& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, Spectate& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, Keyframe& message){
+    message.gameId = in.u32();
+    message.keyframeId = in.u32();
+    message.currentPlayer = in.u8();
+    message.players.resize(in.u8());
+    for (auto& player : message.players) {
+        player.money = in.u32();
+        player.position = in.u16();
+    }
+    message.tiles.resize(in.u16());
+    for (auto& tile : message.tiles) {
+        tile.owner = in.u8();
+        tile.buildingLevel = in.u8();
+    }
+    return in.ok();
+}
+
+bool decode(Reader& in, Delta& message){
+    message.gameId = in.u32();
+    message.keyframeId = in.u32();
+    message.sequence = in.u32();
+    message.currentPlayer = in.u8();
+    message.players.resize(in.u8());
+    for (auto& player : message.players) {
+        player.first = in.u8();
+        player.second.money = in.u32();
+        player.second.position = in.u16();
+    }
+    message.tiles.resize(in.u16());
+    for (auto& tile : message.tiles) {
+        tile.first = in.u16();
+        tile.second.owner = in.u8();
+        tile.second.buildingLevel = in.u8();
+    }
+    return in.ok();
+}
+
+bool decode(Reader& in, AckKeyframe& message){
+    message.gameId = in.u32();
+    message.keyframeId = in.u32();
+    return in.ok();
+}
+
+bool decode(Reader& in, TileAction& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    message.player = in.u8();
+    message.action = in.u8();
+    message.tile = in.u16();
+    return in.ok();
+}
+
+bool decode(Reader& in, Trade& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    message.player = in.u8();
+    message.partner = in.u8();
+    message.numGiven = in.u8();
+    if (message.numGiven > MAX_TRADE_TILES) {
+        return false;
+    }
+    for (unsigned int i = 0; i < message.numGiven; i++) {
+        message.given[i] = in.u16();
+    }
+    message.numTaken = in.u8();
+    if (message.numTaken > MAX_TRADE_TILES) {
+        return false;
+    }
+    for (unsigned int i = 0; i < message.numTaken; i++) {
+        message.taken[i] = in.u16();
+    }
+    message.cash = static_cast<std::int32_t>(in.u32());
+    return in.ok();
+}
+
+bool decode(Reader& in, BotAction& message){
+    message.requestId = in.u32();
+    message.gameId = in.u32();
+    message.player = in.u8();
+    return in.ok();
+}
+
+//* FrameDecoder
+void FrameDecoder::feed(const std::uint8_t* data, std::size_t size){
+    // drop the consumed prefix before growing the buffer
+    if (m_offset > 0) {
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_offset);
+        m_offset = 0;
+    }
+    m_buffer.insert(m_buffer.end(), data, data + size);
+}
+
+bool FrameDecoder::next(MessageType& type, const std::uint8_t*& payload, std::size_t& payloadSize){
+    std::size_t available = m_buffer.size() - m_offset;
+    if (available < HEADER_SIZE) {
+        return false;
+    }
+    const std::uint8_t* header = m_buffer.data() + m_offset;
+    std::size_t length = static_cast<std::size_t>(header[0] | (header[1] << 8));
+    if (available < HEADER_SIZE + length) {
+        return false;
+    }
+    type = static_cast<MessageType>(header[2]);
+    payload = header + HEADER_SIZE;
+    payloadSize = length;
+    m_offset += HEADER_SIZE + length;
+    return true;
+}
+
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @namespace Protocol
+ *
+ * @brief The compact binary protocol spoken between the GameServer and its clients.
+ *
+ * Every message is a frame of a 3 bytes header (payload length as a little endian u16, followed by
+ * the message type as a u8) and a payload of fixed width little endian fields.
+ * A client starts with Hello and may then create games and send actions of any of its games: the actions of a turn,
+ * building, selling, mortgaging and redeeming on a tile, trades, or the next action of the server's bot.
+ * Requests carry a requestId that is echoed in the reply, replies of one game arrive in order.
+ */
+namespace Protocol {
+    /** @brief The version of the protocol, exchanged in Hello/Welcome. */
+    constexpr std::uint16_t VERSION = 2;
+
+    /** @brief The size of a frame header: u16 payload length + u8 message type. */
+    constexpr std::size_t HEADER_SIZE = 3;
+
+    /** @brief The status sent in an ActionResult when the game does not exist (anymore). */
+    constexpr std::uint8_t STATUS_UNKNOWN_GAME = 0xFF;
+
+    /** @brief The most tiles going each way in a Trade, GameState::TradeOffer::MAX_TILES. */
+    constexpr std::size_t MAX_TRADE_TILES = 4;
+
+    /** @enum MessageType
+     *  @brief The type byte of a frame.
+     */
+    enum class MessageType : std::uint8_t {
+        Hello = 1,      ///< client -> server
+        Welcome,        ///< server -> client
+        CreateGame,     ///< client -> server
+        GameCreated,    ///< server -> client
+        Action,         ///< client -> server
+        ActionResult,   ///< server -> client
+        CloseGame,      ///< client -> server
+        GameClosed,     ///< server -> client, also sent to the spectators of a closed game
+        Spectate,       ///< client -> server
+        Keyframe,       ///< server -> spectators
+        Delta,          ///< server -> spectators
+        AckKeyframe,    ///< spectator -> server
+        TileAction,     ///< client -> server, answered with an ActionResult
+        Trade,          ///< client -> server, answered with an ActionResult
+        BotAction       ///< client -> server, answered with an ActionResult
+    };
+
+    /** @enum TileActionKind
+     *  @brief What a TileAction does, one of the GameState calls of the same name.
+     */
+    enum class TileActionKind : std::uint8_t { Build, SellBuilding, Mortgage, Redeem };
+
+    /** @brief The owner sent in a TileSnapshot when the tile is owned by the bank. */
+    constexpr std::uint8_t NO_OWNER = 0xFF;
+
+    //* MESSAGES
+    struct Hello {
+        std::uint16_t version;
+    };
+
+    struct Welcome {
+        std::uint16_t version;
+        std::uint16_t shardCount;   ///< The number of threads running games on the server.
+    };
+
+    struct CreateGame {
+        std::uint32_t requestId;
+        std::uint8_t numPlayers;
+        std::uint64_t seed;
+    };
+
+    struct GameCreated {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+    };
+
+    struct Action {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+        std::uint8_t player;
+        std::uint8_t action;        ///< A GameState::Action.
+    };
+
+    struct TileAction {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+        std::uint8_t player;
+        std::uint8_t action;        ///< A TileActionKind.
+        std::uint16_t tile;
+    };
+
+    /** @brief A trade between the acting player and a partner, see GameState::trade(). */
+    struct Trade {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+        std::uint8_t player;
+        std::uint8_t partner;
+        std::uint8_t numGiven;      ///< At most MAX_TRADE_TILES, only these are sent.
+        std::uint8_t numTaken;      ///< At most MAX_TRADE_TILES, only these are sent.
+        std::uint16_t given[MAX_TRADE_TILES];
+        std::uint16_t taken[MAX_TRADE_TILES];
+        std::int32_t cash;          ///< Paid by the acting player to the partner, the other way when negative.
+    };
+
+    /** @brief Asks the server to play the next action of a player as its bot does (see Simulation::applyBotAction()). */
+    struct BotAction {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+        std::uint8_t player;
+    };
+
+    struct ActionResult {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+        std::uint8_t status;        ///< A GameState::Status or STATUS_UNKNOWN_GAME.
+        std::uint8_t phase;         ///< The GameState::Phase after the action.
+        std::uint8_t currentPlayer; ///< The player that has to act next.
+        std::uint8_t die1;          ///< The dice of the last roll.
+        std::uint8_t die2;
+        std::uint8_t position;      ///< The position of the acting player after the action.
+        std::uint32_t money;        ///< The money of the acting player after the action.
+    };
+
+    struct CloseGame {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+    };
+
+    struct GameClosed {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+    };
+
+    /** @brief The part of a tile a spectator sees. */
+    struct TileSnapshot {
+        std::uint8_t owner;         ///< The owning player or NO_OWNER.
+        std::uint8_t buildingLevel;
+    };
+
+    /** @brief The part of a player a spectator sees. */
+    struct PlayerSnapshot {
+        std::uint32_t money;
+        std::uint16_t position;
+    };
+
+    struct Spectate {
+        std::uint32_t requestId;
+        std::uint32_t gameId;
+    };
+
+    /** @brief The full state of a game, the base the following deltas are computed against. */
+    struct Keyframe {
+        std::uint32_t gameId;
+        std::uint32_t keyframeId;
+        std::uint8_t currentPlayer;
+        std::vector<PlayerSnapshot> players;
+        std::vector<TileSnapshot> tiles;
+    };
+
+    /** @brief The players and tiles that differ from a keyframe the spectator acknowledged.
+     *
+     * Deltas are not chained: each one is complete against its keyframe, so a spectator may skip any of them.
+     */
+    struct Delta {
+        std::uint32_t gameId;
+        std::uint32_t keyframeId;   ///< The keyframe this delta is computed against.
+        std::uint32_t sequence;     ///< Increases with every delta of the game.
+        std::uint8_t currentPlayer;
+        std::vector<std::pair<std::uint8_t, PlayerSnapshot>> players; ///< (player index, new state)
+        std::vector<std::pair<std::uint16_t, TileSnapshot>> tiles;    ///< (tile index, new state)
+    };
+
+    struct AckKeyframe {
+        std::uint32_t gameId;
+        std::uint32_t keyframeId;
+    };
+
+    /** @class Writer
+     *  @brief Appends little endian fields and whole frames to a byte buffer.
+     */
+    class Writer {
+    public:
+        explicit Writer(std::vector<std::uint8_t>& buffer);
+
+        void u8(std::uint8_t value);
+        void u16(std::uint16_t value);
+        void u32(std::uint32_t value);
+        void u64(std::uint64_t value);
+        /** @brief Writes the bits of a double as a u64, so it reads back exactly. */
+        void f64(double value);
+        void bytes(const std::uint8_t* data, std::size_t size);
+
+        /** @brief Starts a frame of the given type, the payload is written right after it. */
+        void beginFrame(MessageType type);
+        /** @brief Patches the payload length of the frame started last. */
+        void endFrame();
+
+    private:
+        std::vector<std::uint8_t>& m_buffer; ///< The buffer the fields are appended to.
+        std::size_t m_frameStart;            ///< The offset of the header of the current frame.
+    };
+
+    /** @class Reader
+     *  @brief Reads little endian fields from a payload, failing (not throwing) when it runs out of bytes.
+     */
+    class Reader {
+    public:
+        Reader(const std::uint8_t* data, std::size_t size);
+
+        std::uint8_t u8();
+        std::uint16_t u16();
+        std::uint32_t u32();
+        std::uint64_t u64();
+        double f64();
+        /** @brief Copies the next size bytes, or zeros if there are fewer left. */
+        void bytes(std::uint8_t* data, std::size_t size);
+
+        /** @brief Whether every read so far was inside the payload. */
+        bool ok() const;
+
+    private:
+        /** @brief Checks that n more bytes can be read. */
+        bool has(std::size_t n);
+
+        const std::uint8_t* m_data;
+        std::size_t m_size;
+        std::size_t m_offset;
+        bool m_ok;
+    };
+
+    //* ENCODING: each function appends one whole frame to the buffer
+    void encode(std::vector<std::uint8_t>& out, const Hello& message);
+    void encode(std::vector<std::uint8_t>& out, const Welcome& message);
+    void encode(std::vector<std::uint8_t>& out, const CreateGame& message);
+    void encode(std::vector<std::uint8_t>& out, const GameCreated& message);
+    void encode(std::vector<std::uint8_t>& out, const Action& message);
+    void encode(std::vector<std::uint8_t>& out, const ActionResult& message);
+    void encode(std::vector<std::uint8_t>& out, const CloseGame& message);
+    void encode(std::vector<std::uint8_t>& out, const GameClosed& message);
+    void encode(std::vector<std::uint8_t>& out, const Spectate& message);
+    void encode(std::vector<std::uint8_t>& out, const Keyframe& message);
+    void encode(std::vector<std::uint8_t>& out, const Delta& message);
+    void encode(std::vector<std::uint8_t>& out, const AckKeyframe& message);
+    void encode(std::vector<std::uint8_t>& out, const TileAction& message);
+    void encode(std::vector<std::uint8_t>& out, const Trade& message);
+    void encode(std::vector<std::uint8_t>& out, const BotAction& message);
+
+    //* DECODING: each function reads the payload of a frame, returning false if it is malformed
+    bool decode(Reader& in, Hello& message);
+    bool decode(Reader& in, Welcome& message);
+    bool decode(Reader& in, CreateGame& message);
+    bool decode(Reader& in, GameCreated& message);
+    bool decode(Reader& in, Action& message);
+    bool decode(Reader& in, ActionResult& message);
+    bool decode(Reader& in, CloseGame& message);
+    bool decode(Reader& in, GameClosed& message);
+    bool decode(Reader& in, Spectate& message);
+    bool decode(Reader& in, Keyframe& message);
+    bool decode(Reader& in, Delta& message);
+    bool decode(Reader& in, AckKeyframe& message);
+    bool decode(Reader& in, TileAction& message);
+    bool decode(Reader& in, Trade& message);
+    bool decode(Reader& in, BotAction& message);
+
+    /** @class FrameDecoder
+     *  @brief Splits a byte stream into frames, keeping partial frames between reads.
+     */
+    class FrameDecoder {
+    public:
+        /** @brief Appends received bytes to the stream. */
+        void feed(const std::uint8_t* data, std::size_t size);
+
+        /** @brief Pops the next complete frame.
+         *
+         * The payload pointer stays valid until the next call to feed().
+         * @return false if no complete frame is buffered.
+         */
+        bool next(MessageType& type, const std::uint8_t*& payload, std::size_t& payloadSize);
+
+    private:
+        std::vector<std::uint8_t> m_buffer; ///< The received bytes that were not consumed yet.
+        std::size_t m_offset = 0;           ///< The offset of the first unconsumed byte.
+    };
+}
@@ -0,0 +1,125 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ResultFile.hpp"
+
+constexpr char ResultFile::MAGIC[8];
+
+ResultFile::ResultFile()
+    : m_data(nullptr),
+      m_size(0),
+      m_header(),
+      m_layout()
+{
+}
+
+ResultFile::~ResultFile(){
+    close();
+}
+
+ResultFile::Layout ResultFile::getLayout(unsigned int numSeats, unsigned int rowsPerBlock){
+    // the widest columns first, so every column starts aligned for its type
+    Layout layout = {};
+    std::size_t offset = BLOCK_HEADER_SIZE;
+    layout.seeds = offset;
+    offset += rowsPerBlock * sizeof(std::uint64_t);
+    layout.lengths = offset;
+    offset += rowsPerBlock * sizeof(std::uint32_t);
+    for (unsigned int seat = 0; seat < numSeats; seat++) {
+        layout.money[seat] = offset;
+        offset += rowsPerBlock * sizeof(std::uint32_t);
+    }
+    layout.winners = offset;
+    offset += rowsPerBlock * sizeof(std::int8_t);
+    for (unsigned int seat = 0; seat < numSeats; seat++) {
+        layout.policies[seat] = offset;
+        offset += rowsPerBlock * sizeof(std::uint8_t);
+    }
+    layout.blockSize = offset;
+    return layout;
+}
+
+bool ResultFile::open(const std::string& path){
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<std::size_t>(info.st_size);
+
+    // the blocks and the footer must all be inside the file
+    Header header;
+    std::memcpy(&header, m_data, sizeof(Header));
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION
+        && header.numSeats >= 1 && header.numSeats <= GameState::MAX_PLAYERS
+        && header.rowsPerBlock > 0 && header.rowsPerBlock % 64 == 0
+        && header.blockSize == getLayout(header.numSeats, header.rowsPerBlock).blockSize
+        && header.footerOffset == sizeof(Header) + header.numBlocks * header.blockSize
+        && header.footerOffset + header.numTiles * sizeof(std::uint64_t)
+               + (header.numPolicies + header.numTiles) * NAME_SIZE <= m_size;
+    if (!valid) {
+        close();
+        return false;
+    }
+    m_header = header;
+    m_layout = getLayout(header.numSeats, header.rowsPerBlock);
+    return true;
+}
+
+void ResultFile::close(){
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_header = Header();
+}
+
+ResultFile::Block ResultFile::getBlock(std::uint64_t index) const {
+    const unsigned char* start = m_data + sizeof(Header) + index * m_header.blockSize;
+    Block block = {};
+    std::memcpy(&block.numRows, start, sizeof(block.numRows));
+    block.seeds = reinterpret_cast<const std::uint64_t*>(start + m_layout.seeds);
+    block.lengths = reinterpret_cast<const std::uint32_t*>(start + m_layout.lengths);
+    block.winners = reinterpret_cast<const std::int8_t*>(start + m_layout.winners);
+    for (unsigned int seat = 0; seat < m_header.numSeats; seat++) {
+        block.money[seat] = reinterpret_cast<const std::uint32_t*>(start + m_layout.money[seat]);
+        block.policies[seat] = start + m_layout.policies[seat];
+    }
+    return block;
+}
+
+const std::uint64_t* ResultFile::getLandings() const {
+    return reinterpret_cast<const std::uint64_t*>(m_data + m_header.footerOffset);
+}
+
+std::string ResultFile::getPolicyName(unsigned int policy) const {
+    return policy < m_header.numPolicies ? getName(policy) : std::string();
+}
+
+std::string ResultFile::getTileName(unsigned int tile) const {
+    return tile < m_header.numTiles ? getName(m_header.numPolicies + tile) : std::string();
+}
+
+const ResultFile::Header& ResultFile::getHeader() const {
+    return m_header;
+}
+
+std::string ResultFile::getName(std::size_t index) const {
+    const char* name = reinterpret_cast<const char*>(m_data + m_header.footerOffset
+                                                     + m_header.numTiles * sizeof(std::uint64_t) + index * NAME_SIZE);
+    return std::string(name, strnlen(name, NAME_SIZE));
+}
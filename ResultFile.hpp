@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "GameState.hpp"
+
+/** @class ResultFile
+ *
+ * @brief A file of game results, in columns, read straight from memory with mmap.
+ *
+ * The file is a Header, then blocks of rowsPerBlock games, then the footer. A block starts with the number of games
+ * it holds (only the last blocks of the writers are partly filled), and then holds one column per field of a game:
+ * the seeds, the lengths in turns, the final money of every seat, the winning seats (-1 for a draw), and the policy
+ * of every seat. Every column takes rowsPerBlock entries, so all the blocks have the same size and the same layout
+ * (see getLayout()), and every column is aligned for its type. The footer holds the landings on every tile over all
+ * the games, the names of the policies, and the names of the tiles, each name in NAME_SIZE bytes.
+ *
+ * The numbers are stored as the machine stores them (little endian on every machine this runs on). ResultWriter
+ * writes the header last, so a file whose writer didn't finish has no magic and doesn't open.
+ */
+class ResultFile {
+public:
+    /** @brief The first bytes of a finished file. */
+    static constexpr char MAGIC[8] = { 'M', 'O', 'N', 'O', 'R', 'E', 'S', '\0' };
+    static constexpr std::uint32_t VERSION = 1;
+    /** @brief The bytes of every name in the footer, padded with zeros. */
+    static constexpr std::size_t NAME_SIZE = 32;
+    /** @brief The bytes before the columns of a block, the number of games padded to a cache line. */
+    static constexpr std::size_t BLOCK_HEADER_SIZE = 64;
+
+    /** @brief The first 64 bytes of the file. */
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t numSeats;
+        std::uint32_t rowsPerBlock;
+        std::uint32_t numTiles;
+        std::uint32_t numPolicies;
+        std::uint32_t blockSize;       ///< The bytes of a block.
+        std::uint64_t numBlocks;
+        std::uint64_t numRows;         ///< The games in all the blocks.
+        std::uint64_t footerOffset;
+        std::uint64_t reserved;
+    };
+
+    /** @brief Where the columns of a block start, in bytes from the start of the block. */
+    struct Layout {
+        std::size_t seeds;                                 ///< std::uint64_t
+        std::size_t lengths;                               ///< std::uint32_t
+        std::size_t money[GameState::MAX_PLAYERS];         ///< std::uint32_t
+        std::size_t winners;                               ///< std::int8_t
+        std::size_t policies[GameState::MAX_PLAYERS];      ///< std::uint8_t
+        std::size_t blockSize;
+    };
+
+    /** @brief The columns of a block, pointing into the mapped file. */
+    struct Block {
+        std::uint32_t numRows;
+        const std::uint64_t* seeds;
+        const std::uint32_t* lengths;
+        const std::uint32_t* money[GameState::MAX_PLAYERS];
+        const std::int8_t* winners;
+        const std::uint8_t* policies[GameState::MAX_PLAYERS];
+    };
+
+    ResultFile();
+    ~ResultFile();
+
+    ResultFile(const ResultFile&) = delete;
+    ResultFile& operator=(const ResultFile&) = delete;
+
+    /** @brief Gets the layout of the blocks of a file.
+     *
+     * @param numSeats The players of every game.
+     * @param rowsPerBlock The games of a full block, a multiple of 64.
+     */
+    static Layout getLayout(unsigned int numSeats, unsigned int rowsPerBlock);
+
+    /** @brief Maps a finished file into memory, closing the one open before.
+     *
+     * @return If the file is a whole result file.
+     */
+    bool open(const std::string& path);
+
+    /** @brief Unmaps the file, the blocks taken from it become invalid. */
+    void close();
+
+    /** @brief Gets the columns of a block, smaller than getHeader().numBlocks. */
+    Block getBlock(std::uint64_t index) const;
+
+    /** @brief Gets the landings on every tile, getHeader().numTiles of them. */
+    const std::uint64_t* getLandings() const;
+
+    std::string getPolicyName(unsigned int policy) const;
+    std::string getTileName(unsigned int tile) const;
+
+    //* Getters
+    const Header& getHeader() const;
+
+private:
+    /** @brief Reads a name of the footer. */
+    std::string getName(std::size_t index) const;
+
+    //* MEMBERS
+    const unsigned char* m_data;
+    std::size_t m_size;
+    Header m_header;                       ///< All zeros while no file is open.
+    Layout m_layout;
+};
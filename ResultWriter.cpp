@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Profiler.hpp"
+#include "ResultWriter.hpp"
+
+ResultWriter::ResultWriter()
+    : m_fd(-1),
+      m_numSeats(0),
+      m_layout(),
+      m_numPolicies(0),
+      m_numBlocks(0),
+      m_failed(false),
+      m_numRows(0),
+      m_writing(false),
+      m_stopping(false)
+{
+}
+
+ResultWriter::~ResultWriter(){
+    if (m_fd >= 0) {
+        close(std::vector<std::uint64_t>());
+    }
+}
+
+bool ResultWriter::open(const std::string& path, unsigned int numSeats, unsigned int numWorkers,
+                        const std::vector<std::string>& policyNames, const std::vector<std::string>& tileNames,
+                        bool resuming){
+    if (m_fd >= 0 || numSeats < 1 || numSeats > GameState::MAX_PLAYERS || numWorkers < 1 || policyNames.size() > 256) {
+        return false;
+    }
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (resuming ? 0 : O_TRUNC), 0644);
+    if (m_fd < 0) {
+        return false;
+    }
+    m_numSeats = numSeats;
+    m_layout = ResultFile::getLayout(numSeats, ROWS_PER_BLOCK);
+    m_numPolicies = static_cast<std::uint32_t>(policyNames.size());
+    m_tileNames = tileNames;
+    m_numBlocks = 0;
+    m_failed = false;
+    m_numRows = 0;
+    m_writing = false;
+    m_stopping = false;
+
+    // the names go to the footer, after the policy names
+    m_tileNames.insert(m_tileNames.begin(), policyNames.begin(), policyNames.end());
+
+    // the header stays all zeros until close(), so an unfinished file doesn't open
+    ResultFile::Header header = {};
+    if (!writeAll(reinterpret_cast<const unsigned char*>(&header), sizeof(header))) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_current.clear();
+    for (unsigned int worker = 0; worker < numWorkers; worker++) {
+        m_blocks.push_back(std::unique_ptr<Block>(new Block{ std::unique_ptr<unsigned char[]>(new unsigned char[m_layout.blockSize]()), 0 }));
+        m_current.push_back(m_blocks.back().get());
+    }
+    m_thread = std::thread([this]{ writeLoop(); });
+    return true;
+}
+
+void ResultWriter::add(unsigned int worker, const Row& row){
+    Block* block = m_current[worker];
+    std::uint32_t index = block->numRows;
+    unsigned char* data = block->data.get();
+    reinterpret_cast<std::uint64_t*>(data + m_layout.seeds)[index] = row.seed;
+    reinterpret_cast<std::uint32_t*>(data + m_layout.lengths)[index] = row.length;
+    reinterpret_cast<std::int8_t*>(data + m_layout.winners)[index] = row.winner;
+    for (unsigned int seat = 0; seat < m_numSeats; seat++) {
+        reinterpret_cast<std::uint32_t*>(data + m_layout.money[seat])[index] = row.money[seat];
+        data[m_layout.policies[seat] + index] = row.policies[seat];
+    }
+
+    block->numRows = index + 1;
+    if (block->numRows == ROWS_PER_BLOCK) {
+        m_current[worker] = swapBlock(block);
+    }
+}
+
+bool ResultWriter::close(const std::vector<std::uint64_t>& landings){
+    if (m_fd < 0) {
+        return false;
+    }
+
+    // the blocks the workers were filling, with the unused rows cleared so the file only depends on the games
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Block* block : m_current) {
+            if (block->numRows == 0) {
+                continue;
+            }
+            std::size_t columns[3 + 2 * GameState::MAX_PLAYERS];
+            std::size_t widths[3 + 2 * GameState::MAX_PLAYERS];
+            unsigned int numColumns = getColumns(columns, widths);
+            for (unsigned int column = 0; column < numColumns; column++) {
+                std::memset(block->data.get() + columns[column] + block->numRows * widths[column], 0,
+                            (ROWS_PER_BLOCK - block->numRows) * widths[column]);
+            }
+            m_queue.push_back(block);
+            m_numRows += block->numRows;
+        }
+        m_current.clear();
+        m_stopping = true;
+    }
+    m_queued.notify_one();
+    m_thread.join();
+
+    // the footer: the landings, then the names
+    ResultFile::Header header = {};
+    std::memcpy(header.magic, ResultFile::MAGIC, sizeof(header.magic));
+    header.version = ResultFile::VERSION;
+    header.numSeats = m_numSeats;
+    header.rowsPerBlock = ROWS_PER_BLOCK;
+    header.numTiles = static_cast<std::uint32_t>(m_tileNames.size() - m_numPolicies);
+    header.numPolicies = m_numPolicies;
+    header.blockSize = static_cast<std::uint32_t>(m_layout.blockSize);
+    header.numBlocks = m_numBlocks;
+    header.numRows = m_numRows;
+    header.footerOffset = sizeof(header) + m_numBlocks * m_layout.blockSize;
+
+    std::vector<std::uint64_t> tileLandings(header.numTiles, 0);
+    std::copy_n(landings.begin(), std::min<std::size_t>(landings.size(), header.numTiles), tileLandings.begin());
+    std::vector<unsigned char> footer(tileLandings.size() * sizeof(std::uint64_t) + m_tileNames.size() * ResultFile::NAME_SIZE, 0);
+    std::memcpy(footer.data(), tileLandings.data(), tileLandings.size() * sizeof(std::uint64_t));
+    for (std::size_t name = 0; name < m_tileNames.size(); name++) {
+        std::memcpy(footer.data() + tileLandings.size() * sizeof(std::uint64_t) + name * ResultFile::NAME_SIZE,
+                    m_tileNames[name].data(), std::min(m_tileNames[name].size(), ResultFile::NAME_SIZE - 1));
+    }
+    bool written = !m_failed && writeAll(footer.data(), footer.size())
+        && pwrite(m_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+    written = ::close(m_fd) == 0 && written;
+    m_fd = -1;
+    m_blocks.clear();
+    m_free.clear();
+    return written;
+}
+
+bool ResultWriter::save(Protocol::Writer& writer){
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written.wait(lock, [this]{ return m_queue.empty() && !m_writing; });
+    }
+    if (m_failed || fdatasync(m_fd) != 0) {
+        return false;
+    }
+
+    // the blocks on the disk, then the games of the blocks being filled, column by column
+    std::size_t columns[3 + 2 * GameState::MAX_PLAYERS];
+    std::size_t widths[3 + 2 * GameState::MAX_PLAYERS];
+    unsigned int numColumns = getColumns(columns, widths);
+    writer.u32(m_numSeats);
+    writer.u64(m_numBlocks);
+    writer.u64(m_numRows);
+    writer.u32(static_cast<std::uint32_t>(m_current.size()));
+    for (const Block* block : m_current) {
+        writer.u32(block->numRows);
+        for (unsigned int column = 0; column < numColumns; column++) {
+            writer.bytes(block->data.get() + columns[column], block->numRows * widths[column]);
+        }
+    }
+    return true;
+}
+
+bool ResultWriter::restore(Protocol::Reader& reader){
+    if (m_fd < 0 || reader.u32() != m_numSeats) {
+        return false;
+    }
+    std::uint64_t numBlocks = reader.u64();
+    std::uint64_t numRows = reader.u64();
+    if (reader.u32() != m_current.size()) {
+        return false;
+    }
+
+    // the blocks written after the save are dropped, they are played again
+    std::uint64_t end = sizeof(ResultFile::Header) + numBlocks * m_layout.blockSize;
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < end
+        || ftruncate(m_fd, static_cast<off_t>(end)) != 0 || lseek(m_fd, 0, SEEK_END) != static_cast<off_t>(end)) {
+        return false;
+    }
+
+    std::size_t columns[3 + 2 * GameState::MAX_PLAYERS];
+    std::size_t widths[3 + 2 * GameState::MAX_PLAYERS];
+    unsigned int numColumns = getColumns(columns, widths);
+    for (Block* block : m_current) {
+        block->numRows = reader.u32();
+        if (block->numRows >= ROWS_PER_BLOCK) {
+            return false;
+        }
+        for (unsigned int column = 0; column < numColumns; column++) {
+            reader.bytes(block->data.get() + columns[column], block->numRows * widths[column]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numBlocks = numBlocks;
+    m_numRows = numRows;
+    return reader.ok();
+}
+
+std::uint64_t ResultWriter::getNumRows() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numRows;
+}
+
+unsigned int ResultWriter::getColumns(std::size_t* offsets, std::size_t* widths) const {
+    offsets[0] = m_layout.seeds;
+    widths[0] = sizeof(std::uint64_t);
+    offsets[1] = m_layout.lengths;
+    widths[1] = sizeof(std::uint32_t);
+    offsets[2] = m_layout.winners;
+    widths[2] = sizeof(std::int8_t);
+    unsigned int numColumns = 3;
+    for (unsigned int seat = 0; seat < m_numSeats; seat++) {
+        offsets[numColumns] = m_layout.money[seat];
+        widths[numColumns++] = sizeof(std::uint32_t);
+        offsets[numColumns] = m_layout.policies[seat];
+        widths[numColumns++] = sizeof(std::uint8_t);
+    }
+    return numColumns;
+}
+
+ResultWriter::Block* ResultWriter::swapBlock(Block* full){
+    Block* empty = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(full);
+        m_numRows += full->numRows;
+        if (!m_free.empty()) {
+            empty = m_free.back();
+            m_free.pop_back();
+        }
+    }
+    m_queued.notify_one();
+
+    // the disk is behind, one more block rather than waiting for it
+    if (!empty) {
+        std::unique_ptr<Block> block(new Block{ std::unique_ptr<unsigned char[]>(new unsigned char[m_layout.blockSize]()), 0 });
+        empty = block.get();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blocks.push_back(std::move(block));
+    }
+    empty->numRows = 0;
+    return empty;
+}
+
+void ResultWriter::writeLoop(){
+    Profiler::setThreadName("result writer");
+    while (true) {
+        Block* block = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queued.wait(lock, [this]{ return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            block = m_queue.front();
+            m_queue.pop_front();
+            m_writing = true;
+        }
+
+        // the number of games, then the columns
+        std::memcpy(block->data.get(), &block->numRows, sizeof(block->numRows));
+        if (!m_failed) {
+            m_failed = !writeAll(block->data.get(), m_layout.blockSize);
+            m_numBlocks++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(block);
+            m_writing = false;
+        }
+        m_written.notify_all();
+    }
+}
+
+bool ResultWriter::writeAll(const unsigned char* data, std::size_t size){
+    while (size > 0) {
+        ssize_t written = ::write(m_fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
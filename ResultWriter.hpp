@@ -0,0 +1,131 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Protocol.hpp"
+#include "ResultFile.hpp"
+
+/** @class ResultWriter
+ *
+ * @brief Writes the results of many games to a ResultFile from many worker threads, through a thread of its own.
+ *
+ * Every worker fills a block of its own, column by column, so adding a game takes no lock. A full block goes to a
+ * queue and the worker goes on with an empty one, reused from the blocks already written or allocated if the disk
+ * falls behind, so the workers never wait for the disk. The writer thread writes the queued blocks to the file one
+ * after the other, a whole block per write. The order of the blocks in the file is the order they filled in, so it
+ * changes with the number of workers, but every game keeps its seed and its policies.
+ *
+ * A long job saves the writer with its checkpoints: save() waits for the queued blocks to reach the disk, and
+ * restore() cuts the file back to those blocks and refills the blocks the workers were filling.
+ */
+class ResultWriter {
+public:
+    /** @brief The games of a block, about 1.5MB for 2 seats. */
+    static constexpr unsigned int ROWS_PER_BLOCK = 65536;
+
+    /** @brief The result of one game. */
+    struct Row {
+        std::uint64_t seed;
+        std::uint32_t length;                              ///< In turns.
+        std::uint32_t money[GameState::MAX_PLAYERS];       ///< The final money of every seat.
+        std::int8_t winner;                                ///< The winning seat, -1 for a draw.
+        std::uint8_t policies[GameState::MAX_PLAYERS];     ///< The policy of every seat.
+    };
+
+    ResultWriter();
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /** @brief Creates the file and starts the writer thread.
+     *
+     * @param path The file, replaced if it exists.
+     * @param numSeats The players of every game.
+     * @param numWorkers The threads that add games, each with its own index.
+     * @param policyNames The names of the policies, at most 256.
+     * @param tileNames The names of the tiles of the board.
+     * @param resuming Keep the blocks already in the file, restore() says which ones.
+     * @return If the file was created.
+     */
+    bool open(const std::string& path, unsigned int numSeats, unsigned int numWorkers,
+              const std::vector<std::string>& policyNames, const std::vector<std::string>& tileNames,
+              bool resuming = false);
+
+    /** @brief Adds the result of a game.
+     *
+     * @param worker The index of the calling thread, no two threads may add with the same index at once.
+     */
+    void add(unsigned int worker, const Row& row);
+
+    /** @brief Waits for the queued blocks to be on the disk, and writes what restore() needs to go on from here.
+     *
+     * No worker may add games meanwhile.
+     * @return If every block so far was written.
+     */
+    bool save(Protocol::Writer& writer);
+
+    /** @brief Goes back to the point of a save(), right after open() with resuming.
+     *
+     * @return If the file holds the blocks that were saved.
+     */
+    bool restore(Protocol::Reader& reader);
+
+    /** @brief Writes the blocks left, the footer and the header, and stops the writer thread.
+     *
+     * @param landings The landings on every tile over all the games.
+     * @return If everything was written.
+     */
+    bool close(const std::vector<std::uint64_t>& landings);
+
+    //* Getters
+    /** @brief Gets the games in the blocks handed to the writer thread, all the games once closed. */
+    std::uint64_t getNumRows() const;
+
+private:
+    /** @brief The columns of ROWS_PER_BLOCK games, laid out as in the file. */
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::uint32_t numRows;
+    };
+
+    /** @brief Gets where every column of a block starts and the bytes of its entries, and the number of columns. */
+    unsigned int getColumns(std::size_t* offsets, std::size_t* widths) const;
+
+    /** @brief Queues a full block and gets an empty one. */
+    Block* swapBlock(Block* full);
+
+    /** @brief The loop of the writer thread: writes the queued blocks until close(). */
+    void writeLoop();
+
+    /** @brief Writes all the bytes at the end of the file. */
+    bool writeAll(const unsigned char* data, std::size_t size);
+
+    //* MEMBERS
+    int m_fd;
+    unsigned int m_numSeats;
+    ResultFile::Layout m_layout;
+    std::uint32_t m_numPolicies;
+    std::vector<std::string> m_tileNames;
+    std::uint64_t m_numBlocks;             ///< The blocks written, only touched by the writer thread until close().
+    bool m_failed;                         ///< A write failed, only touched by the writer thread until close().
+
+    std::vector<Block*> m_current;         ///< The block every worker fills.
+    std::vector<std::unique_ptr<Block>> m_blocks;
+
+    mutable std::mutex m_mutex;            ///< Guards the fields below.
+    std::condition_variable m_queued;      ///< Signaled when a block is queued or on close().
+    std::condition_variable m_written;     ///< Signaled when a block was written.
+    std::deque<Block*> m_queue;            ///< The full blocks, in order.
+    std::vector<Block*> m_free;            ///< The blocks written, to fill again.
+    std::uint64_t m_numRows;               ///< The games of the queued and written blocks.
+    bool m_writing;                        ///< The writer thread is writing a block.
+    bool m_stopping;
+    std::thread m_thread;
+};
@@ -0,0 +1,253 @@
+#include "Profiler.hpp"
+#include "Simulation.hpp"
+#include "TradeEvaluator.hpp"
+
+namespace {
+    // bot actions applied between two checks of the input queue while autoplaying
+    constexpr unsigned int AUTOPLAY_BATCH = 64;
+    // the money a bot keeps in hand when building, to pay the rents of the next round
+    constexpr unsigned int BOT_CASH_RESERVE = 150;
+
+    // checks if a player owns all the tiles of a group but one, and another player owns that one
+    bool isOneTileShort(const GameState& game, unsigned int player){
+        const BoardDefinition& board = game.getBoard();
+        const BuildingEngine& buildings = game.getBuildings();
+        for (unsigned int group = 0; group < board.getNumGroups(); group++) {
+            std::uint8_t id = static_cast<std::uint8_t>(group);
+            unsigned int size = board.getGroupSize(id);
+            if (size < 2 || buildings.getOwnedCount(id, player) + 1 != size) {
+                continue;
+            }
+            for (unsigned int tile : board.getGroupTiles(id)) {
+                if (game.getTile(tile).owner >= 0 && game.getTile(tile).owner != static_cast<int>(player)
+                    && game.getTileDefinition(tile).housePrice > 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // trades for the best deal the other player accepts, keeping some cash in hand
+    bool proposeTrade(GameState& game, unsigned int reserve){
+        // one evaluator per thread, it keeps its buffers between the games the thread plays
+        thread_local TradeEvaluator trades;
+        unsigned int money = game.getPlayer(game.getCurrentPlayer()).money;
+        GameState::TradeOffer offer;
+        return trades.findTrade(game, money > reserve ? money - reserve : 0, offer)
+            && game.trade(game.getCurrentPlayer(), offer) == GameState::Status::Ok;
+    }
+}
+
+Simulation::Simulation(unsigned int numPlayers, std::uint64_t seed)
+    : m_numPlayers(numPlayers),
+      m_seed(seed),
+      m_game(numPlayers, seed),
+      m_autoplay(false),
+      m_version(0),
+      m_actionCount(0),
+      m_running(false)
+{
+}
+
+Simulation::~Simulation(){
+    stop();
+}
+
+void Simulation::start(){
+    if (m_running) {
+        return;
+    }
+    // the first snapshot is ready before the window draws anything
+    publishSnapshot();
+    m_running = true;
+    m_thread = std::thread([this]{ loop(); });
+}
+
+void Simulation::stop(){
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        m_running = false;
+    }
+    m_inputReady.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void Simulation::pushInput(const Input& input){
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        m_inputs.push_back(input);
+    }
+    m_inputReady.notify_one();
+}
+
+bool Simulation::pollSnapshot(){
+    return m_snapshots.update();
+}
+
+const GameSnapshot& Simulation::getSnapshot() const {
+    return m_snapshots.getReadBuffer();
+}
+
+std::uint64_t Simulation::getActionCount() const {
+    return m_actionCount.load(std::memory_order_relaxed);
+}
+
+void Simulation::loop(){
+    Profiler::setThreadName("simulation");
+    std::vector<Input> inputs;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_inputMutex);
+            // idle until there is something to do, autoplay only looks at the queue between batches
+            if (!m_autoplay) {
+                m_inputReady.wait(lock, [this]{ return !m_inputs.empty() || !m_running; });
+            }
+            if (!m_running) {
+                return;
+            }
+            inputs.swap(m_inputs);
+        }
+
+        PROFILE_ZONE("Simulation::step");
+        for (const auto& input : inputs) {
+            handleInput(input);
+        }
+        bool changed = !inputs.empty();
+        inputs.clear();
+
+        if (m_autoplay) {
+            for (unsigned int i = 0; i < AUTOPLAY_BATCH; i++) {
+                playBotAction();
+            }
+            changed = true;
+        }
+
+        if (changed) {
+            publishSnapshot();
+        }
+    }
+}
+
+void Simulation::handleInput(const Input& input){
+    switch (input.kind) {
+        case Input::Kind::Action:
+            if (m_game.apply(m_game.getCurrentPlayer(), input.action) == GameState::Status::Ok) {
+                m_actionCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        case Input::Kind::ProposeTrade:
+            if (proposeTrade(m_game, BOT_CASH_RESERVE)) {
+                m_actionCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        case Input::Kind::ToggleAutoplay:
+            m_autoplay = !m_autoplay;
+            break;
+        case Input::Kind::NewGame:
+            m_game = GameState(m_numPlayers, ++m_seed);
+            break;
+    }
+}
+
+void Simulation::playBotAction(){
+    // a finished game is replaced, so autoplay keeps the thread busy
+    if (m_game.getPhase() == GameState::Phase::GameOver) {
+        m_game = GameState(m_numPlayers, ++m_seed);
+    }
+    applyBotAction(m_game);
+    m_actionCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+const BotPolicy& BotPolicy::standard(){
+    static const BotPolicy policy{ "standard", 0, BOT_CASH_RESERVE, BuildingEngine::HOTEL_LEVEL, true };
+    return policy;
+}
+
+GameState::Action Simulation::chooseBotAction(const GameState& game){
+    return chooseBotAction(game, BotPolicy::standard());
+}
+
+GameState::Action Simulation::chooseBotAction(const GameState& game, const BotPolicy& policy){
+    switch (game.getPhase()) {
+        case GameState::Phase::BuyMenu: {
+            const GameState::PlayerState& player = game.getPlayer(game.getCurrentPlayer());
+            const GameState::TileDefinition& tile = game.getTileDefinition(player.position);
+            return player.money >= tile.price + policy.buyReserve ? GameState::Action::Buy : GameState::Action::DoNotBuy;
+        }
+        case GameState::Phase::EndTurn:
+            return GameState::Action::EndTurn;
+        default:
+            return GameState::Action::RollDice;
+    }
+}
+
+GameState::Status Simulation::applyBotAction(GameState& game){
+    return applyBotAction(game, BotPolicy::standard());
+}
+
+GameState::Status Simulation::applyBotAction(GameState& game, const BotPolicy& policy){
+    unsigned int player = game.getCurrentPlayer();
+    if (game.getPhase() == GameState::Phase::EndTurn && policy.trades && isOneTileShort(game, player)) {
+        proposeTrade(game, policy.buildReserve);
+    }
+    if (game.getPhase() == GameState::Phase::EndTurn && game.getPlayer(player).mortgagedTiles > 0) {
+        // the mortgaged tiles are redeemed before building, as they block building on their groups
+        for (unsigned int tile = 0; tile < game.getNumTiles(); tile++) {
+            const GameState::TileState& state = game.getTile(tile);
+            if (state.owner == static_cast<int>(player) && state.mortgaged
+                && game.getPlayer(player).money >= GameState::getRedeemCost(game.getTileDefinition(tile)) + policy.buildReserve) {
+                game.redeem(player, tile);
+            }
+        }
+    }
+    if (game.getPhase() == GameState::Phase::EndTurn) {
+        // hotels first, then houses, the engine keeps the sites so this never looks at the other tiles
+        const BuildingEngine& buildings = game.getBuildings();
+        while (true) {
+            const std::vector<std::uint16_t>& hotels = buildings.getHotelSites(player);
+            const std::vector<std::uint16_t>& houses = buildings.getHouseSites(player);
+            unsigned int tile;
+            if (!hotels.empty() && policy.maxBuildLevel >= BuildingEngine::HOTEL_LEVEL) {
+                tile = hotels.back();
+            } else if (!houses.empty() && buildings.getLevel(houses.back()) < policy.maxBuildLevel) {
+                tile = houses.back();
+            } else {
+                break;
+            }
+            if (game.getPlayer(player).money < game.getTileDefinition(tile).housePrice + policy.buildReserve
+                || game.build(player, tile) != GameState::Status::Ok) {
+                break;
+            }
+        }
+    }
+    return game.apply(player, chooseBotAction(game, policy));
+}
+
+void Simulation::publishSnapshot(){
+    PROFILE_ZONE("Simulation::publishSnapshot");
+    // the slot is reused, so after the first fills the vectors keep their capacity and nothing is allocated
+    GameSnapshot& snapshot = m_snapshots.getWriteBuffer();
+    snapshot.version = ++m_version;
+    snapshot.phase = m_game.getPhase();
+    snapshot.currentPlayer = m_game.getCurrentPlayer();
+    snapshot.lastDie1 = m_game.getLastDie1();
+    snapshot.lastDie2 = m_game.getLastDie2();
+    snapshot.turnCount = m_game.getTurnCount();
+    snapshot.winner = m_game.getWinner();
+
+    snapshot.players.resize(m_game.getNumPlayers());
+    for (unsigned int i = 0; i < m_game.getNumPlayers(); i++) {
+        const GameState::PlayerState& player = m_game.getPlayer(i);
+        snapshot.players[i] = GameSnapshot::PlayerView{ player.money, player.position, player.inJail, player.bankrupt };
+    }
+    snapshot.tiles.resize(m_game.getNumTiles());
+    for (unsigned int i = 0; i < m_game.getNumTiles(); i++) {
+        const GameState::TileState& tile = m_game.getTile(i);
+        snapshot.tiles[i] = GameSnapshot::TileView{ tile.owner, tile.buildingLevel };
+    }
+
+    m_snapshots.publish();
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameState.hpp"
+#include "TripleBuffer.hpp"
+
+/** @brief An immutable copy of everything the window shows about a game. */
+struct GameSnapshot {
+    /** @brief What is shown on a tile. */
+    struct TileView {
+        int owner;                  ///< Index of the owning player, -1 if owned by the bank.
+        unsigned int buildingLevel; ///< 0 for no buildings, 1-4 for houses and 5 for a hotel.
+    };
+
+    /** @brief What is shown about a player. */
+    struct PlayerView {
+        unsigned int money;
+        unsigned int position;
+        bool inJail;
+        bool bankrupt;
+    };
+
+    std::uint64_t version = 0;      ///< Incremented on every published change, 0 before the first one.
+    GameState::Phase phase = GameState::Phase::RollDice;
+    unsigned int currentPlayer = 0;
+    unsigned int lastDie1 = 0;
+    unsigned int lastDie2 = 0;
+    unsigned int turnCount = 0;
+    int winner = -1;
+    std::vector<PlayerView> players;
+    std::vector<TileView> tiles;
+};
+
+/** @brief The knobs of a bot strategy, so strategies can be played against each other (see Tournament). */
+struct BotPolicy {
+    std::string name;
+    unsigned int buyReserve;       ///< The cash the bot keeps after buying a tile, it declines (and auctions) it otherwise.
+    unsigned int buildReserve;     ///< The cash the bot keeps after redeeming and building.
+    unsigned int maxBuildLevel;    ///< The building level the bot builds up to, 0 to never build and 5 for hotels.
+    bool trades;                   ///< Whether the bot trades for the last tile of its groups.
+
+    /** @brief Gets the policy of the bots of the window, the dashboard and the benchmarks. */
+    static const BotPolicy& standard();
+};
+
+/** @class Simulation
+ *
+ * @brief Runs the game logic on its own thread, so a long decision never stalls the window.
+ *
+ * The window thread forwards the input of the players through a queue and draws the newest
+ * GameSnapshot, which the simulation thread publishes through a lock free TripleBuffer after every change.
+ * The window thread never waits for the game logic: pushing an input only holds the queue's lock
+ * for a push_back, and taking a snapshot is a single atomic exchange.
+ */
+class Simulation {
+public:
+    /** @brief An input of the players, forwarded to the simulation thread. */
+    struct Input {
+        enum class Kind : std::uint8_t {
+            Action,          ///< The current player takes the action.
+            ProposeTrade,    ///< The current player makes the best trade another player accepts (see TradeEvaluator).
+            ToggleAutoplay,  ///< Bots start (or stop) playing every seat as fast as they can.
+            NewGame          ///< Restart with a new seed.
+        };
+
+        Kind kind;
+        GameState::Action action;
+    };
+
+    /** @brief Creates the simulation of a new game, call start() to run it.
+     *
+     * @param numPlayers The number of players, between 2 and GameState::MAX_PLAYERS.
+     * @param seed The seed of the game's dice.
+     */
+    Simulation(unsigned int numPlayers, std::uint64_t seed);
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    /** @brief Starts the simulation thread and publishes the first snapshot. */
+    void start();
+
+    /** @brief Stops the simulation thread and waits for it. */
+    void stop();
+
+    /** @brief Forwards an input to the simulation thread. */
+    void pushInput(const Input& input);
+
+    //* Window thread only
+    /** @brief Takes the newest snapshot if a new one was published.
+     *
+     * @return Whether getSnapshot() changed.
+     */
+    bool pollSnapshot();
+
+    /** @brief Gets the snapshot taken by the last pollSnapshot(). */
+    const GameSnapshot& getSnapshot() const;
+
+    /** @brief Gets the number of actions applied so far. */
+    std::uint64_t getActionCount() const;
+
+    /** @brief Chooses the action a bot takes in the current phase: buys whatever it can afford. */
+    static GameState::Action chooseBotAction(const GameState& game);
+    static GameState::Action chooseBotAction(const GameState& game, const BotPolicy& policy);
+
+    /** @brief Plays one bot action for the current player of a game.
+     *
+     * before ending its turn the bot trades for the last tile of a group when another player owns it, redeems its
+     * mortgaged tiles and builds wherever it can, as long as it keeps some cash in hand, then it applies chooseBotAction().
+     * @param game The game.
+     * @param policy The strategy of the bot, BotPolicy::standard() if not given.
+     * @return The status of the action.
+     */
+    static GameState::Status applyBotAction(GameState& game);
+    static GameState::Status applyBotAction(GameState& game, const BotPolicy& policy);
+
+private:
+    /** @brief The loop of the simulation thread: applies the inputs and publishes the snapshots. */
+    void loop();
+
+    /** @brief Applies one input of the players. */
+    void handleInput(const Input& input);
+
+    /** @brief Applies one bot action for the current player. */
+    void playBotAction();
+
+    /** @brief Copies the game into the write buffer and publishes it. */
+    void publishSnapshot();
+
+    //* MEMBERS
+    unsigned int m_numPlayers;
+    std::uint64_t m_seed;
+    GameState m_game;                         ///< Only used by the simulation thread once started.
+    bool m_autoplay;                          ///< Only used by the simulation thread.
+    std::uint64_t m_version;                  ///< Only used by the simulation thread.
+
+    std::mutex m_inputMutex;                  ///< Guards m_inputs.
+    std::condition_variable m_inputReady;     ///< Signaled when inputs are queued or on stop().
+    std::vector<Input> m_inputs;              ///< The inputs waiting for the simulation thread.
+
+    TripleBuffer<GameSnapshot> m_snapshots;
+    std::atomic<std::uint64_t> m_actionCount;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include "SpectatorFeed.hpp"
+
+SpectatorFeed::SpectatorFeed(std::uint32_t gameId)
+    : m_gameId(gameId),
+      m_nextKeyframeId(1),
+      m_sequence(0),
+      m_broadcastBytes(0)
+{
+    m_current.keyframe.keyframeId = 0;
+    m_previous.keyframe.keyframeId = 0;
+}
+
+void SpectatorFeed::addSpectator(const std::shared_ptr<Connection>& connection, const GameState& game, SendBatch& batch){
+    if (m_current.keyframe.keyframeId == 0) {
+        cutKeyframe(game);
+    }
+    m_spectators.push_back(Spectator{ connection, 0 });
+    batch.add(connection, m_current.encoded);
+    m_broadcastBytes += m_current.encoded->size();
+}
+
+void SpectatorFeed::removeSpectator(const Connection* connection){
+    m_spectators.erase(
+        std::remove_if(m_spectators.begin(), m_spectators.end(),
+                       [connection](const Spectator& spectator){ return spectator.connection.get() == connection; }),
+        m_spectators.end());
+}
+
+void SpectatorFeed::acknowledge(const Connection* connection, std::uint32_t keyframeId){
+    // only the keyframes deltas are still computed against can be acknowledged
+    if (keyframeId == 0 || (keyframeId != m_current.keyframe.keyframeId && keyframeId != m_previous.keyframe.keyframeId)) {
+        return;
+    }
+    for (auto& spectator : m_spectators) {
+        if (spectator.connection.get() == connection) {
+            // never move a spectator back to an older keyframe
+            if (spectator.ackedKeyframe < keyframeId) {
+                spectator.ackedKeyframe = keyframeId;
+            }
+        }
+    }
+}
+
+void SpectatorFeed::publish(const GameState& game, SendBatch& batch){
+    if (m_spectators.empty()) {
+        return;
+    }
+
+    const std::uint32_t currentId = m_current.keyframe.keyframeId;
+    const std::uint32_t previousId = m_previous.keyframe.keyframeId;
+    bool anyOnPrevious = false;
+    for (const auto& spectator : m_spectators) {
+        if (previousId != 0 && spectator.ackedKeyframe == previousId) {
+            anyOnPrevious = true;
+            break;
+        }
+    }
+
+    computeDelta(game, m_current.keyframe);
+
+    // the delta got large: a fresh keyframe is cheaper, unless someone still needs the previous one
+    std::size_t stateEntries = m_current.keyframe.players.size() + m_current.keyframe.tiles.size();
+    std::size_t deltaEntries = m_delta.players.size() + m_delta.tiles.size();
+    if (!anyOnPrevious && deltaEntries * 2 > stateEntries) {
+        cutKeyframe(game);
+        for (const auto& spectator : m_spectators) {
+            batch.add(spectator.connection, m_current.encoded);
+            m_broadcastBytes += m_current.encoded->size();
+        }
+        return;
+    }
+
+    // one shared delta per keyframe, encoded only if some spectator is on it
+    Connection::SharedBuffer currentDelta;
+    Connection::SharedBuffer previousDelta;
+    for (const auto& spectator : m_spectators) {
+        if (spectator.connection->getQueuedBytes() > MAX_SPECTATOR_BACKLOG) {
+            continue;
+        }
+        if (spectator.ackedKeyframe == currentId) {
+            if (!currentDelta) {
+                currentDelta = encodeDelta();
+            }
+            batch.add(spectator.connection, currentDelta);
+            m_broadcastBytes += currentDelta->size();
+        }
+    }
+    if (anyOnPrevious) {
+        computeDelta(game, m_previous.keyframe);
+        for (const auto& spectator : m_spectators) {
+            if (spectator.ackedKeyframe != previousId || spectator.connection->getQueuedBytes() > MAX_SPECTATOR_BACKLOG) {
+                continue;
+            }
+            if (!previousDelta) {
+                previousDelta = encodeDelta();
+            }
+            batch.add(spectator.connection, previousDelta);
+            m_broadcastBytes += previousDelta->size();
+        }
+    }
+    // spectators that did not ack any keyframe yet get nothing until they do
+}
+
+void SpectatorFeed::close(SendBatch& batch){
+    if (m_spectators.empty()) {
+        return;
+    }
+    auto closed = std::make_shared<Connection::Buffer>();
+    Protocol::encode(*closed, Protocol::GameClosed{ 0, m_gameId });
+    for (const auto& spectator : m_spectators) {
+        batch.add(spectator.connection, closed);
+    }
+    m_spectators.clear();
+}
+
+std::size_t SpectatorFeed::getSpectatorCount() const {
+    return m_spectators.size();
+}
+
+std::uint64_t SpectatorFeed::getBroadcastBytes() const {
+    return m_broadcastBytes;
+}
+
+void SpectatorFeed::cutKeyframe(const GameState& game){
+    std::swap(m_previous, m_current);
+
+    Protocol::Keyframe& keyframe = m_current.keyframe;
+    keyframe.gameId = m_gameId;
+    keyframe.keyframeId = m_nextKeyframeId++;
+    keyframe.currentPlayer = static_cast<std::uint8_t>(game.getCurrentPlayer());
+    keyframe.players.resize(game.getNumPlayers());
+    for (unsigned int i = 0; i < game.getNumPlayers(); i++) {
+        const GameState::PlayerState& player = game.getPlayer(i);
+        keyframe.players[i] = Protocol::PlayerSnapshot{ player.money, static_cast<std::uint16_t>(player.position) };
+    }
+    keyframe.tiles.resize(game.getNumTiles());
+    for (unsigned int i = 0; i < game.getNumTiles(); i++) {
+        const GameState::TileState& tile = game.getTile(i);
+        std::uint8_t owner = tile.owner < 0 ? Protocol::NO_OWNER : static_cast<std::uint8_t>(tile.owner);
+        keyframe.tiles[i] = Protocol::TileSnapshot{ owner, static_cast<std::uint8_t>(tile.buildingLevel) };
+    }
+
+    auto encoded = std::make_shared<Connection::Buffer>();
+    Protocol::encode(*encoded, keyframe);
+    m_current.encoded = encoded;
+}
+
+void SpectatorFeed::computeDelta(const GameState& game, const Protocol::Keyframe& base){
+    m_delta.gameId = m_gameId;
+    m_delta.keyframeId = base.keyframeId;
+    m_delta.currentPlayer = static_cast<std::uint8_t>(game.getCurrentPlayer());
+    m_delta.players.clear();
+    m_delta.tiles.clear();
+
+    for (unsigned int i = 0; i < base.players.size(); i++) {
+        const GameState::PlayerState& player = game.getPlayer(i);
+        if (player.money != base.players[i].money || player.position != base.players[i].position) {
+            m_delta.players.emplace_back(static_cast<std::uint8_t>(i),
+                                         Protocol::PlayerSnapshot{ player.money, static_cast<std::uint16_t>(player.position) });
+        }
+    }
+    for (unsigned int i = 0; i < base.tiles.size(); i++) {
+        const GameState::TileState& tile = game.getTile(i);
+        std::uint8_t owner = tile.owner < 0 ? Protocol::NO_OWNER : static_cast<std::uint8_t>(tile.owner);
+        if (owner != base.tiles[i].owner || tile.buildingLevel != base.tiles[i].buildingLevel) {
+            m_delta.tiles.emplace_back(static_cast<std::uint16_t>(i),
+                                       Protocol::TileSnapshot{ owner, static_cast<std::uint8_t>(tile.buildingLevel) });
+        }
+    }
+}
+
+Connection::SharedBuffer SpectatorFeed::encodeDelta(){
+    m_delta.sequence = ++m_sequence;
+    auto encoded = std::make_shared<Connection::Buffer>();
+    Protocol::encode(*encoded, m_delta);
+    return encoded;
+}
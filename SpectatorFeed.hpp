@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Connection.hpp"
+#include "GameState.hpp"
+#include "Protocol.hpp"
+
+/** @class SpectatorFeed
+ *
+ * @brief Streams the changes of one game to its spectators.
+ *
+ * A spectator first gets a keyframe (the full visible state) and acknowledges it. After every change
+ * it gets a delta holding only the tiles (owner, building) and players (money, position) that differ
+ * from the keyframe it acknowledged. All the spectators on the same keyframe share one encoded delta.
+ *
+ * When the deltas grow to half the size of the state, a new keyframe is cut and sent to everyone.
+ * Until a spectator acknowledges it, that spectator keeps getting deltas against the previous keyframe,
+ * so at most two deltas are encoded per change. Since deltas are not chained, a spectator whose
+ * socket is backed up simply skips deltas and catches up with the next one.
+ */
+class SpectatorFeed {
+public:
+    /** @brief The unsent bytes above which a spectator skips deltas. */
+    static constexpr std::size_t MAX_SPECTATOR_BACKLOG = 256 * 1024;
+
+    /** @brief Creates the feed of a game without spectators. */
+    explicit SpectatorFeed(std::uint32_t gameId);
+
+    /** @brief Adds a spectator and queues the current keyframe for it. */
+    void addSpectator(const std::shared_ptr<Connection>& connection, const GameState& game, SendBatch& batch);
+
+    /** @brief Removes a spectator (e.g. when its connection closed). */
+    void removeSpectator(const Connection* connection);
+
+    /** @brief Records that a spectator received the given keyframe. */
+    void acknowledge(const Connection* connection, std::uint32_t keyframeId);
+
+    /** @brief Queues the changes of the game for every spectator, call after each change of the game. */
+    void publish(const GameState& game, SendBatch& batch);
+
+    /** @brief Tells every spectator the game is closed and removes them. */
+    void close(SendBatch& batch);
+
+    /** @brief Gets the number of spectators. */
+    std::size_t getSpectatorCount() const;
+
+    /** @brief Gets the bytes queued for spectators so far (counting each recipient). */
+    std::uint64_t getBroadcastBytes() const;
+
+private:
+    /** @brief A keyframe and its encoded frame. */
+    struct Base {
+        Protocol::Keyframe keyframe;
+        Connection::SharedBuffer encoded;
+    };
+
+    /** @brief A spectator and the last keyframe it acknowledged (0 for none). */
+    struct Spectator {
+        std::shared_ptr<Connection> connection;
+        std::uint32_t ackedKeyframe;
+    };
+
+    /** @brief Captures the visible state of the game as a new current keyframe. */
+    void cutKeyframe(const GameState& game);
+
+    /** @brief Fills m_delta with the differences between the game and a keyframe. */
+    void computeDelta(const GameState& game, const Protocol::Keyframe& base);
+
+    /** @brief Encodes m_delta into a new shared buffer. */
+    Connection::SharedBuffer encodeDelta();
+
+    //* MEMBERS
+    std::uint32_t m_gameId;
+    std::uint32_t m_nextKeyframeId;
+    std::uint32_t m_sequence;
+    Base m_current;                      ///< The newest keyframe.
+    Base m_previous;                     ///< The keyframe before it, for spectators that did not ack m_current yet.
+    std::vector<Spectator> m_spectators;
+    Protocol::Delta m_delta;             ///< Scratch delta, reused to avoid allocations.
+    std::uint64_t m_broadcastBytes;
+};
@@ -1,13 +1,16 @@
+#include "LabelTable.hpp"
+#include "Profiler.hpp"
 #include "StreetTile.hpp"
 
 // Constructor
 StreetTile::StreetTile(const std::string& name, unsigned int price, sf::Font& font,
-                       ReadingDirection direction, sf::Color stripColor)
-    : m_name(name), m_price(price), m_font(font), m_readingDirection(direction),
-      m_owner(nullptr), m_buildingType(BuildingType::None),
+                       ReadingDirection direction, sf::Color stripColor, std::pmr::memory_resource* textMemory)
+    : m_name(name), m_nameLabel(&LabelTable::intern(name)), m_font(font), m_readingDirection(direction),
+      m_price(price), m_owner(nullptr), m_ownerLabel(nullptr),
       m_ownerStripePercentage(0.1f), // Default owner stripe percentage
-      m_mainTextBox(sf::FloatRect()), // Initialize m_mainTextBox with bounds
-      m_ownerTextBox(sf::FloatRect()) // Initialize m_ownerTextBox with default bounds
+      m_mainTextBox(sf::FloatRect(), textMemory), // Initialize m_mainTextBox with bounds
+      m_ownerTextBox(sf::FloatRect(), textMemory), // Initialize m_ownerTextBox with default bounds
+      m_buildingType(BuildingType::None)
 {
     // Initialize the main colored text box
     m_mainTextBox.setBackgroundColor(sf::Color::White);
@@ -34,11 +37,12 @@ std::string StreetTile::getName() const {
 
 void StreetTile::setName(const std::string& name) {
     m_name = name;
+    m_nameLabel = &LabelTable::intern(name);
     // update the graphical components
     adjustAllComponents();
 }
 
-std::string StreetTile::getLandingPlayerName() const {
+const std::string& StreetTile::getLandingPlayerName() const {
     return m_landingPlayerName;
 }
 
@@ -64,8 +68,8 @@ sf::FloatRect StreetTile::getBounds() const {
 
 void StreetTile::setBounds(const sf::FloatRect& bounds) {
     m_bounds = bounds;
-    // update the graphical components
-    adjustAllComponents();
+    // the texts don't depend on the bounds, only move and resize the components
+    adjustGeometry();
 }
 
 unsigned int StreetTile::getPrice() const {
@@ -84,6 +88,7 @@ Player* StreetTile::getOwner() const {
 
 void StreetTile::setOwner(Player* owner) {
     m_owner = owner;
+    m_ownerLabel = owner ? &LabelTable::intern(owner->getName()) : nullptr;
     // update the graphical components
     adjustAllComponents();
 }
@@ -121,12 +126,22 @@ unsigned int StreetTile::calcRent() {
     }
 }
 
+void StreetTile::collectTextBoxes(std::vector<const TextBox*>& textBoxes) const {
+    textBoxes.push_back(&m_mainTextBox);
+    textBoxes.push_back(&m_ownerTextBox);
+}
+
 void StreetTile::adjustAllComponents() {
+    PROFILE_ZONE("StreetTile::adjustAllComponents");
     // Update the TextBox content
     m_mainTextBox.setTextDirection(getTextBoxDirection(m_readingDirection));
     updateTextBox();
     updateOwnerTextBox();
 
+    adjustGeometry();
+}
+
+void StreetTile::adjustGeometry() {
     // Calculate the thicknesses
     if (m_readingDirection == ReadingDirection::Up || m_readingDirection == ReadingDirection::Down) {
         m_colorStripThickness = m_bounds.height * 0.15f;
@@ -259,69 +274,37 @@ void StreetTile::adjustOwnerTextBox() {
     m_ownerTextBox.setOutlineThickness(1.f);
 
     // Update owner text content
-    sf::Text ownerText;
-    ownerText.setFont(m_font);
-    ownerText.setString(m_owner->getName()); // Assuming Player has getName() method
-    ownerText.setFillColor(sf::Color::Black);
-    ownerText.setCharacterSize(20); // Placeholder size
-
-    m_ownerTextBox.setTexts({ { ownerText, TextBox::Alignment::Center } });
+    m_ownerTextBox.setTexts({ makeLabelSpec(*m_ownerLabel) });
 }
 
 void StreetTile::updateTextBox() {
-    // Clear existing texts
-    m_mainTextBox.setTexts({});
-
-    std::vector<std::pair<sf::Text, TextBox::Alignment>> texts;
+    // the labels are interned, so this only copies pointers (and allocates nothing once the text box held 3 texts)
+    TextBox::TextSpec texts[3];
+    std::size_t count = 0;
 
-    // Create sf::Text for name if not empty
+    // the name if not empty
     if (!m_name.empty()) {
-        sf::Text nameText;
-        nameText.setFont(m_font);
-        nameText.setString(m_name);
-        nameText.setFillColor(sf::Color::Black);
-        nameText.setCharacterSize(30); // Placeholder size
-
-        texts.emplace_back(std::make_pair(nameText, TextBox::Alignment::Center));
+        texts[count++] = makeLabelSpec(*m_nameLabel);
     }
 
-    // Create sf::Text for price if greater than zero
+    // the price if greater than zero
     if (m_price > 0) {
-        sf::Text priceText;
-        priceText.setFont(m_font);
-        priceText.setString("$" + std::to_string(m_price));
-        priceText.setFillColor(sf::Color::Black);
-        priceText.setCharacterSize(30); // Placeholder size
-
-        texts.emplace_back(std::make_pair(priceText, TextBox::Alignment::Center));
+        texts[count++] = makeLabelSpec(LabelTable::price(m_price));
     }
 
-    // Add house/hotel information if applicable
+    // house/hotel information if applicable
     if (m_buildingType != BuildingType::None) {
-        sf::Text buildingText;
-        buildingText.setFont(m_font);
-        buildingText.setFillColor(sf::Color::Black);
-        buildingText.setCharacterSize(30);
-
-        if (m_buildingType == BuildingType::Hotel) {
-            buildingText.setString("Hotel");
-        } else {
-            int houseNumber = 0;
-            switch (m_buildingType) {
-            case BuildingType::OneHouse:    houseNumber = 1; break;
-            case BuildingType::TwoHouses:   houseNumber = 2; break;
-            case BuildingType::ThreeHouses: houseNumber = 3; break;
-            case BuildingType::FourHouses:  houseNumber = 4; break;
-            default: break;
-            }
-            buildingText.setString("Houses: " + std::to_string(houseNumber));
-        }
-
-        texts.emplace_back(std::make_pair(buildingText, TextBox::Alignment::Center));
+        texts[count++] = makeLabelSpec(LabelTable::buildings(static_cast<unsigned int>(m_buildingType)));
     }
 
     // Set texts to main TextBox
-    m_mainTextBox.setTexts(texts);
+    m_mainTextBox.setTexts(texts, count);
+}
+
+TextBox::TextSpec StreetTile::makeLabelSpec(const sf::String& label) const {
+    TextBox::TextSpec spec{ &label, &m_font, TextBox::Alignment::Center };
+    spec.fillColor = sf::Color::Black;
+    return spec;
 }
 
 void StreetTile::updateOwnerTextBox() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <memory_resource>
 #include "Player.hpp"
 #include "TextBox.hpp"
 
@@ -31,9 +32,11 @@ public:
      *  @param font The font used for displaying text.
      *  @param direction The initial reading direction for text (default is Up).
      *  @param stripColor The color of the owner stripe (default is Blue).
+     *  @param textMemory Where the text boxes keep their texts (default is the heap), it must outlive the tile.
      */
     StreetTile(const std::string& name, unsigned int price, sf::Font& font,
-               ReadingDirection direction = ReadingDirection::Up, sf::Color stripColor = sf::Color::Blue);
+               ReadingDirection direction = ReadingDirection::Up, sf::Color stripColor = sf::Color::Blue,
+               std::pmr::memory_resource* textMemory = std::pmr::get_default_resource());
 
     /** @brief Executes actions when a player lands on the tile and returns the next menu to display.
      *
@@ -47,7 +50,7 @@ public:
     std::string getName() const;
     void setName(const std::string& name);
     // m_landingPlayerName
-    std::string getLandingPlayerName() const;
+    const std::string& getLandingPlayerName() const;
     void setLandingPlayerName(const std::string& landingPlayerName);
     // m_readingDirection
     ReadingDirection getReadingDirection() const;
@@ -76,6 +79,8 @@ public:
 
     /** @brief Sets the building type on the StreetTile and updates the text display.
      *
+     *  this only shows the buildings, the building rules (monopolies, even building, the bank's supply) are
+     *  enforced by the game (see BuildingEngine), and the tile shows whatever level the game reached.
      *  @param buildingType The type of building to set.
      */
     void setBuildingType(BuildingType buildingType);
@@ -92,13 +97,25 @@ public:
      */
     unsigned int calcRent();
 
+    /** @brief Adds the text boxes of the tile to a list, for the layout pass.
+     *
+     *  @param textBoxes The list to add to.
+     */
+    void collectTextBoxes(std::vector<const TextBox*>& textBoxes) const;
+
 private:
+    // the benchmarks time the private layout functions directly
+    friend class BenchmarkAccess;
+
     /** @brief Adjusts the graphical components of the tile according to the data contained in the tile.
      *
      *  This function should be called right after a change to the data has accured.
      */
     void adjustAllComponents();
 
+    /** @brief Adjusts the position and size of the components, for a change of the bounds that leaves the texts as they are. */
+    void adjustGeometry();
+
     /** @brief Converts ReadingDirection to TextBox::TextDirection.
      *
      *  @param direction The reading direction to convert.
@@ -118,6 +135,9 @@ private:
     /** @brief Updates the main text box content based on the current state. */
     void updateTextBox();
 
+    /** @brief Makes the spec of a label drawn on the tile: centered, black, in the tile's font. */
+    TextBox::TextSpec makeLabelSpec(const sf::String& label) const;
+
     /** @brief Updates the owner text box content. */
     void updateOwnerTextBox();
 
@@ -131,6 +151,7 @@ private:
     //* MEMBERS
     // From Tile
     std::string m_name;                   ///< Name of the street.
+    const sf::String* m_nameLabel;        ///< The interned name, shown on the tile.
     std::string m_landingPlayerName;      ///< Name of the player landing on the tile.
     sf::Font& m_font;                     ///< Font used for displaying text.
     sf::FloatRect m_bounds;               ///< The bounds of the tile.
@@ -139,6 +160,7 @@ private:
     // From PropertyTile
     unsigned int m_price;                 ///< Price of the street.
     Player* m_owner;                      ///< The owner of the street tile.
+    const sf::String* m_ownerLabel;       ///< The interned name of the owner, nullptr without one.
 
     // Specific to StreetTile
     float m_colorStripThickness;          ///< Thickness of the color strip.
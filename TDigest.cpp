@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "TDigest.hpp"
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    // the centroids a compression leaves are fewer than this, with room to spare
+    constexpr unsigned int MAX_CENTROIDS = 2 * TDigest::COMPRESSION;
+
+    // the k1 scale function, a centroid spans at most one unit of it
+    double scale(double quantile){
+        return TDigest::COMPRESSION / (2.0 * PI) * std::asin(2.0 * std::min(1.0, std::max(0.0, quantile)) - 1.0);
+    }
+}
+
+TDigest::TDigest()
+    : m_totalWeight(0.0),
+      m_min(std::numeric_limits<double>::infinity()),
+      m_max(-std::numeric_limits<double>::infinity())
+{
+}
+
+void TDigest::add(double value){
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    addCentroid(Centroid{ value, 1.0 });
+}
+
+void TDigest::merge(const TDigest& other){
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    for (const Centroid& centroid : other.m_centroids) {
+        addCentroid(centroid);
+    }
+    for (const Centroid& centroid : other.m_buffer) {
+        addCentroid(centroid);
+    }
+}
+
+void TDigest::save(Protocol::Writer& writer) const {
+    writer.f64(m_totalWeight);
+    writer.f64(m_min);
+    writer.f64(m_max);
+    for (const std::vector<Centroid>* centroids : { &m_centroids, &m_buffer }) {
+        writer.u32(static_cast<std::uint32_t>(centroids->size()));
+        for (const Centroid& centroid : *centroids) {
+            writer.f64(centroid.mean);
+            writer.f64(centroid.weight);
+        }
+    }
+}
+
+bool TDigest::load(Protocol::Reader& reader){
+    m_totalWeight = reader.f64();
+    m_min = reader.f64();
+    m_max = reader.f64();
+    for (std::vector<Centroid>* centroids : { &m_centroids, &m_buffer }) {
+        std::uint32_t size = reader.u32();
+        if (size > MAX_CENTROIDS + BUFFER_SIZE) {
+            return false;
+        }
+        centroids->clear();
+        for (std::uint32_t i = 0; i < size && reader.ok(); i++) {
+            double mean = reader.f64();
+            double weight = reader.f64();
+            centroids->push_back(Centroid{ mean, weight });
+        }
+    }
+    return reader.ok() && m_buffer.size() <= BUFFER_SIZE;
+}
+
+double TDigest::getQuantile(double quantile){
+    compress();
+    if (m_centroids.empty()) {
+        return 0.0;
+    }
+    if (m_centroids.size() == 1) {
+        return m_centroids[0].mean;
+    }
+
+    // between the centers of two neighbor centroids the values are taken as spread evenly, and between the
+    // extremes and the centers of the outer centroids too
+    double target = std::min(1.0, std::max(0.0, quantile)) * m_totalWeight;
+    const Centroid& first = m_centroids.front();
+    if (target < first.weight / 2.0) {
+        return m_min + (first.mean - m_min) * target / (first.weight / 2.0);
+    }
+    double before = 0.0;
+    for (std::size_t i = 0; i + 1 < m_centroids.size(); i++) {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        double leftCenter = before + left.weight / 2.0;
+        double rightCenter = before + left.weight + right.weight / 2.0;
+        if (target <= rightCenter) {
+            return left.mean + (right.mean - left.mean) * (target - leftCenter) / (rightCenter - leftCenter);
+        }
+        before += left.weight;
+    }
+    const Centroid& last = m_centroids.back();
+    double lastCenter = m_totalWeight - last.weight / 2.0;
+    return std::min(m_max, last.mean + (m_max - last.mean) * (target - lastCenter) / (last.weight / 2.0));
+}
+
+std::uint64_t TDigest::getCount() const {
+    return static_cast<std::uint64_t>(m_totalWeight);
+}
+
+double TDigest::getMin() const {
+    return m_totalWeight > 0.0 ? m_min : 0.0;
+}
+
+double TDigest::getMax() const {
+    return m_totalWeight > 0.0 ? m_max : 0.0;
+}
+
+std::size_t TDigest::getMemoryUsage() const {
+    return sizeof(*this) + (m_centroids.capacity() + m_buffer.capacity() + m_merged.capacity()) * sizeof(Centroid);
+}
+
+void TDigest::addCentroid(const Centroid& centroid){
+    if (m_buffer.size() == BUFFER_SIZE) {
+        compress();
+    }
+    m_buffer.push_back(centroid);
+    m_totalWeight += centroid.weight;
+}
+
+void TDigest::compress(){
+    if (m_buffer.empty()) {
+        return;
+    }
+    m_centroids.reserve(MAX_CENTROIDS);
+    m_merged.reserve(MAX_CENTROIDS + BUFFER_SIZE);
+    m_merged.assign(m_centroids.begin(), m_centroids.end());
+    m_merged.insert(m_merged.end(), m_buffer.begin(), m_buffer.end());
+    m_buffer.clear();
+    std::sort(m_merged.begin(), m_merged.end(), [](const Centroid& a, const Centroid& b){ return a.mean < b.mean; });
+
+    // a centroid takes in its neighbors while it spans less than one unit of the scale
+    m_centroids.clear();
+    Centroid current = m_merged[0];
+    double before = 0.0;
+    double scaleBefore = scale(0.0);
+    for (std::size_t i = 1; i < m_merged.size(); i++) {
+        const Centroid& next = m_merged[i];
+        if (scale((before + current.weight + next.weight) / m_totalWeight) - scaleBefore <= 1.0) {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            m_centroids.push_back(current);
+            before += current.weight;
+            scaleBefore = scale(before / m_totalWeight);
+            current = next;
+        }
+    }
+    m_centroids.push_back(current);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Protocol.hpp"
+
+/** @class TDigest
+ *
+ * @brief Estimates the quantiles of a stream of values in a fixed amount of memory, and merges with other digests.
+ *
+ * The values are summed up by centroids (a mean and a weight), small near both ends of the distribution and large
+ * in the middle, so the tails stay accurate. The size of a centroid is bounded by the k1 scale function of
+ * Dunning's merging t-digest: a centroid spans at most one unit of k(q) = COMPRESSION / (2 pi) * asin(2q - 1), which
+ * keeps at most about COMPRESSION centroids however many values were added.
+ *
+ * New values go to a buffer first, and are merged into the centroids in one sorted pass when it fills up, so
+ * adding a value costs a store most of the time. Merging another digest adds its centroids as if they were values.
+ * The buffer and the centroids are allocated as they fill, up to their bounds, so a digest of a few values stays small
+ * and no digest grows past about 23KB.
+ */
+class TDigest {
+public:
+    /** @brief The accuracy of the digest, the centroids are at most about this many. */
+    static constexpr unsigned int COMPRESSION = 100;
+
+    /** @brief The values kept before merging them into the centroids. */
+    static constexpr unsigned int BUFFER_SIZE = 512;
+
+    TDigest();
+
+    /** @brief Adds a value. */
+    void add(double value);
+
+    /** @brief Adds all the values of another digest. */
+    void merge(const TDigest& other);
+
+    /** @brief Writes the centroids and the buffer, so load() gives back the very same digest. */
+    void save(Protocol::Writer& writer) const;
+
+    /** @brief Reads a digest written by save().
+     *
+     * @return If the digest read is whole.
+     */
+    bool load(Protocol::Reader& reader);
+
+    /** @brief Estimates a quantile, merging the buffered values first.
+     *
+     * @param quantile Between 0 (the smallest value) and 1 (the largest).
+     * @return The estimate, 0 if there are no values.
+     */
+    double getQuantile(double quantile);
+
+    //* Getters
+    /** @brief Gets the number of values added. */
+    std::uint64_t getCount() const;
+    double getMin() const;
+    double getMax() const;
+    /** @brief Gets the bytes the digest takes. */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /** @brief Values close to each other, summed up by their mean. */
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    /** @brief Adds a centroid to the buffer, merging the buffer when it's full. */
+    void addCentroid(const Centroid& centroid);
+
+    /** @brief Merges the buffer into the centroids. */
+    void compress();
+
+    //* MEMBERS
+    std::vector<Centroid> m_centroids;     ///< Sorted by mean.
+    std::vector<Centroid> m_buffer;        ///< Not sorted.
+    std::vector<Centroid> m_merged;        ///< The centroids being merged, kept to never allocate.
+    double m_totalWeight;                  ///< The weight of the centroids and the buffer.
+    double m_min;
+    double m_max;
+};
@@ -1,11 +1,22 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <vector>
+#include "LabelTable.hpp"
+#include "Profiler.hpp"
 #include "TextBox.hpp"
 
-TextBox::TextBox(const sf::FloatRect& bounds)
+LayoutCache* TextBox::s_layoutCache = nullptr;
+std::atomic<std::uint64_t> TextBox::s_fullUpdates(0);
+std::atomic<std::uint64_t> TextBox::s_incrementalUpdates(0);
+
+TextBox::TextBox(const sf::FloatRect& bounds, std::pmr::memory_resource* memory)
     : m_bounds(bounds)
     , m_textDirection(TextDirection::Up)
+    , m_textEntries(memory)
+    , m_displayTexts(memory)
     , m_needsUpdate(true)
+    , m_needsRebuild(true)
+    , m_laidOutFontSize(0)
 {
     // Initialize background rectangle
     m_background.setPosition(sf::Vector2f(m_bounds.left, m_bounds.top));
@@ -23,6 +34,8 @@ TextBox::TextBox(
     : m_bounds(bounds)
     , m_textDirection(direction)
     , m_needsUpdate(true)
+    , m_needsRebuild(true)
+    , m_laidOutFontSize(0)
 {
     setTexts(texts);
 
@@ -40,13 +53,21 @@ void TextBox::setTextDirection(TextDirection direction)
     {
         m_textDirection = direction;
         m_needsUpdate = true;
+        m_needsRebuild = true;
     }
 }
 
 void TextBox::addText(const sf::Text& text, Alignment alignment)
 {
-    m_textEntries.push_back({ text, alignment });
+    addText(makeSpec(text, alignment));
+}
+
+void TextBox::addText(const TextSpec& text)
+{
+    m_textEntries.push_back(text);
+    m_displayTexts.reserve(m_textEntries.size());
     m_needsUpdate = true;
+    m_needsRebuild = true;
 }
 
 void TextBox::setBounds(const sf::FloatRect& bounds)
@@ -59,11 +80,31 @@ void TextBox::setBounds(const sf::FloatRect& bounds)
 
 void TextBox::setTexts(const std::vector<std::pair<sf::Text, Alignment>>& texts){
     m_textEntries.clear();
+    m_textEntries.reserve(texts.size());
     for (const auto& pair : texts)
     {
-        m_textEntries.push_back({ pair.first, pair.second });
+        m_textEntries.push_back(makeSpec(pair.first, pair.second));
     }
+    m_displayTexts.reserve(m_textEntries.size());
+    m_needsUpdate = true;
+    m_needsRebuild = true;
+}
+
+void TextBox::setTexts(const TextSpec* texts, std::size_t count)
+{
+    // setting the same texts again keeps the display texts as they are
+    if (count == m_textEntries.size() && std::equal(texts, texts + count, m_textEntries.begin(), isSameSpec))
+        return;
+
+    m_textEntries.assign(texts, texts + count);
+    m_displayTexts.reserve(m_textEntries.size());
     m_needsUpdate = true;
+    m_needsRebuild = true;
+}
+
+void TextBox::setTexts(std::initializer_list<TextSpec> texts)
+{
+    setTexts(texts.begin(), texts.size());
 }
 
 void TextBox::setBackgroundColor(const sf::Color& color)
@@ -81,13 +122,35 @@ void TextBox::setOutlineThickness(float thickness)
     m_background.setOutlineThickness(thickness);
 }
 
-void TextBox::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void TextBox::setLayoutCache(LayoutCache* cache)
+{
+    s_layoutCache = cache;
+}
+
+bool TextBox::needsLayout() const
+{
+    return m_needsUpdate;
+}
+
+void TextBox::layout(const FontSubstitutes* substitutes) const
 {
     if (m_needsUpdate)
     {
-        update();
+        update(substitutes);
         m_needsUpdate = false;
     }
+}
+
+TextBox::UpdateCounts TextBox::takeUpdateCounts()
+{
+    return { s_fullUpdates.exchange(0, std::memory_order_relaxed),
+             s_incrementalUpdates.exchange(0, std::memory_order_relaxed) };
+}
+
+void TextBox::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    // a no-op when the layout pass already laid the texts out
+    layout();
 
     states.transform *= getTransform();
 
@@ -100,58 +163,193 @@ void TextBox::draw(sf::RenderTarget& target, sf::RenderStates states) const
     }
 }
 
-void TextBox::update() const
+void TextBox::update(const FontSubstitutes* substitutes) const
 {
-    m_displayTexts.clear();
+    PROFILE_ZONE("TextBox::update");
 
-    if (m_textEntries.empty())
+    // moved without resizing, the layout is the same one shifted
+    if (moveLayout())
         return;
 
+    // a cached layout skips all the measuring
+    std::uint64_t key = 0;
+    bool cacheable = s_layoutCache && computeLayoutKey(key);
+    TextLayout layout;
+    if (!cacheable || !s_layoutCache->find(key, layout))
+    {
+        layout = computeLayout(substitutes);
+        if (cacheable)
+            s_layoutCache->insert(key, layout);
+    }
+
+    applyLayout(layout);
+    m_laidOutBounds = m_bounds;
+    m_needsRebuild = false;
+}
+
+TextLayout TextBox::computeLayout(const FontSubstitutes* substitutes) const
+{
+    TextLayout layout;
+    if (m_textEntries.empty())
+        return layout;
+
     // Compute the maximum font size that will fit the texts within the bounds
-    unsigned int fontSize = computeMaxFontSize();
+    layout.fontSize = computeMaxFontSize(substitutes);
 
     float positionOffset = 0.f; // Accumulated offset along the stacking direction
 
     for (const auto& entry : m_textEntries)
     {
-        const sf::String& string = entry.text.getString();
-        const sf::Font* font = entry.text.getFont();
+        const sf::Font* font = getMeasureFont(entry.font, substitutes);
         if (!font)
-            continue; // Can't process without font
-
-        sf::Text text;
-        text.setFont(*font);
-        text.setString(string);
-        text.setCharacterSize(fontSize);
-
-        // Copy additional properties
-        text.setFillColor(entry.text.getFillColor());
-        text.setStyle(entry.text.getStyle());
-        text.setOutlineColor(entry.text.getOutlineColor());
-        text.setOutlineThickness(entry.text.getOutlineThickness());
+        {
+            layout.placements.push_back({}); // Can't process without font, keep the placements in step with the entries
+            continue;
+        }
 
-        // Set rotation
-        float rotationAngle = getRotationAngle();
-        text.setRotation(rotationAngle);
+        sf::Text text = makeDisplayText(entry, *font, layout.fontSize);
 
         // Get local bounds after setting character size
         sf::FloatRect lb = text.getLocalBounds();
 
         // Adjust origin and position to keep text within bounds after rotation
         adjustTextPosition(text, lb, entry.alignment, positionOffset);
-
-        // Add to display list
-        m_displayTexts.push_back(text);
+        layout.placements.push_back({ text.getOrigin(), text.getPosition() });
 
         // Update position offset for next text
-        float lineSpacing = font->getLineSpacing(fontSize);
+        float lineSpacing = font->getLineSpacing(layout.fontSize);
 
         positionOffset += lineSpacing;
     }
+    return layout;
+}
+
+void TextBox::applyLayout(const TextLayout& layout) const
+{
+    // the same texts in the same size keep their glyphs, only their placements change
+    bool rebuild = m_needsRebuild || layout.fontSize != m_laidOutFontSize;
+    (rebuild ? s_fullUpdates : s_incrementalUpdates).fetch_add(1, std::memory_order_relaxed);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_textEntries.size() && i < layout.placements.size(); i++)
+    {
+        const TextSpec& entry = m_textEntries[i];
+        if (!entry.font)
+            continue;
+
+        // reuse the display texts there are, a new one is within the capacity reserved for the entries
+        if (count == m_displayTexts.size())
+            m_displayTexts.emplace_back();
+        sf::Text& text = m_displayTexts[count++];
+        if (rebuild)
+            configureDisplayText(text, entry, *entry.font, layout.fontSize);
+        text.setOrigin(layout.placements[i].origin);
+        text.setPosition(layout.placements[i].position);
+    }
+    m_displayTexts.erase(m_displayTexts.begin() + count, m_displayTexts.end());
+    m_laidOutFontSize = layout.fontSize;
+}
+
+bool TextBox::moveLayout() const
+{
+    if (m_needsRebuild || m_bounds.width != m_laidOutBounds.width || m_bounds.height != m_laidOutBounds.height)
+        return false;
+
+    sf::Vector2f offset(m_bounds.left - m_laidOutBounds.left, m_bounds.top - m_laidOutBounds.top);
+    for (auto& text : m_displayTexts)
+    {
+        text.move(offset);
+    }
+    m_laidOutBounds = m_bounds;
+    s_incrementalUpdates.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+sf::Text TextBox::makeDisplayText(const TextSpec& entry, const sf::Font& font, unsigned int fontSize) const
+{
+    sf::Text text;
+    configureDisplayText(text, entry, font, fontSize);
+    return text;
+}
+
+void TextBox::configureDisplayText(sf::Text& text, const TextSpec& entry, const sf::Font& font, unsigned int fontSize) const
+{
+    // sf::Text only rebuilds its glyphs when one of these actually changed, and assigning the string reuses its storage
+    text.setFont(font);
+    text.setString(*entry.string);
+    text.setCharacterSize(fontSize);
+
+    // Copy additional properties
+    text.setFillColor(entry.fillColor);
+    text.setStyle(entry.style);
+    text.setOutlineColor(entry.outlineColor);
+    text.setOutlineThickness(entry.outlineThickness);
+
+    // Set rotation
+    text.setRotation(getRotationAngle());
+}
+
+bool TextBox::isSameSpec(const TextSpec& a, const TextSpec& b)
+{
+    return a.string == b.string && a.font == b.font && a.alignment == b.alignment && a.fillColor == b.fillColor
+        && a.style == b.style && a.outlineColor == b.outlineColor && a.outlineThickness == b.outlineThickness;
+}
+
+TextBox::TextSpec TextBox::makeSpec(const sf::Text& text, Alignment alignment)
+{
+    TextSpec spec{ &LabelTable::intern(text.getString()), text.getFont(), alignment };
+    spec.fillColor = text.getFillColor();
+    spec.style = text.getStyle();
+    spec.outlineColor = text.getOutlineColor();
+    spec.outlineThickness = text.getOutlineThickness();
+    return spec;
+}
+
+const sf::Font* TextBox::getMeasureFont(const sf::Font* font, const FontSubstitutes* substitutes)
+{
+    if (font && substitutes)
+    {
+        auto found = substitutes->find(font);
+        if (found != substitutes->end())
+            return found->second;
+    }
+    return font;
+}
+
+bool TextBox::computeLayoutKey(std::uint64_t& key) const
+{
+    // bump when the layout algorithm changes, so old cached layouts are not used
+    const std::uint32_t layoutVersion = 1;
+
+    std::uint64_t hash = LayoutCache::hashBytes(LayoutCache::HASH_SEED, &layoutVersion, sizeof(layoutVersion));
+    hash = LayoutCache::hashBytes(hash, &m_textDirection, sizeof(m_textDirection));
+    const float bounds[4] = { m_bounds.left, m_bounds.top, m_bounds.width, m_bounds.height };
+    hash = LayoutCache::hashBytes(hash, bounds, sizeof(bounds));
+
+    for (const auto& entry : m_textEntries)
+    {
+        std::uint64_t fontId;
+        if (!entry.font || !s_layoutCache->getFontId(entry.font, fontId))
+            return false;
+
+        const sf::String& string = *entry.string;
+        const std::uint64_t size = string.getSize();
+        const sf::Uint32 style = entry.style;
+        const float outlineThickness = entry.outlineThickness;
+        hash = LayoutCache::hashBytes(hash, &fontId, sizeof(fontId));
+        hash = LayoutCache::hashBytes(hash, &size, sizeof(size));
+        hash = LayoutCache::hashBytes(hash, string.getData(), size * sizeof(sf::Uint32));
+        hash = LayoutCache::hashBytes(hash, &style, sizeof(style));
+        hash = LayoutCache::hashBytes(hash, &outlineThickness, sizeof(outlineThickness));
+        hash = LayoutCache::hashBytes(hash, &entry.alignment, sizeof(entry.alignment));
+    }
+    key = hash;
+    return true;
 }
 
-unsigned int TextBox::computeMaxFontSize() const
+unsigned int TextBox::computeMaxFontSize(const FontSubstitutes* substitutes) const
 {
+    PROFILE_ZONE("TextBox::computeMaxFontSize");
     if (m_textEntries.empty())
         return 0;
 
@@ -167,8 +365,8 @@ unsigned int TextBox::computeMaxFontSize() const
         float totalStackLength = 0.0f; // Total length along the stacking direction
 
         for (const auto& entry : m_textEntries){
-            const sf::String& string = entry.text.getString();
-            const sf::Font* font = entry.text.getFont();
+            const sf::String& string = *entry.string;
+            const sf::Font* font = getMeasureFont(entry.font, substitutes);
             if (!font)
             {
                 fits = false;
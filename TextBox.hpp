@@ -1,7 +1,14 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <unordered_map>
 #include <vector>
+#include "LayoutCache.hpp"
 
 //* CLASS + DEFINITIONS
 /**
@@ -33,12 +40,44 @@ public:
         Right  ///< 270 degrees rotation
     };
 
+    /** @brief A text to display: its string (e.g. an interned label, see LabelTable), font, style and alignment.
+     *
+     * A spec only references its string and font, so setting texts from specs copies a few bytes per text.
+     */
+    struct TextSpec {
+        const sf::String* string;                   ///< The string, it must outlive the text box (or its next setTexts).
+        const sf::Font* font;                       ///< The font, nullptr texts are skipped.
+        Alignment alignment = Alignment::Left;
+        sf::Color fillColor = sf::Color::White;
+        sf::Uint32 style = sf::Text::Regular;
+        sf::Color outlineColor = sf::Color::Black;
+        float outlineThickness = 0.f;
+    };
+
+    /** @brief Maps the fonts of the texts to the copies a layout worker measures with instead.
+     *
+     * sf::Font loads its glyphs lazily, so measuring with one font from several threads isn't safe.
+     */
+    using FontSubstitutes = std::unordered_map<const sf::Font*, const sf::Font*>;
+
+    /** @brief The number of display text updates of each kind, see takeUpdateCounts().
+     *
+     * A full update rebuilds the glyphs of the texts, after their strings, styles or font size changed.
+     * An incremental update keeps the glyphs and only moves the texts, after the bounds moved or resized
+     * without changing the font size.
+     */
+    struct UpdateCounts {
+        std::uint64_t full;
+        std::uint64_t incremental;
+    };
+
     //* CONSTRUCTORS
         /** @brief Constructs a TextBox with the specified bounds.
          *
          * @param bounds The bounding rectangle for the text box.
+         * @param memory Where the texts are kept (default is the heap), it must outlive the text box.
          */
-        TextBox(const sf::FloatRect& bounds);
+        TextBox(const sf::FloatRect& bounds, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
         /** @brief Constructs a TextBox with bounds, texts, direction, and background color.
          *
@@ -57,16 +96,29 @@ public:
 
         /** @brief Sets the texts to be displayed in the text box, overwriting any existing texts.
          *
+         * the strings are interned in the LabelTable, prefer the TextSpec overloads for texts that change often.
          * @param texts A vector of pairs of sf::Text and Alignment.
          */
         void setTexts(const std::vector<std::pair<sf::Text, Alignment>>& texts);
 
+        /** @brief Sets the texts to be displayed in the text box, overwriting any existing texts.
+         *
+         * this doesn't allocate once the text box held as many texts before.
+         * @param texts The specs of the texts.
+         * @param count The number of texts.
+         */
+        void setTexts(const TextSpec* texts, std::size_t count);
+        void setTexts(std::initializer_list<TextSpec> texts);
+
         /** @brief Adds a text with the specified alignment to the text box.
          *
-         * @param text The sf::Text to add.
+         * @param text The sf::Text to add, its string is interned in the LabelTable.
          * @param alignment The alignment for the text (default is Left).
          */
         void addText(const sf::Text& text, Alignment alignment = Alignment::Left);
+
+        /** @brief Adds a text to the text box. */
+        void addText(const TextSpec& text);
     
         /**
          * @brief Sets the text direction (rotation) for the text box.
@@ -105,12 +157,36 @@ public:
          */
         void setOutlineThickness(float thickness);
 
+    //* LAYOUT CACHE
+
+        /** @brief Sets the cache every TextBox looks its layout up in before measuring its texts.
+         *
+         * @param cache The cache, nullptr to always measure (the default).
+         */
+        static void setLayoutCache(LayoutCache* cache);
+
+    //* LAYOUT PASS
+
+        /** @brief Whether the texts must be laid out before the next draw. */
+        bool needsLayout() const;
+
+        /** @brief Lays out the texts now, instead of on the next draw.
+         *
+         * Different text boxes can be laid out from different threads, as long as each thread measures
+         * with its own fonts. The fonts of the texts are only measured on the calling thread when there are no substitutes.
+         * @param substitutes The fonts to measure with instead of the fonts of the texts, nullptr for none.
+         */
+        void layout(const FontSubstitutes* substitutes = nullptr) const;
+
+        /** @brief Gets the updates of all the text boxes since the last call, and starts counting again.
+         *
+         * called once a frame, it gives the updates per frame.
+         */
+        static UpdateCounts takeUpdateCounts();
+
 private:
-    /** @brief Struct to hold a text and its alignment. */
-    struct TextEntry{
-        sf::Text text;
-        Alignment alignment;
-    };
+    // the benchmarks time the private layout functions directly
+    friend class BenchmarkAccess;
 
     /** @brief Draws the TextBox to the render target.
      *
@@ -119,14 +195,51 @@ private:
      */
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
-    /** @brief Updates the display texts based on the current state.*/
-    void update() const;
+    /** @brief Updates the display texts based on the current state.
+     *
+     * the layout is taken from the layout cache when it's there, otherwise it's computed (and cached).
+    */
+    void update(const FontSubstitutes* substitutes = nullptr) const;
+
+    /** @brief Measures the texts and computes their font size and placements. */
+    TextLayout computeLayout(const FontSubstitutes* substitutes) const;
+
+    /** @brief Places the display texts by a layout, rebuilding them only when their texts or font size changed. */
+    void applyLayout(const TextLayout& layout) const;
+
+    /** @brief Moves the display texts along with the bounds, when the bounds only moved since the last layout.
+     *
+     * @return Whether the texts were moved, otherwise they must be laid out again.
+     */
+    bool moveLayout() const;
+
+    /** @brief Creates the text displayed for an entry, in the given font and size, rotated to the text direction. */
+    sf::Text makeDisplayText(const TextSpec& entry, const sf::Font& font, unsigned int fontSize) const;
+
+    /** @brief Configures an existing text to display an entry, reusing its string and vertex storage. */
+    void configureDisplayText(sf::Text& text, const TextSpec& entry, const sf::Font& font, unsigned int fontSize) const;
+
+    /** @brief Whether two specs display the same text the same way. */
+    static bool isSameSpec(const TextSpec& a, const TextSpec& b);
+
+    /** @brief Makes a spec out of an sf::Text, interning its string. */
+    static TextSpec makeSpec(const sf::Text& text, Alignment alignment);
+
+    /** @brief Gets the font a text is measured with: its substitute if there is one, otherwise the font itself. */
+    static const sf::Font* getMeasureFont(const sf::Font* font, const FontSubstitutes* substitutes);
+
+    /** @brief Computes the key of the layout in the layout cache, from everything the layout depends on.
+     *
+     * @return Whether the layout can be cached (all the fonts are registered in the cache).
+     */
+    bool computeLayoutKey(std::uint64_t& key) const;
 
     /** @brief Computes the maximum font size that will fit all texts within the bounds.
      *
+     *  @param substitutes The fonts to measure with instead of the fonts of the texts, nullptr for none.
      *  @return The maximum font size.
      */
-    unsigned int computeMaxFontSize() const;
+    unsigned int computeMaxFontSize(const FontSubstitutes* substitutes = nullptr) const;
 
     /** @brief Gets the rotation angle in degrees based on the text direction.
      *
@@ -160,13 +273,15 @@ private:
          * 
          * the texts here aren't configured for display
          */
-        std::vector<TextEntry> m_textEntries;
+        std::pmr::vector<TextSpec> m_textEntries;
 
         /** @brief The vector of texts ready for display.
          *
          * This vector is mutable because it is updated in the const draw function.
+         * its capacity is kept at least the number of entries (on the thread setting the texts), so laying out
+         * never allocates from the memory resource, which may not be thread safe.
          */
-        mutable std::vector<sf::Text> m_displayTexts;
+        mutable std::pmr::vector<sf::Text> m_displayTexts;
 
         /** @brief Flag indicating whether the display texts need to be updated before drawing.
          *
@@ -174,6 +289,22 @@ private:
          */  
         mutable bool m_needsUpdate;
 
+        /** @brief Flag indicating whether the texts or their direction changed since the display texts were built,
+         *  so their glyphs must be rebuilt and not only moved.
+         */
+        mutable bool m_needsRebuild;
+
+        /** @brief The bounds and font size the display texts were laid out for. */
+        mutable sf::FloatRect m_laidOutBounds;
+        mutable unsigned int m_laidOutFontSize;
+
         /** @brief The background rectangle shape of the text box. */
         sf::RectangleShape m_background;
+
+        /** @brief The cache of layouts shared by all the text boxes, nullptr for none. */
+        static LayoutCache* s_layoutCache;
+
+        /** @brief The updates since the last takeUpdateCounts(), from any thread. */
+        static std::atomic<std::uint64_t> s_fullUpdates;
+        static std::atomic<std::uint64_t> s_incrementalUpdates;
 };
\ No newline at end of file
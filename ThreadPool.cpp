@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <string>
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int numWorkers)
+    : m_numWorkers(numWorkers ? numWorkers : std::max(1u, std::thread::hardware_concurrency())),
+      m_function(nullptr),
+      m_count(0),
+      m_generation(0),
+      m_busyThreads(0),
+      m_stopping(false),
+      m_nextIndex(0)
+{
+    // the calling thread is worker 0
+    for (unsigned int worker = 1; worker < m_numWorkers; worker++) {
+        m_threads.emplace_back([this, worker]{ workerLoop(worker); });
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobReady.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const Function& function){
+    if (count == 0) {
+        return;
+    }
+    // not worth waking the threads for a single iteration
+    if (m_threads.empty() || count == 1) {
+        for (std::size_t i = 0; i < count; i++) {
+            function(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_function = &function;
+        m_count = count;
+        m_nextIndex.store(0, std::memory_order_relaxed);
+        m_busyThreads = static_cast<unsigned int>(m_threads.size());
+        m_generation++;
+    }
+    m_jobReady.notify_all();
+
+    runIterations(0);
+
+    // the function must outlive every thread still running an iteration
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this]{ return m_busyThreads == 0; });
+    m_function = nullptr;
+}
+
+unsigned int ThreadPool::getNumWorkers() const {
+    return m_numWorkers;
+}
+
+void ThreadPool::workerLoop(unsigned int worker){
+    Profiler::setThreadName("pool " + std::to_string(worker));
+    std::uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [&]{ return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        runIterations(worker);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyThreads == 0) {
+            m_jobDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runIterations(unsigned int worker){
+    // m_function and m_count were written under the mutex before the job was announced
+    while (true) {
+        std::size_t index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_count) {
+            return;
+        }
+        (*m_function)(index, worker);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @class ThreadPool
+ *
+ * @brief A fixed set of threads that run the iterations of a loop in parallel.
+ *
+ * The thread calling parallelFor() works too, as worker 0, so a pool of one worker runs everything
+ * on the calling thread without any synchronization. Iterations are handed out one at a time from an
+ * atomic counter, so uneven iterations still balance across the workers.
+ */
+class ThreadPool {
+public:
+    /** @brief The function run for every iteration, with the index of the iteration and of the worker running it. */
+    using Function = std::function<void(std::size_t index, unsigned int worker)>;
+
+    /** @brief Starts the threads of the pool.
+     *
+     * @param numWorkers The number of workers including the calling thread, 0 for one per core.
+     */
+    explicit ThreadPool(unsigned int numWorkers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @brief Runs function(index, worker) for every index in [0, count) and waits for all of them.
+     *
+     * Only one thread may call it at a time. worker is smaller than getNumWorkers(), and no two
+     * iterations run on the same worker at once, so per-worker state needs no locking.
+     */
+    void parallelFor(std::size_t count, const Function& function);
+
+    /** @brief Gets the number of workers, including the calling thread. */
+    unsigned int getNumWorkers() const;
+
+private:
+    /** @brief The loop of a pool thread: waits for a job and helps run it. */
+    void workerLoop(unsigned int worker);
+
+    /** @brief Claims and runs iterations of the current job until none are left. */
+    void runIterations(unsigned int worker);
+
+    //* MEMBERS
+    unsigned int m_numWorkers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;                      ///< Guards the job fields below.
+    std::condition_variable m_jobReady;      ///< Signaled when a job starts or on destruction.
+    std::condition_variable m_jobDone;       ///< Signaled when the last pool thread leaves a job.
+    const Function* m_function;              ///< The function of the current job.
+    std::size_t m_count;                     ///< The number of iterations of the current job.
+    std::uint64_t m_generation;              ///< Incremented on every job, so the threads see new ones.
+    unsigned int m_busyThreads;              ///< The pool threads still working on the current job.
+    bool m_stopping;
+
+    std::atomic<std::size_t> m_nextIndex;    ///< The next iteration to claim.
+};
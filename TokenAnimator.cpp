@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "Profiler.hpp"
+#include "TokenAnimator.hpp"
+
+namespace {
+    // the most time one update advances, so a long stall doesn't turn into a burst of steps
+    constexpr float MAX_UPDATE_SECONDS = 0.25f;
+    // the distance between the tokens standing on the same tile, in token sizes
+    constexpr float TOKEN_SPACING = 1.25f;
+}
+
+TokenAnimator::TokenAnimator()
+    : m_tokenSize(0.f),
+      m_accumulator(0.f),
+      m_vertices(sf::Quads, MAX_TOKENS * 4)
+{
+    for (Token& token : m_tokens) {
+        token = Token{ false, false, 0.f, 0.f, 0.f, 0.f, sf::Color::Black };
+    }
+    writeVertices();
+}
+
+void TokenAnimator::setRing(std::vector<sf::Vector2f> centers, float tokenSize){
+    m_ring = std::move(centers);
+    m_tokenSize = tokenSize;
+    writeVertices();
+}
+
+void TokenAnimator::place(unsigned int token, unsigned int tile, const sf::Color& color){
+    if (token >= MAX_TOKENS) {
+        return;
+    }
+    float walk = static_cast<float>(tile);
+    m_tokens[token] = Token{ true, false, walk, walk, walk, 0.f, color };
+    writeVertices();
+}
+
+void TokenAnimator::move(unsigned int token, unsigned int tile){
+    if (token >= MAX_TOKENS || !m_tokens[token].visible || m_ring.empty()) {
+        return;
+    }
+    Token& moving = m_tokens[token];
+    // always forward, from wherever the token is now (it may still be walking to its last tile)
+    float numTiles = static_cast<float>(m_ring.size());
+    float distance = static_cast<float>(tile) - std::fmod(moving.current, numTiles);
+    if (distance < 0.f) {
+        distance += numTiles;
+    }
+    if (distance == 0.f && !moving.moving) {
+        return;
+    }
+    moving.target = moving.current + distance;
+    moving.speed = std::max(TILES_PER_SECOND, distance / MAX_MOVE_SECONDS);
+    moving.moving = true;
+}
+
+void TokenAnimator::hide(unsigned int token){
+    if (token >= MAX_TOKENS) {
+        return;
+    }
+    m_tokens[token].visible = false;
+    m_tokens[token].moving = false;
+    writeVertices();
+}
+
+std::uint32_t TokenAnimator::update(float seconds){
+    PROFILE_ZONE("TokenAnimator::update");
+    std::uint32_t arrived = 0;
+    float numTiles = static_cast<float>(std::max<std::size_t>(1, m_ring.size()));
+    m_accumulator += std::min(seconds, MAX_UPDATE_SECONDS);
+    while (m_accumulator >= STEP_SECONDS) {
+        m_accumulator -= STEP_SECONDS;
+        for (unsigned int i = 0; i < MAX_TOKENS; i++) {
+            Token& token = m_tokens[i];
+            token.previous = token.current;
+            if (!token.moving) {
+                continue;
+            }
+            token.current = std::min(token.current + token.speed * STEP_SECONDS, token.target);
+            if (token.current >= token.target) {
+                // arrived, the walk starts over from the tile so it stays small
+                float tile = std::fmod(token.target, numTiles);
+                token.previous = token.current = token.target = tile;
+                token.moving = false;
+                arrived |= 1u << i;
+            }
+        }
+    }
+    writeVertices();
+    return arrived;
+}
+
+unsigned int TokenAnimator::getTile(unsigned int token) const {
+    if (token >= MAX_TOKENS || m_ring.empty()) {
+        return 0;
+    }
+    return static_cast<unsigned int>(std::lround(m_tokens[token].target)) % m_ring.size();
+}
+
+bool TokenAnimator::isVisible(unsigned int token) const {
+    return token < MAX_TOKENS && m_tokens[token].visible;
+}
+
+bool TokenAnimator::isMoving(unsigned int token) const {
+    return token < MAX_TOKENS && m_tokens[token].moving;
+}
+
+sf::Vector2f TokenAnimator::getRingPoint(float walk) const {
+    std::size_t numTiles = m_ring.size();
+    float tile = std::floor(walk);
+    float fraction = walk - tile;
+    const sf::Vector2f& from = m_ring[static_cast<std::size_t>(tile) % numTiles];
+    const sf::Vector2f& to = m_ring[(static_cast<std::size_t>(tile) + 1) % numTiles];
+    return from + (to - from) * fraction;
+}
+
+void TokenAnimator::writeVertices(){
+    float alpha = m_accumulator / STEP_SECONDS;
+    for (unsigned int i = 0; i < MAX_TOKENS; i++) {
+        const Token& token = m_tokens[i];
+        sf::Vertex* quad = &m_vertices[i * 4];
+        if (!token.visible || m_ring.empty()) {
+            for (int corner = 0; corner < 4; corner++) {
+                quad[corner] = sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Color::Transparent);
+            }
+            continue;
+        }
+
+        // the tokens sharing a tile stand on a 3x3 grid around its center
+        sf::Vector2f center = getRingPoint(token.previous + (token.current - token.previous) * alpha);
+        center.x += (static_cast<float>(i % 3) - 1.f) * m_tokenSize * TOKEN_SPACING;
+        center.y += (static_cast<float>(i / 3) - 1.f) * m_tokenSize * TOKEN_SPACING;
+        float half = m_tokenSize / 2.f;
+        quad[0] = sf::Vertex(sf::Vector2f(center.x - half, center.y - half), token.color);
+        quad[1] = sf::Vertex(sf::Vector2f(center.x + half, center.y - half), token.color);
+        quad[2] = sf::Vertex(sf::Vector2f(center.x + half, center.y + half), token.color);
+        quad[3] = sf::Vertex(sf::Vector2f(center.x - half, center.y + half), token.color);
+    }
+}
+
+void TokenAnimator::draw(sf::RenderTarget& target, sf::RenderStates states) const{
+    target.draw(m_vertices, states);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+/** @class TokenAnimator
+ *
+ * @brief Walks the tokens of the players around the board, separately from the tiles.
+ *
+ * A token is a colored square drawn over the board, it walks the ring of the tile centers tile by tile instead of
+ * jumping, and the tiles aren't touched until it arrives. The walk advances in fixed steps of STEP_SECONDS whatever
+ * the frame rate, and what's drawn is interpolated between the last two steps, so the speed doesn't depend on the
+ * frame times. All the tokens are one vertex array allocated up front, so animating never allocates.
+ */
+class TokenAnimator : public sf::Drawable {
+public:
+    /** @brief The most tokens on the board, one per seat. */
+    static constexpr unsigned int MAX_TOKENS = 8;
+
+    /** @brief The time one step of the walk advances. */
+    static constexpr float STEP_SECONDS = 1.f / 120.f;
+
+    /** @brief The speed of the walk, faster when that's needed to keep a move under MAX_MOVE_SECONDS. */
+    static constexpr float TILES_PER_SECOND = 8.f;
+    static constexpr float MAX_MOVE_SECONDS = 1.f;
+
+    TokenAnimator();
+
+    /** @brief Sets the ring the tokens walk, e.g. after the board was laid out again.
+     *
+     * @param centers The centers of the tiles, in the order the players walk them.
+     * @param tokenSize The side of a token.
+     */
+    void setRing(std::vector<sf::Vector2f> centers, float tokenSize);
+
+    /** @brief Shows a token standing on a tile, without walking there. */
+    void place(unsigned int token, unsigned int tile, const sf::Color& color);
+
+    /** @brief Walks a shown token forward from where it is now to a tile. */
+    void move(unsigned int token, unsigned int tile);
+
+    /** @brief Hides a token. */
+    void hide(unsigned int token);
+
+    /** @brief Advances the walks by the time since the last update, in fixed steps.
+     *
+     * @param seconds The time since the last update.
+     * @return A bit for every token that arrived at its tile during this update.
+     */
+    std::uint32_t update(float seconds);
+
+    //* Getters
+    /** @brief Gets the tile a token stands on, or walks to. */
+    unsigned int getTile(unsigned int token) const;
+    bool isVisible(unsigned int token) const;
+    bool isMoving(unsigned int token) const;
+
+private:
+    /** @brief Where a token is, its walk is measured in tiles from the tile it started on. */
+    struct Token {
+        bool visible;
+        bool moving;
+        float previous;     ///< The walk at the step before the last one, to interpolate from.
+        float current;      ///< The walk at the last step.
+        float target;       ///< The walk at the tile it walks to.
+        float speed;        ///< Tiles per second.
+        sf::Color color;
+    };
+
+    /** @brief Gets the point of the ring a walk reached, between the centers of two tiles. */
+    sf::Vector2f getRingPoint(float walk) const;
+
+    /** @brief Rewrites the vertices of all the tokens, interpolated between their last two steps. */
+    void writeVertices();
+
+    /** @brief draw the tokens to the render target.
+     *
+     * this functions is of the sf::Drawable interface.
+     */
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    //* MEMBERS
+    Token m_tokens[MAX_TOKENS];
+    std::vector<sf::Vector2f> m_ring;   ///< The centers of the tiles.
+    float m_tokenSize;
+    float m_accumulator;                ///< The time not yet advanced, less than a step.
+    sf::VertexArray m_vertices;         ///< A quad per token.
+};
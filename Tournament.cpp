@@ -0,0 +1,542 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <unistd.h>
+#include <stdexcept>
+#include <utility>
+#include "Tournament.hpp"
+
+namespace {
+    // the bounds of the reported intervals, 95%
+    constexpr double REPORTED_Z = 1.96;
+    // the iterations of the Bradley-Terry fit, it converges long before
+    constexpr unsigned int RATING_ITERATIONS = 500;
+    // the Elo points of a factor 10 in strength, and the average rating
+    constexpr double ELO_SCALE = 400.0;
+    constexpr double ELO_AVERAGE = 1500.0;
+
+    // the counters of the calling thread, opened the first time it plays with them
+    PerfCounters& getThreadCounters(){
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    std::uint64_t mix(std::uint64_t value){
+        // the finalizer of SplitMix64, so close inputs give unrelated seeds
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    // the first bytes of a checkpoint, "MONOCKP" and its version
+    constexpr std::uint64_t CHECKPOINT_MAGIC = 0x01504B434F4E4F4Dull;
+
+    // a block of pairs of a matchup, one iteration of the thread pool
+    struct Block {
+        std::size_t matchup;
+        unsigned int firstPair;
+        unsigned int numPairs;
+        double score;
+        double sumSquares;
+        GameStats stats;                        ///< The games of the block, summed up in order once played.
+        std::vector<ResultWriter::Row> rows;    ///< The results of the games, written in order once played.
+    };
+}
+
+double Tournament::Matchup::getMean() const {
+    return pairs > 0 ? score / pairs : 0.5;
+}
+
+double Tournament::Matchup::getStandardError() const {
+    if (pairs < 2) {
+        return 0.5;
+    }
+    double mean = getMean();
+    double variance = std::max(0.0, (sumSquares / pairs - mean * mean) * pairs / (pairs - 1));
+    return std::sqrt(variance / pairs);
+}
+
+Tournament::Tournament(std::vector<BotPolicy> policies, const Options& options)
+    : m_policies(std::move(policies)),
+      m_options(options),
+      m_stats(BoardDefinition::standard().getNumTiles()),
+      m_results(nullptr),
+      m_checkpointInterval(0.0),
+      m_round(0),
+      m_roundFirst(0),
+      m_resumed(false),
+      m_countPerf(false),
+      m_perfAvailable(false)
+{
+    if (m_policies.size() < 2) {
+        throw std::invalid_argument("Tournament: at least 2 policies are needed");
+    }
+    m_options.batchPairs = std::max(1u, m_options.batchPairs);
+    m_options.waveBlocks = std::max(1u, m_options.waveBlocks);
+    m_options.maxPairs = std::max(m_options.maxPairs, m_options.minPairs);
+}
+
+void Tournament::run(ThreadPool& pool, std::ostream* log, ResultWriter* results){
+    m_results = results;
+    m_lastCheckpoint = std::chrono::steady_clock::now();
+    m_workerCounters.assign(m_countPerf ? pool.getNumWorkers() : 0, WorkerCounters{});
+    unsigned int numPolicies = static_cast<unsigned int>(m_policies.size());
+    if (m_options.format == Format::RoundRobin) {
+        if (!m_resumed) {
+            for (unsigned int first = 0; first < numPolicies; first++) {
+                for (unsigned int second = first + 1; second < numPolicies; second++) {
+                    m_matchups.push_back(Matchup{ first, second, 0, 0.0, 0.0, false });
+                }
+            }
+        }
+        playMatchups(pool, 0, log);
+    } else {
+        playSwissRounds(pool, log);
+    }
+    m_results = nullptr;
+}
+
+void Tournament::setPerfCounters(bool enabled){
+    m_countPerf = enabled;
+    m_perfAvailable = enabled && getThreadCounters().isAvailable();
+}
+
+void Tournament::setCheckpoint(const std::string& path, double intervalSeconds){
+    m_checkpointPath = path;
+    m_checkpointInterval = intervalSeconds;
+}
+
+bool Tournament::resume(const std::string& path, ResultWriter* results){
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in && !in.eof()) {
+        return false;
+    }
+
+    // only a checkpoint of the very same tournament goes on
+    Protocol::Reader reader(data.data(), data.size());
+    std::vector<std::uint8_t> expected;
+    Protocol::Writer writer(expected);
+    saveOptions(writer);
+    std::vector<std::uint8_t> options(expected.size());
+    reader.bytes(options.data(), options.size());
+    if (!reader.ok() || options != expected) {
+        return false;
+    }
+
+    m_round = reader.u32();
+    m_roundFirst = reader.u64();
+    std::uint64_t numMatchups = reader.u64();
+    if (numMatchups > data.size()) {
+        return false;
+    }
+    m_matchups.clear();
+    for (std::uint64_t i = 0; i < numMatchups && reader.ok(); i++) {
+        Matchup matchup;
+        matchup.first = reader.u32();
+        matchup.second = reader.u32();
+        matchup.pairs = reader.u32();
+        matchup.score = reader.f64();
+        matchup.sumSquares = reader.f64();
+        matchup.decided = reader.u8() != 0;
+        if (matchup.first >= m_policies.size() || matchup.second >= m_policies.size()) {
+            return false;
+        }
+        m_matchups.push_back(matchup);
+    }
+    if (!m_stats.load(reader)) {
+        return false;
+    }
+
+    // the results written before the checkpoint must be in the file, and no others
+    bool hasResults = reader.u8() != 0;
+    if (hasResults != (results != nullptr) || (results && !results->restore(reader))) {
+        return false;
+    }
+    m_resumed = reader.ok() && m_roundFirst <= m_matchups.size();
+    return m_resumed;
+}
+
+void Tournament::playSwissRounds(ThreadPool& pool, std::ostream* log){
+    unsigned int numPolicies = static_cast<unsigned int>(m_policies.size());
+
+    unsigned int rounds = m_options.rounds;
+    if (rounds == 0) {
+        rounds = static_cast<unsigned int>(std::ceil(std::log2(numPolicies))) + 2;
+    }
+    rounds = std::min(rounds, numPolicies - 1);
+
+    // a resumed tournament first ends the round it was playing
+    if (m_resumed) {
+        playMatchups(pool, m_roundFirst, log);
+    }
+    for (; m_round < rounds; ) {
+        std::vector<Matchup> pairings = pairSwissRound();
+        if (pairings.empty()) {
+            break;
+        }
+        if (log) {
+            *log << "round " << m_round + 1 << ": " << pairings.size() << " matchups" << std::endl;
+        }
+        m_round++;
+        m_roundFirst = m_matchups.size();
+        m_matchups.insert(m_matchups.end(), pairings.begin(), pairings.end());
+        playMatchups(pool, m_roundFirst, log);
+    }
+}
+
+double Tournament::playPair(const BotPolicy& first, const BotPolicy& second, std::uint64_t seed, unsigned int maxTurns,
+                            GameStats* stats, ResultWriter::Row* rows){
+    double score = 0.0;
+    for (unsigned int firstSeat = 0; firstSeat < 2; firstSeat++) {
+        const BotPolicy* seats[2] = { &first, &second };
+        if (firstSeat == 1) {
+            std::swap(seats[0], seats[1]);
+        }
+        GameState game(2, seed);
+        if (stats) {
+            stats->beginGame(game);
+        }
+        while (game.getPhase() != GameState::Phase::GameOver && game.getTurnCount() < maxTurns) {
+            Simulation::applyBotAction(game, *seats[game.getCurrentPlayer()]);
+        }
+
+        int winner = game.getWinner();
+        if (winner < 0) {
+            std::uint64_t worth0 = game.getNetWorth(0);
+            std::uint64_t worth1 = game.getNetWorth(1);
+            winner = worth0 > worth1 ? 0 : (worth0 < worth1 ? 1 : -1);
+        }
+        score += winner < 0 ? 0.5 : (winner == static_cast<int>(firstSeat) ? 1.0 : 0.0);
+        if (stats) {
+            stats->endGame(game, winner);
+        }
+        if (rows) {
+            ResultWriter::Row& row = rows[firstSeat];
+            row.seed = seed;
+            row.length = game.getTurnCount();
+            row.winner = static_cast<std::int8_t>(winner);
+            for (unsigned int seat = 0; seat < 2; seat++) {
+                row.money[seat] = game.getPlayer(seat).money;
+            }
+        }
+    }
+    return score / 2.0;
+}
+
+const std::vector<BotPolicy>& Tournament::getBuiltinPolicies(){
+    // the cash kept after buying, the cash kept after building, the level built up to, and trading
+    static const std::vector<BotPolicy> policies = {
+        { "standard", 0, 150, 5, true },
+        { "reserve0", 0, 0, 5, true },
+        { "reserve50", 0, 50, 5, true },
+        { "reserve300", 0, 300, 5, true },
+        { "reserve500", 0, 500, 5, true },
+        { "houses2", 0, 150, 2, true },
+        { "houses3", 0, 150, 3, true },
+        { "houses4", 0, 150, 4, true },
+        { "nobuild", 0, 150, 0, true },
+        { "notrade", 0, 150, 5, false },
+        { "notrade-reserve0", 0, 0, 5, false },
+        { "notrade-houses3", 0, 150, 3, false },
+        { "picky100", 100, 150, 5, true },
+        { "picky300", 300, 150, 5, true },
+        { "picky600", 600, 150, 5, true },
+        { "picky300-reserve0", 300, 0, 5, true },
+        { "picky100-houses3", 100, 150, 3, true },
+        { "reserve300-houses3", 0, 300, 3, true },
+        { "auctions-only", 100000, 150, 5, true },
+        { "cautious", 200, 400, 4, false },
+    };
+    return policies;
+}
+
+const std::vector<BotPolicy>& Tournament::getPolicies() const {
+    return m_policies;
+}
+
+const std::vector<Tournament::Matchup>& Tournament::getMatchups() const {
+    return m_matchups;
+}
+
+std::vector<Tournament::Standing> Tournament::getStandings() const {
+    // the games and the wins between every two policies
+    std::size_t numPolicies = m_policies.size();
+    std::vector<double> games(numPolicies * numPolicies, 0.0);
+    std::vector<Standing> standings(numPolicies);
+    for (unsigned int i = 0; i < numPolicies; i++) {
+        standings[i] = Standing{ i, ELO_AVERAGE, 0, 0.0 };
+    }
+    for (const Matchup& matchup : m_matchups) {
+        games[matchup.first * numPolicies + matchup.second] += 2.0 * matchup.pairs;
+        games[matchup.second * numPolicies + matchup.first] += 2.0 * matchup.pairs;
+        standings[matchup.first].games += 2 * matchup.pairs;
+        standings[matchup.second].games += 2 * matchup.pairs;
+        standings[matchup.first].score += 2.0 * matchup.score;
+        standings[matchup.second].score += 2.0 * (matchup.pairs - matchup.score);
+    }
+
+    // the Bradley-Terry strengths by minorization-maximization, every policy also drawing one game against a
+    // policy of strength 1, so a policy that never won still gets a finite rating
+    std::vector<double> strengths(numPolicies, 1.0);
+    for (unsigned int iteration = 0; iteration < RATING_ITERATIONS; iteration++) {
+        for (std::size_t i = 0; i < numPolicies; i++) {
+            double denominator = 1.0 / (strengths[i] + 1.0);
+            for (std::size_t j = 0; j < numPolicies; j++) {
+                if (games[i * numPolicies + j] > 0.0) {
+                    denominator += games[i * numPolicies + j] / (strengths[i] + strengths[j]);
+                }
+            }
+            strengths[i] = (standings[i].score + 0.5) / denominator;
+        }
+    }
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < numPolicies; i++) {
+        standings[i].rating = ELO_SCALE * std::log10(strengths[i]);
+        sum += standings[i].rating;
+    }
+    for (Standing& standing : standings) {
+        standing.rating += ELO_AVERAGE - sum / numPolicies;
+    }
+    std::stable_sort(standings.begin(), standings.end(),
+                     [](const Standing& a, const Standing& b){ return a.rating > b.rating; });
+    return standings;
+}
+
+GameStats& Tournament::getStats(){
+    return m_stats;
+}
+
+const std::vector<Tournament::WorkerCounters>& Tournament::getWorkerCounters() const {
+    return m_workerCounters;
+}
+
+bool Tournament::hasPerfCounters() const {
+    return m_perfAvailable;
+}
+
+std::uint64_t Tournament::getNumGames() const {
+    std::uint64_t games = 0;
+    for (const Matchup& matchup : m_matchups) {
+        games += 2 * matchup.pairs;
+    }
+    return games;
+}
+
+void Tournament::playMatchups(ThreadPool& pool, std::size_t first, std::ostream* log){
+    std::vector<std::size_t> running;
+    for (std::size_t i = first; i < m_matchups.size(); i++) {
+        if (!m_matchups[i].decided && m_matchups[i].pairs < m_options.maxPairs) {
+            running.push_back(i);
+        }
+    }
+    std::vector<Block> blocks;
+    while (!running.empty()) {
+        // the same blocks for any number of workers, enough to keep many busy as the matchups stop, never past maxPairs
+        unsigned int blocksPerMatchup = std::max<unsigned int>(1,
+            (m_options.waveBlocks + static_cast<unsigned int>(running.size()) - 1) / static_cast<unsigned int>(running.size()));
+        blocks.clear();
+        for (std::size_t index : running) {
+            unsigned int pair = m_matchups[index].pairs;
+            for (unsigned int block = 0; block < blocksPerMatchup && pair < m_options.maxPairs; block++) {
+                unsigned int numPairs = std::min(m_options.batchPairs, m_options.maxPairs - pair);
+                blocks.push_back(Block{ index, pair, numPairs, 0.0, 0.0, GameStats(BoardDefinition::standard().getNumTiles()), {} });
+                pair += numPairs;
+            }
+        }
+
+        pool.parallelFor(blocks.size(), [&](std::size_t index, unsigned int worker){
+            PerfCounters* counters = m_countPerf ? &getThreadCounters() : nullptr;
+            PerfCounters::Reading start = counters ? counters->read() : PerfCounters::Reading{};
+            Block& block = blocks[index];
+            const Matchup& matchup = m_matchups[block.matchup];
+            const BotPolicy& firstPolicy = m_policies[matchup.first];
+            const BotPolicy& secondPolicy = m_policies[matchup.second];
+            std::uint64_t matchupSeed = mix(mix(m_options.seed) ^ (static_cast<std::uint64_t>(matchup.first) << 32 | matchup.second));
+            for (unsigned int pair = block.firstPair; pair < block.firstPair + block.numPairs; pair++) {
+                ResultWriter::Row rows[2];
+                double score = playPair(firstPolicy, secondPolicy, mix(matchupSeed + pair), m_options.maxTurns,
+                                        &block.stats, m_results ? rows : nullptr);
+                if (m_results) {
+                    // the policies swap seats in the second game
+                    for (unsigned int game = 0; game < 2; game++) {
+                        rows[game].policies[game] = static_cast<std::uint8_t>(matchup.first);
+                        rows[game].policies[1 - game] = static_cast<std::uint8_t>(matchup.second);
+                        block.rows.push_back(rows[game]);
+                    }
+                }
+                block.score += score;
+                block.sumSquares += score * score;
+            }
+            if (counters) {
+                WorkerCounters& workerCounters = m_workerCounters[worker];
+                workerCounters.counts += counters->read() - start;
+                workerCounters.games += block.stats.getNumGames();
+                workerCounters.turns += block.stats.getNumTurns();
+            }
+        });
+
+        // the blocks are taken in order and a matchup stops at the first block that decides it, so where it stops
+        // doesn't depend on how many blocks the wave played, and the games of the blocks taken are summed up and
+        // written in that order, so the summary and the results don't either
+        std::vector<std::size_t> stillRunning;
+        std::size_t next = 0;
+        for (std::size_t index : running) {
+            Matchup& matchup = m_matchups[index];
+            bool stopped = false;
+            for (; next < blocks.size() && blocks[next].matchup == index; next++) {
+                if (stopped) {
+                    continue;
+                }
+                matchup.pairs += blocks[next].numPairs;
+                matchup.score += blocks[next].score;
+                matchup.sumSquares += blocks[next].sumSquares;
+                m_stats.merge(blocks[next].stats);
+                for (const ResultWriter::Row& row : blocks[next].rows) {
+                    m_results->add(0, row);
+                }
+                if (matchup.pairs >= m_options.minPairs
+                    && std::fabs(matchup.getMean() - 0.5) > m_options.stopZ * matchup.getStandardError()) {
+                    matchup.decided = true;
+                }
+                stopped = matchup.decided || matchup.pairs >= m_options.maxPairs;
+            }
+            if (!stopped) {
+                stillRunning.push_back(index);
+            } else if (log) {
+                logMatchup(matchup, *log);
+            }
+        }
+        running.swap(stillRunning);
+
+        if (!m_checkpointPath.empty() && !running.empty()
+            && std::chrono::steady_clock::now() - m_lastCheckpoint >= std::chrono::duration<double>(m_checkpointInterval)) {
+            if (!writeCheckpoint() && log) {
+                *log << "failed writing the checkpoint " << m_checkpointPath << std::endl;
+            }
+            m_lastCheckpoint = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+void Tournament::saveOptions(Protocol::Writer& writer) const {
+    writer.u64(CHECKPOINT_MAGIC);
+    writer.u8(static_cast<std::uint8_t>(m_options.format));
+    writer.u32(m_options.rounds);
+    writer.u32(m_options.minPairs);
+    writer.u32(m_options.maxPairs);
+    writer.u32(m_options.batchPairs);
+    writer.u32(m_options.waveBlocks);
+    writer.f64(m_options.stopZ);
+    writer.u32(m_options.maxTurns);
+    writer.u64(m_options.seed);
+    writer.u32(static_cast<std::uint32_t>(m_policies.size()));
+    for (const BotPolicy& policy : m_policies) {
+        writer.u32(static_cast<std::uint32_t>(policy.name.size()));
+        writer.bytes(reinterpret_cast<const std::uint8_t*>(policy.name.data()), policy.name.size());
+        writer.u32(policy.buyReserve);
+        writer.u32(policy.buildReserve);
+        writer.u32(policy.maxBuildLevel);
+        writer.u8(policy.trades ? 1 : 0);
+    }
+}
+
+bool Tournament::writeCheckpoint(){
+    std::vector<std::uint8_t> data;
+    Protocol::Writer writer(data);
+    saveOptions(writer);
+    writer.u32(m_round);
+    writer.u64(m_roundFirst);
+    writer.u64(m_matchups.size());
+    for (const Matchup& matchup : m_matchups) {
+        writer.u32(matchup.first);
+        writer.u32(matchup.second);
+        writer.u32(matchup.pairs);
+        writer.f64(matchup.score);
+        writer.f64(matchup.sumSquares);
+        writer.u8(matchup.decided ? 1 : 0);
+    }
+    m_stats.save(writer);
+    writer.u8(m_results ? 1 : 0);
+    if (m_results && !m_results->save(writer)) {
+        return false;
+    }
+
+    // written next to the last one and renamed over it, so a crash leaves one whole checkpoint or the other
+    std::string temporary = m_checkpointPath + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    std::size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno != EINTR) {
+            break;
+        }
+        written += result > 0 ? static_cast<std::size_t>(result) : 0;
+    }
+    bool ok = written == data.size() && fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    return ok && std::rename(temporary.c_str(), m_checkpointPath.c_str()) == 0;
+}
+
+std::vector<Tournament::Matchup> Tournament::pairSwissRound() const {
+    // the points of a policy are the shares of the games it won in its matchups
+    unsigned int numPolicies = static_cast<unsigned int>(m_policies.size());
+    std::vector<double> points(numPolicies, 0.0);
+    for (const Matchup& matchup : m_matchups) {
+        points[matchup.first] += matchup.getMean();
+        points[matchup.second] += 1.0 - matchup.getMean();
+    }
+    std::vector<unsigned int> order(numPolicies);
+    for (unsigned int i = 0; i < numPolicies; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b){ return points[a] > points[b]; });
+
+    // from the top, every policy meets the next one down it hasn't met, a policy left alone sits the round out
+    std::vector<Matchup> pairings;
+    std::vector<bool> paired(numPolicies, false);
+    for (unsigned int i = 0; i < numPolicies; i++) {
+        if (paired[order[i]]) {
+            continue;
+        }
+        for (unsigned int j = i + 1; j < numPolicies; j++) {
+            if (!paired[order[j]] && !havePlayed(order[i], order[j])) {
+                paired[order[i]] = paired[order[j]] = true;
+                pairings.push_back(Matchup{ order[i], order[j], 0, 0.0, 0.0, false });
+                break;
+            }
+        }
+    }
+    return pairings;
+}
+
+bool Tournament::havePlayed(unsigned int first, unsigned int second) const {
+    for (const Matchup& matchup : m_matchups) {
+        if ((matchup.first == first && matchup.second == second) || (matchup.first == second && matchup.second == first)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tournament::logMatchup(const Matchup& matchup, std::ostream& log) const {
+    const BotPolicy& first = m_policies[matchup.first];
+    const BotPolicy& second = m_policies[matchup.second];
+    log << std::fixed << std::setprecision(1) << first.name << " vs " << second.name << ": "
+        << matchup.getMean() * 100.0 << "% +-" << REPORTED_Z * matchup.getStandardError() * 100.0 << "% over "
+        << 2 * matchup.pairs << " games, ";
+    if (matchup.decided) {
+        log << (matchup.getMean() > 0.5 ? first.name : second.name) << " is better" << std::endl;
+    } else {
+        log << "undecided" << std::endl;
+    }
+}
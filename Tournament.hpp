@@ -0,0 +1,194 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "GameStats.hpp"
+#include "PerfCounters.hpp"
+#include "Protocol.hpp"
+#include "ResultWriter.hpp"
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+
+/** @class Tournament
+ *
+ * @brief Plays bot policies against each other, heads up on the standard board, and rates them.
+ *
+ * A matchup between two policies is played in pairs of games: both games of a pair use the same dice, with the
+ * policies swapping seats, which cancels most of the luck of the dice and the edge of moving first. A pair scores
+ * the share of its 2 games the first policy won (a draw is half a win), and a game still running after maxTurns turns
+ * goes to the player with the higher net worth.
+ *
+ * The pairs of all the running matchups are played in waves of waveBlocks blocks of pairs over a ThreadPool. After every wave, a matchup whose mean
+ * pair score is more than stopZ standard errors away from a half (a stricter bound than the reported 95% interval,
+ * since it's looked at again and again) is decided and stops. The others go on until maxPairs. The dice of every pair
+ * come from the seed, the policies and the index of the pair, and the waves don't depend on the number of threads,
+ * so neither do the results.
+ *
+ * Round robin plays every pair of policies once. Swiss plays rounds, pairing the policies with the closest scores
+ * that haven't met yet. At the end, the policies are rated on the Elo scale by fitting a Bradley-Terry model to every
+ * game played, so the ratings don't depend on the order of the games.
+ *
+ * The games of every block of pairs are also summed up in a GameStats of the block, and their results kept, and once
+ * the wave is over the blocks that count are merged into getStats() and written to the ResultWriter in order, so
+ * both are the same whatever the number of threads.
+ *
+ * A long tournament can write checkpoints between waves: the pairs every matchup played (which give the seeds of the
+ * next ones), the summary so far, and the state of the ResultWriter. A tournament resumed from one plays on to the
+ * very same standings, summary and result file as one that was never stopped.
+ */
+class Tournament {
+public:
+    /** @enum Format
+     *  @brief Which policies meet.
+     */
+    enum class Format : std::uint8_t { RoundRobin, Swiss };
+
+    /** @brief How the tournament is played. */
+    struct Options {
+        Format format = Format::RoundRobin;
+        unsigned int rounds = 0;          ///< The rounds of a Swiss tournament, 0 for log2 of the policies plus 2.
+        unsigned int minPairs = 32;       ///< The pairs of games a matchup plays before it can stop.
+        unsigned int maxPairs = 1000;     ///< The pairs of games after which an undecided matchup stops.
+        unsigned int batchPairs = 16;     ///< The pairs of games of one iteration of the thread pool.
+        unsigned int waveBlocks = 64;     ///< The iterations of a wave, split over the running matchups.
+        double stopZ = 3.0;               ///< The standard errors from a half that decide a matchup.
+        unsigned int maxTurns = 1000;     ///< The turns after which a game goes to the higher net worth.
+        std::uint64_t seed = 1;
+    };
+
+    /** @brief A matchup between two policies. */
+    struct Matchup {
+        unsigned int first;        ///< The index of the first policy.
+        unsigned int second;
+        unsigned int pairs;        ///< The pairs of games played.
+        double score;              ///< The sum of the pair scores of the first policy.
+        double sumSquares;         ///< The sum of the squares of the pair scores.
+        bool decided;              ///< Whether it stopped early, one policy being better.
+
+        /** @brief Gets the mean pair score of the first policy, its share of the games won. */
+        double getMean() const;
+        /** @brief Gets the standard error of the mean. */
+        double getStandardError() const;
+    };
+
+    /** @brief What a worker of the pool counted over the blocks of games it played. */
+    struct WorkerCounters {
+        PerfCounters::Reading counts;   ///< The wall clock and the hardware events of the blocks.
+        std::uint64_t games;
+        std::uint64_t turns;
+    };
+
+    /** @brief The result of a policy. */
+    struct Standing {
+        unsigned int policy;       ///< The index of the policy.
+        double rating;             ///< On the Elo scale, the policies average 1500.
+        unsigned int games;
+        double score;              ///< The games won, a draw counting a half.
+    };
+
+    /** @brief Creates a tournament.
+     *
+     * @param policies The policies, at least 2.
+     * @param options How the tournament is played.
+     */
+    Tournament(std::vector<BotPolicy> policies, const Options& options);
+
+    /** @brief Plays the tournament.
+     *
+     * @param pool The threads that play the games.
+     * @param log Where the matchups are reported as they end, nullptr for nowhere.
+     * @param results Where the result of every game played goes, opened with a worker per worker of the pool and
+     *                the policies of the tournament, nullptr for nowhere.
+     */
+    void run(ThreadPool& pool, std::ostream* log, ResultWriter* results = nullptr);
+
+    /** @brief Makes run() write a checkpoint between two waves once every interval, replacing the last one.
+     *
+     * @param path The file of the checkpoint, empty for none.
+     * @param intervalSeconds The time between two checkpoints.
+     */
+    void setCheckpoint(const std::string& path, double intervalSeconds);
+
+    /** @brief Makes run() count the blocks of games of every worker with PerfCounters, see getWorkerCounters().
+     *
+     * The blocks played past the end of a matchup are counted too, they took the time all the same.
+     */
+    void setPerfCounters(bool enabled);
+
+    /** @brief Loads a checkpoint before run(), which then goes on from it.
+     *
+     * @param path The file of the checkpoint.
+     * @param results The result file of the tournament, opened with resuming, or nullptr if it has none.
+     * @return If the checkpoint is whole and was written by a tournament with the same policies and options.
+     */
+    bool resume(const std::string& path, ResultWriter* results);
+
+    /** @brief Plays the two games of a pair, the policies swapping seats.
+     *
+     * @param stats Where the games are summed up, nullptr for nowhere.
+     * @param rows Where the results of the 2 games go (all but the policies), nullptr for nowhere.
+     * @return The share of the 2 games the first policy won, a draw counting a half.
+     */
+    static double playPair(const BotPolicy& first, const BotPolicy& second, std::uint64_t seed, unsigned int maxTurns,
+                           GameStats* stats = nullptr, ResultWriter::Row* rows = nullptr);
+
+    /** @brief Gets the policies every tournament can use, a sweep over the knobs of BotPolicy. */
+    static const std::vector<BotPolicy>& getBuiltinPolicies();
+
+    //* Getters
+    const std::vector<BotPolicy>& getPolicies() const;
+    const std::vector<Matchup>& getMatchups() const;
+    /** @brief Gets the standings, from the best rating to the worst. */
+    std::vector<Standing> getStandings() const;
+    /** @brief Gets the number of games played. */
+    std::uint64_t getNumGames() const;
+    /** @brief Gets the summary of all the games played. */
+    GameStats& getStats();
+    /** @brief Gets the counts of every worker of the last run(), empty without setPerfCounters(). */
+    const std::vector<WorkerCounters>& getWorkerCounters() const;
+    /** @brief Checks if the hardware events could be counted, or only the wall clock. */
+    bool hasPerfCounters() const;
+
+private:
+    /** @brief Plays the rounds of a Swiss tournament. */
+    void playSwissRounds(ThreadPool& pool, std::ostream* log);
+
+    /** @brief Plays a set of matchups until all of them stop. */
+    void playMatchups(ThreadPool& pool, std::size_t first, std::ostream* log);
+
+    /** @brief Gets the pairs of the next Swiss round, by score, without rematches. */
+    std::vector<Matchup> pairSwissRound() const;
+
+    /** @brief Checks if two policies already met. */
+    bool havePlayed(unsigned int first, unsigned int second) const;
+
+    /** @brief Writes the line of a matchup that stopped. */
+    void logMatchup(const Matchup& matchup, std::ostream& log) const;
+
+    /** @brief Writes the policies and the options, the start of a checkpoint. */
+    void saveOptions(Protocol::Writer& writer) const;
+
+    /** @brief Writes the state of the tournament to the checkpoint file. */
+    bool writeCheckpoint();
+
+    //* MEMBERS
+    std::vector<BotPolicy> m_policies;
+    Options m_options;
+    std::vector<Matchup> m_matchups;
+    GameStats m_stats;
+    ResultWriter* m_results;               ///< Only set while running.
+
+    std::string m_checkpointPath;
+    double m_checkpointInterval;
+    std::chrono::steady_clock::time_point m_lastCheckpoint;
+    unsigned int m_round;                  ///< The Swiss rounds started.
+    std::size_t m_roundFirst;              ///< The first matchup of the round being played.
+    bool m_resumed;                        ///< Loaded from a checkpoint, the matchups are already there.
+
+    bool m_countPerf;
+    bool m_perfAvailable;
+    std::vector<WorkerCounters> m_workerCounters;
+};
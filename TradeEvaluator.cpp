@@ -0,0 +1,267 @@
+#include "TradeEvaluator.hpp"
+
+TradeEvaluator::TradeEvaluator()
+    : m_game(nullptr),
+      m_board(nullptr),
+      m_numPlayers(0),
+      m_landings(0),
+      m_numScreened(0)
+{
+}
+
+void TradeEvaluator::refresh(const GameState& game){
+    const BoardDefinition& board = game.getBoard();
+    unsigned int numGroups = board.getNumGroups();
+    if (m_board != &board || m_builtRents.size() != numGroups) {
+        // a group is valued built up only if all its tiles can be built on
+        m_board = &board;
+        m_builtRents.assign(numGroups, 0);
+        m_groupSizes.assign(numGroups, 0);
+        for (unsigned int group = 0; group < numGroups; group++) {
+            std::uint32_t rent = 0;
+            bool buildable = true;
+            for (unsigned int tile : board.getGroupTiles(static_cast<std::uint8_t>(group))) {
+                rent += board.getTile(tile).rents[BUILT_LEVEL];
+                buildable = buildable && board.getTile(tile).housePrice > 0;
+            }
+            m_builtRents[group] = buildable ? rent : 0;
+            m_groupSizes[group] = static_cast<std::uint16_t>(board.getGroupSize(static_cast<std::uint8_t>(group)));
+        }
+    }
+
+    m_game = &game;
+    m_numPlayers = game.getNumPlayers();
+    unsigned int opponents = 0;
+    for (unsigned int player = 0; player < m_numPlayers; player++) {
+        opponents += game.getPlayer(player).bankrupt ? 0 : 1;
+    }
+    m_landings = static_cast<std::int64_t>(opponents > 0 ? opponents - 1 : 0) * HORIZON_TURNS;
+
+    m_holdings.assign(numGroups * m_numPlayers, Holding{ 0, 0, 0 });
+    for (unsigned int tile = 0; tile < game.getNumTiles(); tile++) {
+        const GameState::TileState& state = game.getTile(tile);
+        std::uint8_t group = board.getTile(tile).group;
+        if (state.owner < 0 || group == BoardDefinition::NO_GROUP) {
+            continue;
+        }
+        Holding& holding = m_holdings[group * m_numPlayers + state.owner];
+        holding.count++;
+        if (state.mortgaged) {
+            holding.mortgaged++;
+        } else {
+            holding.rent += board.getTile(tile).rents[0];
+        }
+    }
+
+    m_values.resize(m_holdings.size());
+    m_positions.assign(m_numPlayers, 0);
+    for (unsigned int group = 0; group < numGroups; group++) {
+        for (unsigned int player = 0; player < m_numPlayers; player++) {
+            unsigned int index = group * m_numPlayers + player;
+            m_values[index] = getGroupValue(static_cast<std::uint8_t>(group), m_holdings[index]);
+            m_positions[player] += toCash(m_values[index]);
+        }
+    }
+}
+
+TradeEvaluator::Score TradeEvaluator::evaluate(const GameState::TradeOffer& offer) const {
+    unsigned int proposer = m_game->getCurrentPlayer();
+    unsigned int partner = offer.partner;
+
+    // the groups the trade touches, a tile at a time
+    Change changes[2 * GameState::TradeOffer::MAX_TILES];
+    unsigned int numChanges = 0;
+    auto findChange = [&](unsigned int tile) -> Change* {
+        std::uint8_t group = m_board->getTile(tile).group;
+        if (group == BoardDefinition::NO_GROUP) {
+            return nullptr;
+        }
+        for (unsigned int i = 0; i < numChanges; i++) {
+            if (changes[i].group == group) {
+                return &changes[i];
+            }
+        }
+        changes[numChanges] = Change{ group, m_holdings[group * m_numPlayers + proposer], m_holdings[group * m_numPlayers + partner] };
+        return &changes[numChanges++];
+    };
+    for (unsigned int i = 0; i < offer.numGiven; i++) {
+        if (Change* change = findChange(offer.given[i])) {
+            moveTile(*change, offer.given[i], true);
+        }
+    }
+    for (unsigned int i = 0; i < offer.numTaken; i++) {
+        if (Change* change = findChange(offer.taken[i])) {
+            moveTile(*change, offer.taken[i], false);
+        }
+    }
+
+    std::int64_t proposerValue = 0;
+    std::int64_t partnerValue = 0;
+    for (unsigned int i = 0; i < numChanges; i++) {
+        const Change& change = changes[i];
+        proposerValue += getGroupValue(change.group, change.proposer) - m_values[change.group * m_numPlayers + proposer];
+        partnerValue += getGroupValue(change.group, change.partner) - m_values[change.group * m_numPlayers + partner];
+    }
+    return Score{ toCash(proposerValue) - offer.cash, toCash(partnerValue) + offer.cash };
+}
+
+bool TradeEvaluator::findTrade(const GameState& game, unsigned int maxCash, GameState::TradeOffer& offer){
+    refresh(game);
+    m_numScreened = 0;
+    unsigned int player = game.getCurrentPlayer();
+    const BuildingEngine& buildings = game.getBuildings();
+
+    // the tiles the player can give away
+    m_offered.clear();
+    for (unsigned int tile = 0; tile < game.getNumTiles(); tile++) {
+        std::uint8_t group = m_board->getTile(tile).group;
+        if (game.getTile(tile).owner == static_cast<int>(player) && group != BoardDefinition::NO_GROUP
+            && !buildings.hasBuildings(group)) {
+            m_offered.push_back(static_cast<std::uint16_t>(tile));
+        }
+    }
+
+    bool found = false;
+    std::int64_t best = 0;
+    GameState::TradeOffer candidate{};
+    auto screen = [&]{
+        m_numScreened++;
+        candidate.cash = 0;
+        Score score = evaluate(candidate);
+        // the least cash that makes it worth it to the partner
+        std::int64_t cash = 0;
+        if (score.partner <= 0) {
+            cash = (1 - score.partner + CASH_STEP - 1) / CASH_STEP * CASH_STEP;
+        }
+        if (cash > static_cast<std::int64_t>(maxCash) || score.proposer - cash <= best) {
+            return;
+        }
+        best = score.proposer - cash;
+        offer = candidate;
+        offer.cash = static_cast<std::int32_t>(cash);
+        found = true;
+    };
+
+    // at most the tiles of the groups the player started that they lack, the ones they could ask for
+    unsigned int numTaken = 0;
+    for (unsigned int group = 0; group < m_builtRents.size(); group++) {
+        const Holding& holding = m_holdings[group * m_numPlayers + player];
+        if (m_builtRents[group] != 0 && holding.count > 0) {
+            numTaken += m_groupSizes[group] - holding.count;
+        }
+    }
+    // a search that can't be screened whole (only on large boards) offers pairs of tiles only from the groups the
+    // partner is already in, where a tile is worth the most to them, and stops after MAX_SCREENED trades
+    std::size_t numOffered = m_offered.size();
+    std::size_t numPairs = numOffered > 1 ? numOffered * (numOffered - 1) / 2 : 0;
+    bool narrow = numTaken * (1 + numOffered + numPairs) > MAX_SCREENED;
+
+    // a tile of another player in a group the player started, for nothing, for one of their tiles or for two
+    for (unsigned int group = 0; group < m_builtRents.size(); group++) {
+        const Holding& holding = m_holdings[group * m_numPlayers + player];
+        const std::vector<unsigned int>& tiles = m_board->getGroupTiles(static_cast<std::uint8_t>(group));
+        if (m_builtRents[group] == 0 || holding.count == 0 || holding.count == tiles.size()) {
+            continue;
+        }
+        for (unsigned int tile : tiles) {
+            int owner = game.getTile(tile).owner;
+            if (owner < 0 || owner == static_cast<int>(player)) {
+                continue;
+            }
+            if (m_numScreened >= MAX_SCREENED) {
+                return found;
+            }
+            candidate.partner = static_cast<std::uint8_t>(owner);
+            candidate.numTaken = 1;
+            candidate.taken[0] = static_cast<std::uint16_t>(tile);
+            candidate.numGiven = 0;
+            screen();
+            for (std::size_t i = 0; i < m_offered.size(); i++) {
+                if (m_board->getTile(m_offered[i]).group == group) {
+                    continue;
+                }
+                if (m_numScreened >= MAX_SCREENED) {
+                    return found;
+                }
+                candidate.numGiven = 1;
+                candidate.given[0] = m_offered[i];
+                screen();
+                for (std::size_t j = i + 1; j < m_offered.size() && !narrow; j++) {
+                    if (m_board->getTile(m_offered[j]).group == group) {
+                        continue;
+                    }
+                    if (m_numScreened >= MAX_SCREENED) {
+                        return found;
+                    }
+                    candidate.numGiven = 2;
+                    candidate.given[1] = m_offered[j];
+                    screen();
+                }
+            }
+            if (!narrow) {
+                continue;
+            }
+            m_paired.clear();
+            for (std::uint16_t given : m_offered) {
+                std::uint8_t givenGroup = m_board->getTile(given).group;
+                if (givenGroup != group && m_holdings[givenGroup * m_numPlayers + candidate.partner].count > 0) {
+                    m_paired.push_back(given);
+                }
+            }
+            candidate.numGiven = 2;
+            for (std::size_t i = 0; i < m_paired.size(); i++) {
+                for (std::size_t j = i + 1; j < m_paired.size(); j++) {
+                    if (m_numScreened >= MAX_SCREENED) {
+                        return found;
+                    }
+                    candidate.given[0] = m_paired[i];
+                    candidate.given[1] = m_paired[j];
+                    screen();
+                }
+            }
+        }
+    }
+    return found;
+}
+
+std::int64_t TradeEvaluator::getPositionValue(unsigned int player) const {
+    return m_positions.at(player);
+}
+
+unsigned int TradeEvaluator::getNumScreened() const {
+    return m_numScreened;
+}
+
+std::int64_t TradeEvaluator::getGroupValue(std::uint8_t group, const Holding& holding) const {
+    std::int64_t built = m_builtRents[group];
+    std::int64_t size = m_groupSizes[group];
+    std::int64_t count = holding.count;
+    if (built > 0 && count == size) {
+        // a mortgaged tile stops the whole group from being built on
+        return (holding.mortgaged == 0 ? built : static_cast<std::int64_t>(holding.rent)) * 100;
+    }
+    std::int64_t value = static_cast<std::int64_t>(holding.rent) * 100;
+    if (built > 0) {
+        value += built * COMPLETION_PERCENT * count * count / (size * size);
+    }
+    return value;
+}
+
+std::int64_t TradeEvaluator::toCash(std::int64_t value) const {
+    return value * m_landings / (100 * static_cast<std::int64_t>(m_game->getNumTiles()));
+}
+
+void TradeEvaluator::moveTile(Change& change, unsigned int tile, bool toPartner) const {
+    Holding& from = toPartner ? change.proposer : change.partner;
+    Holding& to = toPartner ? change.partner : change.proposer;
+    from.count--;
+    to.count++;
+    if (m_game->getTile(tile).mortgaged) {
+        from.mortgaged--;
+        to.mortgaged++;
+    } else {
+        std::uint32_t rent = m_board->getTile(tile).rents[0];
+        from.rent -= rent;
+        to.rent += rent;
+    }
+}
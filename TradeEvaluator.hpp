@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GameState.hpp"
+
+/** @class TradeEvaluator
+ *
+ * @brief Scores trades for the bots, and finds the trade a bot proposes.
+ *
+ * A player's position is valued group by group (the color groups of the board): the rent their tiles of the group
+ * collect per landing, the rent of the whole group built up to BUILT_LEVEL once they own all of it, and a share of
+ * that for the progress towards it (growing with the square of the tiles owned, so the last tile is worth the most).
+ * A rent per landing is turned into cash as the rent the opponents pay over HORIZON_TURNS turns, landing on every
+ * tile alike.
+ *
+ * refresh() caches the holdings and the value of every group for every player. A trade only changes the groups of its
+ * tiles, so evaluate() values those few groups again for both players and compares them with the cache: a score
+ * costs a few lookups per tile, whatever the size of the board, and a bot screens thousands of trades per decision.
+ */
+class TradeEvaluator {
+public:
+    /** @brief The turns a position is valued over. */
+    static constexpr unsigned int HORIZON_TURNS = 30;
+
+    /** @brief The building level a monopoly is valued at. */
+    static constexpr unsigned int BUILT_LEVEL = 3;
+
+    /** @brief The value of owning a group whole given to the progress towards it, in percent. */
+    static constexpr unsigned int COMPLETION_PERCENT = 50;
+
+    /** @brief The most trades findTrade() scores for one decision, far more than the standard board ever needs. */
+    static constexpr unsigned int MAX_SCREENED = 4096;
+
+    /** @brief The cash of the trades findTrade() proposes is a multiple of this. */
+    static constexpr unsigned int CASH_STEP = 10;
+
+    /** @brief How much a trade is worth to each side, the cash included. */
+    struct Score {
+        std::int64_t proposer;
+        std::int64_t partner;
+    };
+
+    TradeEvaluator();
+
+    /** @brief Caches the position of every player of a game, call it again once the game changed.
+     *
+     * @param game The game, it must outlive the evaluations that follow.
+     */
+    void refresh(const GameState& game);
+
+    /** @brief Scores a trade of the current player against the cached positions.
+     *
+     * @param offer The trade, its tiles must be owned by the players giving them.
+     * @return The change of the value of each side's position.
+     */
+    Score evaluate(const GameState::TradeOffer& offer) const;
+
+    /** @brief Finds the trade the current player gains the most from that the partner also gains from.
+     *
+     * the player asks for a tile of a group they started, for nothing, one or two of their tiles from other groups,
+     * and the cash that makes it worth it to the partner. When that is more than MAX_SCREENED trades, which only
+     * happens on large boards, the pairs of tiles come from the groups the partner is in and the search stops after
+     * MAX_SCREENED trades. Refreshes the cache.
+     * @param game The game.
+     * @param maxCash The most cash the player pays.
+     * @param offer Set to the trade, if one was found.
+     * @return Whether a trade good for both sides was found.
+     */
+    bool findTrade(const GameState& game, unsigned int maxCash, GameState::TradeOffer& offer);
+
+    //* Getters
+    /** @brief Gets the cached value of a player's position. */
+    std::int64_t getPositionValue(unsigned int player) const;
+    /** @brief Gets the number of trades the last findTrade() scored. */
+    unsigned int getNumScreened() const;
+
+private:
+    /** @brief The tiles of a group a player holds. */
+    struct Holding {
+        std::uint16_t count;
+        std::uint16_t mortgaged;
+        std::uint32_t rent;        ///< The rent the unmortgaged ones collect per landing, without buildings.
+    };
+
+    /** @brief The holdings of a group changed by a trade, for both players. */
+    struct Change {
+        std::uint8_t group;
+        Holding proposer;
+        Holding partner;
+    };
+
+    /** @brief Values the holding of a group, in hundredths of the rent per landing. */
+    std::int64_t getGroupValue(std::uint8_t group, const Holding& holding) const;
+
+    /** @brief Turns a value in hundredths of the rent per landing into cash. */
+    std::int64_t toCash(std::int64_t value) const;
+
+    /** @brief Moves a tile between the holdings of a change. */
+    void moveTile(Change& change, unsigned int tile, bool toPartner) const;
+
+    //* MEMBERS
+    const GameState* m_game;
+    const BoardDefinition* m_board;           ///< The board the group values below were computed for.
+    unsigned int m_numPlayers;
+    std::int64_t m_landings;                  ///< The landings of the opponents on all the tiles over the horizon.
+    std::vector<std::uint32_t> m_builtRents;  ///< The rent of every group at BUILT_LEVEL, 0 if it can't be built on.
+    std::vector<std::uint16_t> m_groupSizes;
+    std::vector<Holding> m_holdings;          ///< The holdings of every group, numPlayers per group.
+    std::vector<std::int64_t> m_values;       ///< The value of every holding.
+    std::vector<std::int64_t> m_positions;    ///< The value of every player's position.
+    std::vector<std::uint16_t> m_offered;     ///< The tiles the player could give in the trade being looked for.
+    std::vector<std::uint16_t> m_paired;      ///< The offered tiles given in pairs when the search is narrowed.
+    unsigned int m_numScreened;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/** @class TripleBuffer
+ *
+ * @brief Hands the newest value from one writer thread to one reader thread without locks.
+ *
+ * There are three slots: the writer fills its back slot and publishes it by swapping it with the middle
+ * slot, the reader takes the middle slot by swapping it with its front slot. Neither side ever waits for
+ * the other, and the reader always gets the newest published value (older ones are dropped).
+ *
+ * @tparam T The type of the values. Slots are reused, so the writer should overwrite every field.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : m_middle(1),
+          m_back(0),
+          m_front(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    //* Writer side
+    /** @brief Gets the slot the writer fills, only the writer thread may use it. */
+    T& getWriteBuffer(){
+        return m_slots[m_back];
+    }
+
+    /** @brief Publishes the write buffer to the reader and gets a fresh slot to write into. */
+    void publish(){
+        std::uint8_t previous = m_middle.exchange(static_cast<std::uint8_t>(m_back | DIRTY_MASK), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    //* Reader side
+    /** @brief Takes the newest published value if there is one.
+     *
+     * @return Whether getReadBuffer() changed.
+     */
+    bool update(){
+        if ((m_middle.load(std::memory_order_relaxed) & DIRTY_MASK) == 0) {
+            return false;
+        }
+        std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /** @brief Gets the value the reader holds, only the reader thread may use it. */
+    const T& getReadBuffer() const {
+        return m_slots[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t DIRTY_MASK = 0x4;
+
+    //* MEMBERS
+    T m_slots[3];
+    std::atomic<std::uint8_t> m_middle; ///< The index of the middle slot, with DIRTY_MASK if the reader did not take it yet.
+    std::uint8_t m_back;                ///< Only used by the writer.
+    std::uint8_t m_front;               ///< Only used by the reader.
+};
@@ -0,0 +1,492 @@
+// INCLUDES
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "Board.hpp"
+#include "BenchmarkSuite.hpp"
+#include "AuctionEngine.hpp"
+#include "BuildingEngine.hpp"
+#include "CardDeck.hpp"
+#include "Dashboard.hpp"
+#include "GameState.hpp"
+#include "LayoutPass.hpp"
+#include "LiquidationPlanner.hpp"
+#include "MonopolyGame.hpp"
+#include "Simulation.hpp"
+#include "TDigest.hpp"
+#include "StreetTile.hpp"
+#include "TextBox.hpp"
+#include "TradeEvaluator.hpp"
+
+// Defines
+#define BOARD_SIZE 1000
+#define CORNERS_RATIO 2.f/13.f // the same board as main.cpp
+#define FONT_PATH "Montserrat-Black.ttf"
+#define DEFAULT_JSON_PATH "bench.json"
+
+/** @brief Gives the benchmarks access to the private layout functions. */
+class BenchmarkAccess {
+public:
+    static unsigned int computeMaxFontSize(const TextBox& textBox){
+        return textBox.computeMaxFontSize();
+    }
+    static void update(const TextBox& textBox){
+        textBox.update();
+    }
+    static void adjustAllComponents(StreetTile& tile){
+        tile.adjustAllComponents();
+    }
+};
+
+namespace {
+    /** @brief The text lengths the TextBox benchmarks run with. */
+    struct TextCase {
+        const char* label;
+        const char* name;
+    };
+
+    const TextCase TEXT_CASES[] = {
+        { "short", "Go" },
+        { "medium", "Ashdod Port" },
+        { "long", "Be'er Sheva University Campus North" },
+    };
+
+    /** @brief The tiles of the generated boards the scaling benchmarks run on, the first one the size of the standard board. */
+    const unsigned int SCALED_TILE_COUNTS[] = { 40, 200, 1000, 4000 };
+
+    /** @brief Generates a board for the scaling benchmarks, the benchmarks keep it alive (the games point to it). */
+    std::shared_ptr<const BoardDefinition> makeScaledBoard(unsigned int numTiles){
+        BoardDefinition::GeneratorOptions options;
+        options.numTiles = numTiles;
+        return std::make_shared<const BoardDefinition>(BoardDefinition::generate(options));
+    }
+
+    /** @brief Creates a text box laid out like the main text box of a tile. */
+    std::unique_ptr<TextBox> makeTextBox(const sf::Font& font, const char* name, TextBox::TextDirection direction){
+        bool vertical = direction == TextBox::TextDirection::Left || direction == TextBox::TextDirection::Right;
+        sf::FloatRect bounds = vertical ? sf::FloatRect(0, 0, 153, 100) : sf::FloatRect(0, 0, 100, 153);
+        sf::Text nameText(name, font, 30);
+        sf::Text priceText("$200", font, 30);
+        auto textBox = std::make_unique<TextBox>(bounds);
+        textBox->setTexts({ { nameText, TextBox::Alignment::Center }, { priceText, TextBox::Alignment::Center } });
+        textBox->setTextDirection(direction);
+        return textBox;
+    }
+
+    /** @brief Registers the benchmarks of the graphics classes, which need the font. */
+    void addGraphicsBenchmarks(BenchmarkSuite& suite, sf::Font& font){
+        // micro: text layout
+        const std::pair<const char*, TextBox::TextDirection> directions[] = {
+            { "Up", TextBox::TextDirection::Up },
+            { "Left", TextBox::TextDirection::Left },
+        };
+        for (const auto& text : TEXT_CASES) {
+            for (const auto& direction : directions) {
+                std::string suffix = std::string("/") + text.label + "/" + direction.first;
+                std::shared_ptr<TextBox> textBox = makeTextBox(font, text.name, direction.second);
+                suite.add("TextBox::computeMaxFontSize" + suffix, [textBox](std::uint64_t operations){
+                    for (std::uint64_t i = 0; i < operations; i++) {
+                        doNotOptimize(BenchmarkAccess::computeMaxFontSize(*textBox));
+                    }
+                });
+                suite.add("TextBox::update" + suffix, [textBox](std::uint64_t operations){
+                    for (std::uint64_t i = 0; i < operations; i++) {
+                        BenchmarkAccess::update(*textBox);
+                    }
+                });
+            }
+        }
+
+        // micro: tiles and the board
+        std::shared_ptr<StreetTile> tile = std::make_shared<StreetTile>("Ashdod Port", 200, font, StreetTile::ReadingDirection::Left, sf::Color::Red);
+        tile->setBounds(sf::FloatRect(0, 0, 153, 100));
+        suite.add("StreetTile::adjustAllComponents", [tile](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                BenchmarkAccess::adjustAllComponents(*tile);
+            }
+        });
+        // one tile per building type, since setBuildingType relayouts the tile
+        auto rentTiles = std::make_shared<std::vector<std::unique_ptr<StreetTile>>>();
+        for (int building = 0; building < 6; building++) {
+            rentTiles->push_back(std::make_unique<StreetTile>("Ashdod Port", 200, font));
+            rentTiles->back()->setBuildingType(static_cast<StreetTile::BuildingType>(building));
+        }
+        suite.add("StreetTile::calcRent", [rentTiles](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                doNotOptimize((*rentTiles)[i % 6]->calcRent());
+            }
+        });
+        // a building change only swaps interned labels, the relayout happens on the next draw
+        suite.add("StreetTile::setBuildingType", [tile](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                tile->setBuildingType(static_cast<StreetTile::BuildingType>(i % 6));
+            }
+        });
+        suite.add("Board::Board", [&font](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                Board board(BOARD_SIZE, CORNERS_RATIO, font);
+                doNotOptimize(board.getNumTiles());
+            }
+        });
+        std::vector<std::shared_ptr<const BoardDefinition>> scaledBoards;
+        for (unsigned int numTiles : SCALED_TILE_COUNTS) {
+            scaledBoards.push_back(makeScaledBoard(numTiles));
+            std::shared_ptr<const BoardDefinition> definition = scaledBoards.back();
+            suite.add("Board::Board/" + std::to_string(numTiles) + " tiles", [definition, &font](std::uint64_t operations){
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    Board board(BOARD_SIZE, CORNERS_RATIO, font, *definition);
+                    doNotOptimize(board.getNumTiles());
+                }
+            });
+        }
+
+        // macro: laying out a new board before its first frame, on one thread and on every core
+        std::vector<unsigned int> workerCounts = { 1 };
+        if (std::thread::hardware_concurrency() > 1) {
+            workerCounts.push_back(std::thread::hardware_concurrency());
+        }
+        for (unsigned int workers : workerCounts) {
+            auto layoutPass = std::make_shared<LayoutPass>(workers);
+            layoutPass->addFont(font, FONT_PATH);
+            suite.add("LayoutPass/cold board/" + std::to_string(workers) + " workers", [layoutPass, &font](std::uint64_t operations){
+                std::vector<const TextBox*> textBoxes;
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    Board board(BOARD_SIZE, CORNERS_RATIO, font);
+                    textBoxes.clear();
+                    board.collectTextBoxes(textBoxes);
+                    doNotOptimize(layoutPass->run(textBoxes));
+                }
+            });
+        }
+        // the generated boards on every core, the tiles shrink as they grow so every text box is searched again
+        auto scaledLayoutPass = std::make_shared<LayoutPass>(workerCounts.back());
+        scaledLayoutPass->addFont(font, FONT_PATH);
+        for (const std::shared_ptr<const BoardDefinition>& definition : scaledBoards) {
+            suite.add("LayoutPass/cold board/" + std::to_string(definition->getNumTiles()) + " tiles",
+                      [scaledLayoutPass, definition, &font](std::uint64_t operations){
+                std::vector<const TextBox*> textBoxes;
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    Board board(BOARD_SIZE, CORNERS_RATIO, font, *definition);
+                    textBoxes.clear();
+                    board.collectTextBoxes(textBoxes);
+                    doNotOptimize(scaledLayoutPass->run(textBoxes));
+                }
+            });
+        }
+
+        // macro: whole frames drawn off screen
+        auto texture = std::make_shared<sf::RenderTexture>();
+        if (!texture->create(BOARD_SIZE, BOARD_SIZE)) {
+            std::cerr << "Failed to create the off-screen render target, skipping the render benchmarks.\n";
+            return;
+        }
+        auto game = std::make_shared<MonopolyGame>(sf::Vector2u(BOARD_SIZE, BOARD_SIZE), CORNERS_RATIO, font);
+        game->setPlayersNames({ "shoe", "hat", "dog", "car" });
+        suite.add("render/frame", [texture, game](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                texture->clear();
+                texture->draw(*game);
+                texture->display();
+            }
+        });
+        suite.add("render/cold frame", [texture, &font](std::uint64_t operations){
+            // a new board lays out every text box on its first draw
+            for (std::uint64_t i = 0; i < operations; i++) {
+                MonopolyGame coldGame(sf::Vector2u(BOARD_SIZE, BOARD_SIZE), CORNERS_RATIO, font);
+                texture->clear();
+                texture->draw(coldGame);
+                texture->display();
+            }
+        });
+        // the board alone at the generated sizes, without the players and the menus of a game
+        for (const std::shared_ptr<const BoardDefinition>& definition : scaledBoards) {
+            auto board = std::make_shared<Board>(BOARD_SIZE, CORNERS_RATIO, font, *definition);
+            suite.add("render/frame/" + std::to_string(definition->getNumTiles()) + " tiles", [texture, board, definition](std::uint64_t operations){
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    texture->clear();
+                    texture->draw(*board);
+                    texture->display();
+                }
+            });
+        }
+        // a frame of the dashboard: the bots play a turn in every game, then all the thumbnails are drawn
+        for (unsigned int numGames : { 64u, 256u }) {
+            auto dashboard = std::make_shared<Dashboard>(sf::Vector2f(BOARD_SIZE, BOARD_SIZE), numGames, CORNERS_RATIO, font);
+            auto games = std::make_shared<std::vector<GameState>>();
+            for (unsigned int i = 0; i < numGames; i++) {
+                games->emplace_back(4, i + 1);
+            }
+            suite.add("render/dashboard frame/" + std::to_string(numGames) + " games", [texture, dashboard, games](std::uint64_t operations){
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    for (unsigned int index = 0; index < games->size(); index++) {
+                        GameState& game = (*games)[index];
+                        if (game.getPhase() == GameState::Phase::GameOver) {
+                            game = GameState(4, game.getTurnCount() + index);
+                        }
+                        Simulation::applyBotAction(game);
+                        dashboard->setGame(index, game);
+                    }
+                    texture->clear();
+                    texture->draw(*dashboard);
+                    texture->display();
+                }
+            });
+        }
+    }
+
+    /** @brief Registers the benchmarks of the headless game logic. */
+    void addHeadlessBenchmarks(BenchmarkSuite& suite){
+        suite.add("GameState::calcRent", [](std::uint64_t operations){
+            const GameState::TileDefinition& definition = BoardDefinition::standard().getTile(4);
+            GameState::TileState tile{ 0, 0, false };
+            for (std::uint64_t i = 0; i < operations; i++) {
+                tile.buildingLevel = static_cast<std::uint8_t>(i % 6);
+                doNotOptimize(GameState::calcRent(definition, tile));
+            }
+        });
+
+        suite.add("CardDeck::draw", [](std::uint64_t operations){
+            // reshuffles every 16 draws, like the decks of the standard board
+            Dice dice(1);
+            CardDeck deck;
+            deck.reset(16, dice);
+            for (std::uint64_t i = 0; i < operations; i++) {
+                doNotOptimize(deck.draw(dice));
+            }
+        });
+
+        suite.add("BuildingEngine::build+sell", [](std::uint64_t operations){
+            // a monopoly of 4 tiles built up to hotels and sold back down, an operation is one build or sell
+            const BoardDefinition& board = BoardDefinition::standard();
+            std::uint8_t group = board.getTile(11).group;
+            BuildingEngine engine(board, 4);
+            for (unsigned int tile : board.getGroupTiles(group)) {
+                engine.setOwner(tile, -1, 0);
+            }
+            bool building = true;
+            for (std::uint64_t i = 0; i < operations; i++) {
+                if (building) {
+                    const std::vector<std::uint16_t>& houses = engine.getHouseSites(0);
+                    const std::vector<std::uint16_t>& sites = houses.empty() ? engine.getHotelSites(0) : houses;
+                    if (!sites.empty()) {
+                        doNotOptimize(engine.build(sites.back()));
+                        continue;
+                    }
+                    building = false;
+                }
+                for (unsigned int tile : board.getGroupTiles(group)) {
+                    if (engine.canSell(0, tile)) {
+                        doNotOptimize(engine.sell(tile));
+                        break;
+                    }
+                }
+                building = !engine.hasBuildings(group);
+            }
+        });
+
+        {
+            // a late game, the player with the most buildings raising debts of every size
+            auto game = std::make_shared<GameState>(4, 1);
+            for (int i = 0; i < 20000; i++) {
+                Simulation::applyBotAction(*game);
+            }
+            unsigned int richest = 0;
+            for (unsigned int player = 0; player < game->getNumPlayers(); player++) {
+                BuildingEngine::BuildingCounts counts = game->getBuildings().getBuildingCounts(player);
+                BuildingEngine::BuildingCounts best = game->getBuildings().getBuildingCounts(richest);
+                if (counts.houses + 5 * counts.hotels > best.houses + 5 * best.hotels) {
+                    richest = player;
+                }
+            }
+            suite.add("LiquidationPlanner::plan", [game, richest](std::uint64_t operations){
+                LiquidationPlanner planner;
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    doNotOptimize(planner.plan(*game, richest, 50 + static_cast<unsigned int>(i % 40) * 50));
+                }
+            });
+        }
+
+        {
+            // an early game where most groups are split, ns/op is the time of one whole search
+            auto game = std::make_shared<GameState>(4, 5);
+            for (int i = 0; i < 400; i++) {
+                Simulation::applyBotAction(*game);
+            }
+            suite.add("TradeEvaluator::findTrade", [game](std::uint64_t operations){
+                TradeEvaluator trades;
+                GameState::TradeOffer offer;
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    doNotOptimize(trades.findTrade(*game, 1000, offer));
+                }
+            });
+        }
+
+        {
+            // the same search on a generated board of 1000 tiles, capped at MAX_SCREENED trades per decision
+            std::shared_ptr<const BoardDefinition> board = makeScaledBoard(1000);
+            auto game = std::make_shared<GameState>(4, 5, *board);
+            for (int i = 0; i < 2000; i++) {
+                Simulation::applyBotAction(*game);
+            }
+            suite.add("TradeEvaluator::findTrade/1000 tiles", [board, game](std::uint64_t operations){
+                TradeEvaluator trades;
+                GameState::TradeOffer offer;
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    doNotOptimize(trades.findTrade(*game, 1000, offer));
+                }
+            });
+        }
+
+        suite.add("AuctionEngine::resolve", [](std::uint64_t operations){
+            // the limits of 4 bidders on every street in turn, looked up like GameState does before resolving
+            const BoardDefinition& board = BoardDefinition::standard();
+            const AuctionEngine& auctions = board.getAuctions();
+            unsigned int money[4] = { 1500, 320, 90, 700 };
+            unsigned int limits[4];
+            unsigned int tile = 0;
+            for (std::uint64_t i = 0; i < operations; i++) {
+                tile = (tile + 7) % board.getNumTiles();
+                for (unsigned int player = 0; player < 4; player++) {
+                    limits[player] = std::min(money[player], auctions.getValue(board.getTile(tile).price, board.getTile(tile).group, (player + tile) % 3, player == 2));
+                }
+                AuctionEngine::Kind kind = (i & 1) ? AuctionEngine::Kind::SealedBid : AuctionEngine::Kind::Ascending;
+                doNotOptimize(AuctionEngine::resolve(kind, limits, 4, static_cast<unsigned int>(i % 4)).price);
+            }
+        });
+
+        suite.add("TDigest::add", [](std::uint64_t operations){
+            // game lengths from a skewed spread, merged into the centroids every BUFFER_SIZE values
+            TDigest digest;
+            std::uint64_t state = 1;
+            for (std::uint64_t i = 0; i < operations; i++) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                double uniform = static_cast<double>(state >> 11) / 9007199254740992.0;
+                digest.add(100.0 + 900.0 * uniform * uniform);
+            }
+            doNotOptimize(digest.getQuantile(0.99));
+        });
+
+        // macro: bots playing whole turns, ns/op is the time of one turn
+        suite.add("headless/turn", [](std::uint64_t operations){
+            std::uint64_t seed = 1;
+            GameState game(4, seed);
+            for (std::uint64_t i = 0; i < operations; i++) {
+                unsigned int turn = game.getTurnCount();
+                while (game.getTurnCount() == turn) {
+                    if (game.getPhase() == GameState::Phase::GameOver) {
+                        game = GameState(4, ++seed);
+                        break;
+                    }
+                    Simulation::applyBotAction(game);
+                }
+            }
+            doNotOptimize(game.getTurnCount());
+        });
+
+        // macro: the same on generated boards, the games restart at the turn limit of a tournament since few end on the large ones
+        for (unsigned int numTiles : SCALED_TILE_COUNTS) {
+            std::shared_ptr<const BoardDefinition> board = makeScaledBoard(numTiles);
+            suite.add("headless/turn/" + std::to_string(numTiles) + " tiles", [board](std::uint64_t operations){
+                std::uint64_t seed = 1;
+                GameState game(4, seed, *board);
+                for (std::uint64_t i = 0; i < operations; i++) {
+                    unsigned int turn = game.getTurnCount();
+                    while (game.getTurnCount() == turn) {
+                        if (game.getPhase() == GameState::Phase::GameOver || turn >= 1000) {
+                            game = GameState(4, ++seed, *board);
+                            break;
+                        }
+                        Simulation::applyBotAction(game);
+                    }
+                }
+                doNotOptimize(game.getTurnCount());
+            });
+        }
+
+        // macro: heads up games of the standard bots, up to the turn limit of a tournament, ns/op is one game
+        suite.add("headless/game", [](std::uint64_t operations){
+            for (std::uint64_t i = 0; i < operations; i++) {
+                GameState game(2, i + 1);
+                while (game.getPhase() != GameState::Phase::GameOver && game.getTurnCount() < 1000) {
+                    Simulation::applyBotAction(game);
+                }
+                doNotOptimize(game.getTurnCount());
+            }
+        });
+    }
+
+    void printUsage(const char* program){
+        std::cerr << "Usage: " << program << " [--filter TEXT] [--runs N] [--min-run-ms MS] [--json FILE]\n"
+                  << "                 [--baseline FILE] [--threshold PERCENT] [--perf]\n"
+                  << "  --json       where to write the results (default: " DEFAULT_JSON_PATH ")\n"
+                  << "  --baseline   compare against results written earlier, exit with 1 on a regression\n"
+                  << "  --threshold  the slowdown allowed before a benchmark is flagged (default: 5)\n"
+                  << "  --perf       also count cycles, instructions and misses per operation with perf events\n";
+    }
+}
+
+// MAIN
+int main(int argc, char* argv[]) {
+    BenchmarkSuite::Options options;
+    std::string jsonPath = DEFAULT_JSON_PATH;
+    std::string baselinePath;
+    double threshold = 0.05;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--runs") == 0 && hasValue) {
+            options.runs = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--min-run-ms") == 0 && hasValue) {
+            options.minRunMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue) {
+            threshold = std::atof(argv[++i]) / 100.0;
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            options.perfCounters = true;
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    // read the baseline first, so a bad path fails before the long run
+    std::vector<BenchmarkSuite::Result> baseline;
+    if (!baselinePath.empty() && !BenchmarkSuite::readJson(baselinePath, baseline)) {
+        std::cerr << "Failed to read the baseline " << baselinePath << ".\n";
+        return -1;
+    }
+
+    BenchmarkSuite suite;
+    sf::Font font;
+    if (font.loadFromFile(FONT_PATH)) {
+        addGraphicsBenchmarks(suite, font);
+    } else {
+        std::cerr << "Failed to load font, skipping the graphics benchmarks.\n";
+    }
+    addHeadlessBenchmarks(suite);
+
+    std::vector<BenchmarkSuite::Result> results = suite.run(options, std::cout);
+
+    std::ofstream json(jsonPath);
+    BenchmarkSuite::writeJson(json, results);
+    std::cout << "results written to " << jsonPath << "\n";
+
+    if (!baseline.empty()) {
+        std::cout << "\ncompared to " << baselinePath << ":\n";
+        unsigned int regressions = BenchmarkSuite::compare(baseline, results, threshold, std::cout);
+        std::cout << regressions << " regression(s)\n";
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,337 @@
+// INCLUDES
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BoardDefinition.hpp"
+#include "BuildingEngine.hpp"
+
+/*
+ * Plays random sequences of tile transfers, mortgages, builds and sales on a BuildingEngine, and after every step
+ * checks it against a naive model that recomputes the rules from the tiles alone: the even-build rule, the bank's
+ * 32 houses and 12 hotels, and the house and hotel sites of every player.
+ */
+
+namespace {
+    constexpr unsigned int NUM_PLAYERS = 4;
+    constexpr unsigned int STEPS = 4000;
+    constexpr unsigned int PHASE_STEPS = 500;
+    constexpr unsigned int SEEDS = 10;
+
+    /** @brief The rules recomputed from scratch from the owner, mortgage and level of every tile. */
+    struct Model {
+        const BoardDefinition& board;
+        std::vector<int> owners;
+        std::vector<bool> mortgaged;
+        std::vector<unsigned int> levels;
+        unsigned int bankHouses = BuildingEngine::BANK_HOUSES;
+        unsigned int bankHotels = BuildingEngine::BANK_HOTELS;
+
+        explicit Model(const BoardDefinition& definition)
+            : board(definition),
+              owners(definition.getNumTiles(), -1),
+              mortgaged(definition.getNumTiles(), false),
+              levels(definition.getNumTiles(), 0)
+        {
+        }
+
+        int monopolyOwner(std::uint8_t group) const {
+            const std::vector<unsigned int>& tiles = board.getGroupTiles(group);
+            int owner = owners[tiles.front()];
+            for (unsigned int tile : tiles) {
+                if (owners[tile] != owner) {
+                    return -1;
+                }
+            }
+            return owner;
+        }
+
+        unsigned int minLevel(std::uint8_t group) const {
+            unsigned int level = BuildingEngine::HOTEL_LEVEL;
+            for (unsigned int tile : board.getGroupTiles(group)) {
+                level = std::min(level, levels[tile]);
+            }
+            return level;
+        }
+
+        unsigned int maxLevel(std::uint8_t group) const {
+            unsigned int level = 0;
+            for (unsigned int tile : board.getGroupTiles(group)) {
+                level = std::max(level, levels[tile]);
+            }
+            return level;
+        }
+
+        bool hasBuildings(std::uint8_t group) const {
+            return maxLevel(group) > 0;
+        }
+
+        /** @brief Whether the player may put one more building on the tile, leaving out the bank's supply. */
+        bool isSite(unsigned int player, unsigned int tile) const {
+            std::uint8_t group = board.getTile(tile).group;
+            if (group == BoardDefinition::NO_GROUP || monopolyOwner(group) != static_cast<int>(player)) {
+                return false;
+            }
+            for (unsigned int groupTile : board.getGroupTiles(group)) {
+                if (mortgaged[groupTile] || board.getTile(groupTile).housePrice == 0) {
+                    return false;
+                }
+            }
+            return levels[tile] < BuildingEngine::HOTEL_LEVEL && levels[tile] == minLevel(group);
+        }
+
+        bool canBuild(unsigned int player, unsigned int tile) const {
+            if (!isSite(player, tile)) {
+                return false;
+            }
+            return levels[tile] + 1 == BuildingEngine::HOTEL_LEVEL ? bankHotels > 0 : bankHouses > 0;
+        }
+
+        bool canSell(unsigned int player, unsigned int tile) const {
+            std::uint8_t group = board.getTile(tile).group;
+            if (levels[tile] == 0 || monopolyOwner(group) != static_cast<int>(player) || levels[tile] != maxLevel(group)) {
+                return false;
+            }
+            return levels[tile] < BuildingEngine::HOTEL_LEVEL || bankHouses >= BuildingEngine::HOTEL_LEVEL - 1;
+        }
+
+        /** @brief Moves the bank's supply for a tile going from one level to another. */
+        void setLevel(unsigned int tile, unsigned int level){
+            if (levels[tile] == BuildingEngine::HOTEL_LEVEL) {
+                bankHotels++;
+            } else {
+                bankHouses += levels[tile];
+            }
+            levels[tile] = level;
+            if (level == BuildingEngine::HOTEL_LEVEL) {
+                bankHotels--;
+            } else {
+                bankHouses -= level;
+            }
+        }
+
+        std::vector<std::uint16_t> sites(unsigned int player, bool hotels) const {
+            std::vector<std::uint16_t> result;
+            if ((hotels ? bankHotels : bankHouses) == 0) {
+                return result;
+            }
+            for (unsigned int tile = 0; tile < levels.size(); tile++) {
+                if (isSite(player, tile) && (levels[tile] + 1 == BuildingEngine::HOTEL_LEVEL) == hotels) {
+                    result.push_back(static_cast<std::uint16_t>(tile));
+                }
+            }
+            return result;
+        }
+    };
+
+    /** @brief Counts the checks and reports the failed ones. */
+    struct Checker {
+        std::string context;
+        unsigned long checks = 0;
+        unsigned int failures = 0;
+
+        /** @brief Checks a condition, naming what failed and the tile, group or player it was about. */
+        void check(bool passed, const char* what, unsigned int index = 0){
+            checks++;
+            if (!passed && failures++ < 20) {
+                std::cerr << "FAILED " << context << ": " << what << " " << index << std::endl;
+            }
+        }
+
+        /** @brief Checks a rule of a player on a tile. */
+        void check(bool passed, const char* what, unsigned int player, unsigned int tile){
+            checks++;
+            if (!passed && failures++ < 20) {
+                std::cerr << "FAILED " << context << ": " << what << " of player " << player << " on tile " << tile << std::endl;
+            }
+        }
+    };
+
+    void compare(const BuildingEngine& engine, const Model& model, Checker& checker){
+        const BoardDefinition& board = model.board;
+        checker.check(engine.getBankHouses() == model.bankHouses, "bank houses");
+        checker.check(engine.getBankHotels() == model.bankHotels, "bank hotels");
+
+        unsigned int houses = 0;
+        unsigned int hotels = 0;
+        for (unsigned int tile = 0; tile < board.getNumTiles(); tile++) {
+            checker.check(engine.getLevel(tile) == model.levels[tile], "level of tile", tile);
+            (model.levels[tile] == BuildingEngine::HOTEL_LEVEL ? hotels : houses) +=
+                model.levels[tile] == BuildingEngine::HOTEL_LEVEL ? 1 : model.levels[tile];
+            for (unsigned int player = 0; player < NUM_PLAYERS; player++) {
+                checker.check(engine.canBuild(player, tile) == model.canBuild(player, tile), "canBuild", player, tile);
+                checker.check(engine.canSell(player, tile) == model.canSell(player, tile), "canSell", player, tile);
+            }
+        }
+        checker.check(houses + model.bankHouses == BuildingEngine::BANK_HOUSES, "32 houses in all");
+        checker.check(hotels + model.bankHotels == BuildingEngine::BANK_HOTELS, "12 hotels in all");
+
+        for (unsigned int group = 0; group < board.getNumGroups(); group++) {
+            std::uint8_t id = static_cast<std::uint8_t>(group);
+            unsigned int buildings = 0;
+            for (unsigned int tile : board.getGroupTiles(id)) {
+                buildings += model.levels[tile];
+            }
+            checker.check(model.maxLevel(id) - model.minLevel(id) <= 1, "evenly built group", group);
+            checker.check(engine.getMonopolyOwner(id) == model.monopolyOwner(id), "owner of group", group);
+            checker.check(engine.hasBuildings(id) == model.hasBuildings(id), "buildings of group", group);
+            checker.check(engine.getGroupBuildings(id) == buildings, "building count of group", group);
+        }
+
+        for (unsigned int player = 0; player < NUM_PLAYERS; player++) {
+            BuildingEngine::BuildingCounts counts{ 0, 0 };
+            for (unsigned int tile = 0; tile < board.getNumTiles(); tile++) {
+                if (model.owners[tile] == static_cast<int>(player)) {
+                    (model.levels[tile] == BuildingEngine::HOTEL_LEVEL ? counts.hotels : counts.houses) +=
+                        model.levels[tile] == BuildingEngine::HOTEL_LEVEL ? 1 : model.levels[tile];
+                }
+            }
+            BuildingEngine::BuildingCounts engineCounts = engine.getBuildingCounts(player);
+            checker.check(engineCounts.houses == counts.houses && engineCounts.hotels == counts.hotels,
+                          "building counts of player", player);
+
+            // the sets hold every site once, in any order
+            for (bool hotelSites : { false, true }) {
+                std::vector<std::uint16_t> sites = hotelSites ? engine.getHotelSites(player) : engine.getHouseSites(player);
+                std::sort(sites.begin(), sites.end());
+                checker.check(sites == model.sites(player, hotelSites),
+                              hotelSites ? "hotel sites of player" : "house sites of player", player);
+            }
+            checker.check(engine.canBuildAnywhere(player)
+                              == (!model.sites(player, false).empty() || !model.sites(player, true).empty()),
+                          "canBuildAnywhere of player", player);
+        }
+    }
+
+    /** @brief Plays one random sequence of transfers, mortgages, builds and sales. */
+    void play(const BoardDefinition& board, std::uint64_t seed, Checker& checker){
+        std::mt19937_64 random(seed);
+        BuildingEngine engine(board, NUM_PLAYERS);
+        Model model(board);
+        std::vector<unsigned int> streets;
+        for (unsigned int tile = 0; tile < board.getNumTiles(); tile++) {
+            if (board.getTile(tile).group != BoardDefinition::NO_GROUP) {
+                streets.push_back(tile);
+            }
+        }
+        auto pick = [&random](unsigned int count){
+            return static_cast<unsigned int>(random() % count);
+        };
+
+        for (unsigned int step = 0; step < STEPS; step++) {
+            checker.context = "seed " + std::to_string(seed) + " step " + std::to_string(step);
+            unsigned int tile = streets[pick(static_cast<unsigned int>(streets.size()))];
+            std::uint8_t group = board.getTile(tile).group;
+            unsigned int player = pick(NUM_PLAYERS);
+            // phases of mostly building, which empty the bank, take turns with phases of mostly selling
+            bool selling = step / PHASE_STEPS % 2 == 1;
+            unsigned int action = pick(10);
+            if (action >= 3) {
+                action = pick(8) < (selling ? 6u : 1u) ? 3 : 4;
+            }
+            switch (action) {
+                case 0: {
+                    // a tile changes hands, to the bank unmortgaged, only in groups without buildings
+                    if (model.hasBuildings(group)) {
+                        break;
+                    }
+                    // the tiles mostly join the owner of the group's first tile, so monopolies form
+                    int newOwner = pick(8) == 0 ? -1 : model.owners[board.getGroupTiles(group).front()];
+                    if (newOwner < 0 || pick(4) == 0) {
+                        newOwner = pick(8) == 0 ? -1 : static_cast<int>(pick(NUM_PLAYERS));
+                    }
+                    if (newOwner < 0 && model.mortgaged[tile]) {
+                        engine.setMortgaged(tile, false);
+                        model.mortgaged[tile] = false;
+                    }
+                    engine.setOwner(tile, model.owners[tile], newOwner);
+                    model.owners[tile] = newOwner;
+                    break;
+                }
+                case 1:
+                    if (model.owners[tile] < 0 || model.hasBuildings(group) || pick(3) != 0) {
+                        break;
+                    }
+                    model.mortgaged[tile] = !model.mortgaged[tile];
+                    engine.setMortgaged(tile, model.mortgaged[tile]);
+                    break;
+                case 2: {
+                    // sell a part of a group at once
+                    unsigned int buildings = engine.getGroupBuildings(group);
+                    if (buildings == 0 || model.monopolyOwner(group) < 0) {
+                        break;
+                    }
+                    unsigned int count = 1 + pick(buildings);
+                    std::vector<std::uint8_t> levels(board.getGroupTiles(group).size());
+                    bool enoughHouses = engine.getLevelsAfterSelling(group, count, levels.data());
+                    const std::vector<unsigned int>& tiles = board.getGroupTiles(group);
+                    unsigned int left = 0;
+                    unsigned int houses = 0;
+                    unsigned int housesBefore = 0;
+                    for (unsigned int i = 0; i < tiles.size(); i++) {
+                        left += levels[i];
+                        houses += levels[i] < BuildingEngine::HOTEL_LEVEL ? levels[i] : 0;
+                        housesBefore += model.levels[tiles[i]] < BuildingEngine::HOTEL_LEVEL ? model.levels[tiles[i]] : 0;
+                        checker.check(levels[i] <= model.levels[tiles[i]], "selling down never adds buildings");
+                    }
+                    auto [low, high] = std::minmax_element(levels.begin(), levels.end());
+                    checker.check(left == buildings - count, "selling down leaves the rest");
+                    checker.check(*high - *low <= 1, "selling down leaves the group even");
+                    checker.check(enoughHouses == (houses <= housesBefore + model.bankHouses), "selling down needs the bank's houses");
+                    checker.check(engine.sellDown(group, count) == enoughHouses, "sellDown agrees with getLevelsAfterSelling");
+                    if (enoughHouses) {
+                        for (unsigned int i = 0; i < tiles.size(); i++) {
+                            model.setLevel(tiles[i], levels[i]);
+                        }
+                    }
+                    break;
+                }
+                case 3:
+                    if (!model.canSell(player, tile)) {
+                        break;
+                    }
+                    checker.check(engine.sell(tile) == model.levels[tile] - 1, "sell returns the new level");
+                    model.setLevel(tile, model.levels[tile] - 1);
+                    break;
+                default: {
+                    // build on one of the sites of the tile's owner, the bank permitting
+                    if (model.owners[tile] < 0) {
+                        break;
+                    }
+                    player = static_cast<unsigned int>(model.owners[tile]);
+                    std::vector<std::uint16_t> sites = model.sites(player, false);
+                    std::vector<std::uint16_t> hotelSites = model.sites(player, true);
+                    sites.insert(sites.end(), hotelSites.begin(), hotelSites.end());
+                    if (sites.empty()) {
+                        break;
+                    }
+                    unsigned int site = sites[pick(static_cast<unsigned int>(sites.size()))];
+                    if (!model.canBuild(player, site)) {
+                        break;
+                    }
+                    checker.check(engine.build(site) == model.levels[site] + 1, "build returns the new level");
+                    model.setLevel(site, model.levels[site] + 1);
+                    break;
+                }
+            }
+            compare(engine, model, checker);
+        }
+    }
+}
+
+int main(){
+    Checker checker;
+    BoardDefinition::GeneratorOptions options;
+    options.numTiles = 120;
+    options.groupSize = 6;
+    BoardDefinition large = BoardDefinition::generate(options);
+
+    for (std::uint64_t seed = 1; seed <= SEEDS; seed++) {
+        play(BoardDefinition::standard(), seed, checker);
+        play(large, seed, checker);
+    }
+    std::cout << "BuildingEngine: " << checker.checks << " checks, " << checker.failures << " failed" << std::endl;
+    return checker.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+// INCLUDES
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "BoardDefinition.hpp"
+#include "GameState.hpp"
+#include "LiquidationPlanner.hpp"
+#include "Simulation.hpp"
+
+/*
+ * Plays bot games on small boards and, along the way, asks the LiquidationPlanner to raise random amounts for every
+ * player, checking its plans against trying every way the player can raise cash: any even sale of each group's
+ * buildings, or selling them all and mortgaging any of the group's tiles.
+ */
+
+namespace {
+    constexpr unsigned int NUM_PLAYERS = 3;
+    constexpr unsigned int GAMES = 60;
+    constexpr unsigned int MAX_ACTIONS = 3000;
+    constexpr unsigned int PLAN_EVERY = 25;
+    constexpr unsigned int AMOUNTS = 6;
+    // the plans the exhaustive search tries at most, the players holding more are left out
+    constexpr std::uint64_t MAX_COMBINATIONS = 200000;
+
+    /** @brief A way a group raises cash, and the rent it gives up. */
+    struct Option {
+        unsigned int cash;
+        unsigned int rentLost;
+    };
+
+    /** @brief The ways every group the player holds tiles in raises cash, computed from the rules alone. */
+    std::vector<std::vector<Option>> getOptions(const GameState& game, unsigned int player){
+        const BoardDefinition& board = game.getBoard();
+        const BuildingEngine& buildings = game.getBuildings();
+        std::vector<std::vector<Option>> groups;
+        for (unsigned int group = 0; group < board.getNumGroups(); group++) {
+            std::uint8_t id = static_cast<std::uint8_t>(group);
+            const std::vector<unsigned int>& tiles = board.getGroupTiles(id);
+            if (buildings.getOwnedCount(id, player) == 0) {
+                continue;
+            }
+            std::vector<Option> options{ Option{ 0, 0 } };
+
+            // selling some of the buildings, evenly
+            std::vector<std::uint8_t> levels(tiles.size());
+            unsigned int standing = buildings.getMonopolyOwner(id) == static_cast<int>(player) ? buildings.getGroupBuildings(id) : 0;
+            for (unsigned int count = 1; count < standing; count++) {
+                if (!buildings.getLevelsAfterSelling(id, count, levels.data())) {
+                    continue;
+                }
+                Option option{ 0, 0 };
+                for (unsigned int i = 0; i < tiles.size(); i++) {
+                    const BoardDefinition::Tile& tile = board.getTile(tiles[i]);
+                    unsigned int level = game.getTile(tiles[i]).buildingLevel;
+                    option.cash += (level - levels[i]) * (tile.housePrice / 2);
+                    option.rentLost += tile.rents[level] - std::min(tile.rents[level], tile.rents[levels[i]]);
+                }
+                options.push_back(option);
+            }
+
+            // or selling them all, then mortgaging any of the player's unmortgaged tiles
+            Option soldAll{ 0, 0 };
+            std::vector<Option> mortgages;
+            for (unsigned int tile : tiles) {
+                const BoardDefinition::Tile& definition = board.getTile(tile);
+                const GameState::TileState& state = game.getTile(tile);
+                soldAll.cash += state.buildingLevel * (definition.housePrice / 2);
+                soldAll.rentLost += definition.rents[state.buildingLevel] - std::min(definition.rents[state.buildingLevel], definition.rents[0]);
+                if (state.owner == static_cast<int>(player) && !state.mortgaged && GameState::getMortgageValue(definition) > 0) {
+                    mortgages.push_back(Option{ GameState::getMortgageValue(definition), definition.rents[0] });
+                }
+            }
+            for (unsigned int subset = 0; subset < (1u << mortgages.size()); subset++) {
+                Option option = soldAll;
+                for (unsigned int i = 0; i < mortgages.size(); i++) {
+                    if (subset & (1u << i)) {
+                        option.cash += mortgages[i].cash;
+                        option.rentLost += mortgages[i].rentLost;
+                    }
+                }
+                options.push_back(option);
+            }
+            groups.push_back(options);
+        }
+        return groups;
+    }
+
+    /** @brief Tries every combination of the options of the groups, keeping the least rent lost, then the least cash. */
+    void search(const std::vector<std::vector<Option>>& groups, unsigned int index, Option sum, unsigned int amount,
+                Option& best, bool& found){
+        if (index == groups.size()) {
+            if (sum.cash >= amount && (!found || sum.rentLost < best.rentLost
+                                       || (sum.rentLost == best.rentLost && sum.cash < best.cash))) {
+                best = sum;
+                found = true;
+            }
+            return;
+        }
+        for (const Option& option : groups[index]) {
+            search(groups, index + 1, Option{ sum.cash + option.cash, sum.rentLost + option.rentLost }, amount, best, found);
+        }
+    }
+
+    /** @brief Counts the checks and reports the failed ones. */
+    struct Checker {
+        unsigned long checks = 0;
+        unsigned int failures = 0;
+
+        void check(bool passed, const char* what, std::uint64_t seed, unsigned int player, unsigned int amount){
+            checks++;
+            if (!passed && failures++ < 20) {
+                std::cerr << "FAILED game " << seed << " player " << player << " amount " << amount << ": " << what << std::endl;
+            }
+        }
+    };
+
+    /** @brief Adds up the cash and the rent lost of the plan the planner chose, from the rules alone. */
+    Option replay(const GameState& game, const LiquidationPlanner& planner){
+        const BoardDefinition& board = game.getBoard();
+        Option total{ 0, 0 };
+        for (const LiquidationPlanner::Sale& sale : planner.getSales()) {
+            const std::vector<unsigned int>& tiles = board.getGroupTiles(sale.group);
+            std::vector<std::uint8_t> levels(tiles.size());
+            game.getBuildings().getLevelsAfterSelling(sale.group, sale.count, levels.data());
+            for (unsigned int i = 0; i < tiles.size(); i++) {
+                const BoardDefinition::Tile& tile = board.getTile(tiles[i]);
+                unsigned int level = game.getTile(tiles[i]).buildingLevel;
+                total.cash += (level - levels[i]) * (tile.housePrice / 2);
+                total.rentLost += tile.rents[level] - std::min(tile.rents[level], tile.rents[levels[i]]);
+            }
+        }
+        for (unsigned int tile : planner.getMortgages()) {
+            total.cash += GameState::getMortgageValue(board.getTile(tile));
+            total.rentLost += board.getTile(tile).rents[0];
+        }
+        return total;
+    }
+
+    void comparePlans(const GameState& game, std::uint64_t seed, std::mt19937_64& random, LiquidationPlanner& planner,
+                      Checker& checker){
+        for (unsigned int player = 0; player < game.getNumPlayers(); player++) {
+            if (game.getPlayer(player).bankrupt) {
+                continue;
+            }
+            std::vector<std::vector<Option>> groups = getOptions(game, player);
+            std::uint64_t combinations = 1;
+            unsigned int maxCash = 0;
+            for (const std::vector<Option>& options : groups) {
+                combinations *= options.size();
+                unsigned int most = 0;
+                for (const Option& option : options) {
+                    most = std::max(most, option.cash);
+                }
+                maxCash += most;
+                if (combinations > MAX_COMBINATIONS) {
+                    break;
+                }
+            }
+            if (combinations > MAX_COMBINATIONS) {
+                continue;
+            }
+            // the amounts go a little past what the player can raise, so some plans fail
+            for (unsigned int i = 0; i < AMOUNTS; i++) {
+                unsigned int amount = 1 + static_cast<unsigned int>(random() % (maxCash + 50));
+                Option best{ 0, 0 };
+                bool found = false;
+                search(groups, 0, Option{ 0, 0 }, amount, best, found);
+                bool planned = planner.plan(game, player, amount);
+                checker.check(planned == found, "a plan exists", seed, player, amount);
+                if (!planned || !found) {
+                    continue;
+                }
+                checker.check(planner.getRentLost() == best.rentLost, "least rent lost", seed, player, amount);
+                checker.check(planner.getCash() == best.cash, "least cash on ties", seed, player, amount);
+                Option chosen = replay(game, planner);
+                checker.check(chosen.rentLost == planner.getRentLost() && chosen.cash == planner.getCash(),
+                              "the sales and mortgages add up to the plan", seed, player, amount);
+            }
+        }
+    }
+}
+
+int main(){
+    Checker checker;
+    LiquidationPlanner planner;
+    std::vector<BoardDefinition> boards;
+    for (unsigned int groupSize : { 2u, 3u }) {
+        BoardDefinition::GeneratorOptions options;
+        options.numTiles = 16;
+        options.groupSize = groupSize;
+        boards.push_back(BoardDefinition::generate(options));
+    }
+    boards.push_back(BoardDefinition::standard());
+
+    for (std::uint64_t seed = 1; seed <= GAMES; seed++) {
+        std::mt19937_64 random(seed);
+        GameState game(NUM_PLAYERS, seed, boards[seed % boards.size()]);
+        for (unsigned int action = 0; action < MAX_ACTIONS && game.getPhase() != GameState::Phase::GameOver; action++) {
+            Simulation::applyBotAction(game);
+            if (action % PLAN_EVERY == 0) {
+                comparePlans(game, seed, random, planner, checker);
+            }
+        }
+    }
+    std::cout << "LiquidationPlanner: " << checker.checks << " checks, " << checker.failures << " failed" << std::endl;
+    return checker.failures == 0 ? 0 : 1;
+}
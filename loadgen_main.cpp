@@ -0,0 +1,567 @@
+// INCLUDES
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "GameState.hpp"
+#include "Protocol.hpp"
+
+// Defines
+#define DEFAULT_UNIX_PATH "/tmp/monopoly.sock"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief The command line options of the load generator. */
+    struct Options {
+        std::string unixPath = DEFAULT_UNIX_PATH;
+        std::uint16_t tcpPort = 0;
+        unsigned int connections = 4;
+        unsigned int games = 1000;
+        unsigned int players = 4;
+        double duration = 5.0;        // seconds per run
+        bool ramp = false;
+        unsigned int maxGames = 1u << 20;
+        double p99TargetUs = 1000.0;
+        unsigned int spectators = 0;  // spectator connections, each watching one game
+        int serverPid = 0;            // to measure the server's CPU time
+    };
+
+    /** @brief The ids of the running games (0 for an empty slot, otherwise id + 1), shared with the spectators. */
+    std::unique_ptr<std::atomic<std::uint32_t>[]> g_liveGames;
+    unsigned int g_liveGameSlots = 0;
+
+    /** @brief What the spectators received during a run. */
+    struct SpectatorResult {
+        std::uint64_t bytes = 0;
+        std::uint64_t keyframes = 0;
+        std::uint64_t deltas = 0;
+        std::uint64_t staleDeltas = 0;   // deltas against a keyframe the spectator no longer holds
+        std::uint64_t invalidDeltas = 0; // deltas referring to entries their keyframe does not have
+        double cpuSeconds = 0.0;         // CPU time of the spectator client thread
+        unsigned int connected = 0;
+    };
+
+    /** @brief The result of one run. */
+    struct RunResult {
+        std::vector<std::uint32_t> latenciesUs;
+        std::uint64_t finishedGames = 0;
+        unsigned int serverShards = 1;
+        bool failed = false;
+    };
+
+    /** @brief A game driven by a client thread: the bot only ever has one action in flight. */
+    struct ClientGame {
+        std::uint32_t gameId = 0;
+        std::uint8_t lastAction = 0;
+        Clock::time_point sentAt;
+    };
+
+    int connectToServer(const Options& options){
+        int fd;
+        if (options.tcpPort != 0) {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(options.tcpPort);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+                close(fd);
+                return -1;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        } else {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+                close(fd);
+                return -1;
+            }
+        }
+        return fd;
+    }
+
+    bool sendAll(int fd, std::vector<std::uint8_t>& buffer){
+        std::size_t offset = 0;
+        while (offset < buffer.size()) {
+            ssize_t sent = send(fd, buffer.data() + offset, buffer.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return false;
+            }
+            offset += static_cast<std::size_t>(sent);
+        }
+        buffer.clear();
+        return true;
+    }
+
+    /** @brief Chooses the next action of a bot from the result of its previous one. */
+    std::uint8_t chooseAction(const Protocol::ActionResult& result, std::uint8_t lastAction){
+        using Action = GameState::Action;
+        switch (static_cast<GameState::Phase>(result.phase)) {
+            case GameState::Phase::BuyMenu:
+                // buy when possible, decline when the server says we can't afford it
+                if (static_cast<GameState::Status>(result.status) == GameState::Status::NotEnoughMoney
+                    && lastAction == static_cast<std::uint8_t>(Action::Buy)) {
+                    return static_cast<std::uint8_t>(Action::DoNotBuy);
+                }
+                return static_cast<std::uint8_t>(Action::Buy);
+            case GameState::Phase::EndTurn:
+                return static_cast<std::uint8_t>(Action::EndTurn);
+            default:
+                return static_cast<std::uint8_t>(Action::RollDice);
+        }
+    }
+
+    /** @brief Drives games over one connection until the deadline, recording the latency of every action. */
+    void runConnection(const Options& options, unsigned int games, unsigned int connectionIndex, unsigned int firstSlot,
+                       Clock::time_point deadline, RunResult& result){
+        int fd = connectToServer(options);
+        if (fd < 0) {
+            result.failed = true;
+            return;
+        }
+
+        std::vector<std::uint8_t> out;
+        std::vector<ClientGame> clientGames(games);
+        Protocol::FrameDecoder decoder;
+        std::uint8_t buffer[64 * 1024];
+        unsigned int inFlight = 0;
+        std::uint64_t nextSeed = (static_cast<std::uint64_t>(connectionIndex) << 32) + 1;
+
+        // say hello and create all the games, the request id is the slot of the game
+        Protocol::encode(out, Protocol::Hello{ Protocol::VERSION });
+        for (unsigned int i = 0; i < games; i++) {
+            Protocol::encode(out, Protocol::CreateGame{ i, static_cast<std::uint8_t>(options.players), nextSeed++ });
+            inFlight++;
+        }
+        bool ok = sendAll(fd, out);
+
+        while (ok && inFlight > 0) {
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                ok = false;
+                break;
+            }
+            decoder.feed(buffer, static_cast<std::size_t>(received));
+            Clock::time_point now = Clock::now();
+            bool sending = now < deadline;
+
+            Protocol::MessageType type;
+            const std::uint8_t* payload;
+            std::size_t payloadSize;
+            while (decoder.next(type, payload, payloadSize)) {
+                Protocol::Reader reader(payload, payloadSize);
+                if (type == Protocol::MessageType::Welcome) {
+                    Protocol::Welcome welcome;
+                    if (Protocol::decode(reader, welcome)) {
+                        result.serverShards = welcome.shardCount;
+                    }
+                    continue;
+                }
+
+                Protocol::ActionResult actionResult{};
+                std::uint32_t slot;
+                if (type == Protocol::MessageType::GameCreated) {
+                    Protocol::GameCreated created;
+                    if (!Protocol::decode(reader, created) || created.requestId >= games) {
+                        ok = false;
+                        break;
+                    }
+                    slot = created.requestId;
+                    clientGames[slot].gameId = created.gameId;
+                    g_liveGames[firstSlot + slot].store(created.gameId + 1, std::memory_order_relaxed);
+                    actionResult.phase = static_cast<std::uint8_t>(GameState::Phase::RollDice);
+                } else if (type == Protocol::MessageType::ActionResult) {
+                    if (!Protocol::decode(reader, actionResult) || actionResult.requestId >= games) {
+                        ok = false;
+                        break;
+                    }
+                    slot = actionResult.requestId;
+                    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - clientGames[slot].sentAt);
+                    result.latenciesUs.push_back(static_cast<std::uint32_t>(latency.count()));
+                } else {
+                    continue;
+                }
+                inFlight--;
+                if (!sending) {
+                    continue;
+                }
+
+                ClientGame& game = clientGames[slot];
+                if (actionResult.phase == static_cast<std::uint8_t>(GameState::Phase::GameOver)
+                    || actionResult.status == Protocol::STATUS_UNKNOWN_GAME) {
+                    // replace the finished game with a new one
+                    result.finishedGames++;
+                    Protocol::encode(out, Protocol::CloseGame{ slot, game.gameId });
+                    Protocol::encode(out, Protocol::CreateGame{ slot, static_cast<std::uint8_t>(options.players), nextSeed++ });
+                    inFlight++;
+                    continue;
+                }
+                game.lastAction = chooseAction(actionResult, game.lastAction);
+                game.sentAt = now;
+                if (game.lastAction == static_cast<std::uint8_t>(GameState::Action::EndTurn)) {
+                    // the server's bot trades, redeems and builds for the player before ending the turn, without
+                    // that nobody completes a group and the games never end
+                    Protocol::encode(out, Protocol::BotAction{ slot, game.gameId, actionResult.currentPlayer });
+                } else {
+                    Protocol::encode(out, Protocol::Action{ slot, game.gameId, actionResult.currentPlayer, game.lastAction });
+                }
+                inFlight++;
+            }
+            if (ok && !out.empty()) {
+                ok = sendAll(fd, out);
+            }
+        }
+
+        if (!ok) {
+            result.failed = true;
+        }
+        for (unsigned int i = 0; i < games; i++) {
+            g_liveGames[firstSlot + i].store(0, std::memory_order_relaxed);
+        }
+        close(fd);
+    }
+
+    /** @brief Gets the CPU time (user + system) a process used so far, 0 if unknown. */
+    double processCpuSeconds(int pid){
+        std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+        std::string line;
+        if (!std::getline(stat, line)) {
+            return 0.0;
+        }
+        // the fields after the command name (which may hold spaces) start after the last ')'
+        std::size_t end = line.rfind(')');
+        if (end == std::string::npos) {
+            return 0.0;
+        }
+        std::vector<std::string> fields;
+        std::size_t position = end + 2;
+        while (position < line.size()) {
+            std::size_t next = line.find(' ', position);
+            if (next == std::string::npos) {
+                next = line.size();
+            }
+            fields.push_back(line.substr(position, next - position));
+            position = next + 1;
+        }
+        // utime and stime are fields 14 and 15 of the file, 11 and 12 after the command name
+        if (fields.size() < 13) {
+            return 0.0;
+        }
+        return (std::stod(fields[11]) + std::stod(fields[12])) / sysconf(_SC_CLK_TCK);
+    }
+
+    /** @brief Picks a running game for a spectator, 0 if none is running. */
+    std::uint32_t pickLiveGame(std::uint64_t& randomState){
+        for (unsigned int attempt = 0; attempt < 64 && g_liveGameSlots > 0; attempt++) {
+            randomState = randomState * 6364136223846793005ull + 1442695040888963407ull;
+            std::uint32_t id = g_liveGames[(randomState >> 33) % g_liveGameSlots].load(std::memory_order_relaxed);
+            if (id != 0) {
+                return id;
+            }
+        }
+        return 0;
+    }
+
+    /** @brief A spectator connection: the keyframes it holds, to apply the deltas against. */
+    struct SpectatorConnection {
+        int fd = -1;
+        Protocol::FrameDecoder decoder;
+        Protocol::Keyframe current;
+        Protocol::Keyframe previous;
+    };
+
+    /** @brief Watches random games over many spectator connections from one epoll thread until the deadline. */
+    void runSpectators(const Options& options, Clock::time_point deadline, SpectatorResult& result){
+        std::vector<SpectatorConnection> spectators(options.spectators);
+        int epollFd = epoll_create1(0);
+        std::uint64_t randomState = 0x853C49E6748FEA9Bull;
+        std::vector<std::uint8_t> out;
+
+        // wait for the players to create their games
+        while (pickLiveGame(randomState) == 0 && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        for (unsigned int i = 0; i < spectators.size(); i++) {
+            SpectatorConnection& spectator = spectators[i];
+            spectator.fd = connectToServer(options);
+            if (spectator.fd < 0) {
+                break;
+            }
+            result.connected++;
+            out.clear();
+            Protocol::encode(out, Protocol::Hello{ Protocol::VERSION });
+            Protocol::encode(out, Protocol::Spectate{ i, pickLiveGame(randomState) - 1 });
+            sendAll(spectator.fd, out);
+            fcntl(spectator.fd, F_SETFL, fcntl(spectator.fd, F_GETFL, 0) | O_NONBLOCK);
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u32 = i;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, spectator.fd, &event);
+        }
+
+        // only measure CPU from here, once all the spectators are connected
+        rusage startUsage{};
+        getrusage(RUSAGE_THREAD, &startUsage);
+
+        std::vector<epoll_event> events(1024);
+        std::uint8_t buffer[64 * 1024];
+        Protocol::Delta delta;
+        while (Clock::now() < deadline) {
+            int count = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 100);
+            for (int e = 0; e < count; e++) {
+                SpectatorConnection& spectator = spectators[events[e].data.u32];
+                ssize_t received;
+                while ((received = recv(spectator.fd, buffer, sizeof(buffer), 0)) > 0) {
+                    result.bytes += static_cast<std::uint64_t>(received);
+                    spectator.decoder.feed(buffer, static_cast<std::size_t>(received));
+                }
+
+                Protocol::MessageType type;
+                const std::uint8_t* payload;
+                std::size_t payloadSize;
+                out.clear();
+                while (spectator.decoder.next(type, payload, payloadSize)) {
+                    Protocol::Reader reader(payload, payloadSize);
+                    if (type == Protocol::MessageType::Keyframe) {
+                        std::swap(spectator.previous, spectator.current);
+                        if (Protocol::decode(reader, spectator.current)) {
+                            result.keyframes++;
+                            Protocol::encode(out, Protocol::AckKeyframe{ spectator.current.gameId, spectator.current.keyframeId });
+                        }
+                    } else if (type == Protocol::MessageType::Delta) {
+                        if (!Protocol::decode(reader, delta)) {
+                            continue;
+                        }
+                        result.deltas++;
+                        Protocol::Keyframe* base = (delta.keyframeId == spectator.current.keyframeId) ? &spectator.current
+                                                 : (delta.keyframeId == spectator.previous.keyframeId) ? &spectator.previous
+                                                 : nullptr;
+                        if (!base) {
+                            result.staleDeltas++;
+                            continue;
+                        }
+                        // a delta may only refer to the entries of its keyframe
+                        bool valid = true;
+                        for (const auto& player : delta.players) {
+                            valid = valid && player.first < base->players.size();
+                        }
+                        for (const auto& tile : delta.tiles) {
+                            valid = valid && tile.first < base->tiles.size();
+                        }
+                        if (!valid) {
+                            result.invalidDeltas++;
+                        }
+                    } else if (type == Protocol::MessageType::GameClosed) {
+                        // the game ended, watch another one
+                        std::uint32_t gameId = pickLiveGame(randomState);
+                        if (gameId != 0) {
+                            Protocol::encode(out, Protocol::Spectate{ events[e].data.u32, gameId - 1 });
+                        }
+                    }
+                }
+                if (!out.empty()) {
+                    sendAll(spectator.fd, out);
+                }
+            }
+        }
+
+        rusage endUsage{};
+        getrusage(RUSAGE_THREAD, &endUsage);
+        auto seconds = [](const timeval& time){ return time.tv_sec + time.tv_usec / 1e6; };
+        result.cpuSeconds = seconds(endUsage.ru_utime) + seconds(endUsage.ru_stime)
+                          - seconds(startUsage.ru_utime) - seconds(startUsage.ru_stime);
+
+        for (auto& spectator : spectators) {
+            if (spectator.fd >= 0) {
+                close(spectator.fd);
+            }
+        }
+        close(epollFd);
+    }
+
+    /** @brief Runs the given number of games for the configured duration. */
+    RunResult runLoad(const Options& options, unsigned int games){
+        unsigned int connections = std::max(1u, std::min(options.connections, games));
+        std::vector<RunResult> results(connections);
+        std::vector<std::thread> threads;
+        Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+        g_liveGames.reset(new std::atomic<std::uint32_t>[games]());
+        g_liveGameSlots = games;
+
+        unsigned int firstSlot = 0;
+        for (unsigned int i = 0; i < connections; i++) {
+            unsigned int share = games / connections + (i < games % connections ? 1 : 0);
+            threads.emplace_back([&, i, share, firstSlot]{ runConnection(options, share, i, firstSlot, deadline, results[i]); });
+            firstSlot += share;
+        }
+
+        // the spectators watch the games while the players play them
+        SpectatorResult spectatorResult;
+        double serverCpuStart = options.serverPid ? processCpuSeconds(options.serverPid) : 0.0;
+        Clock::time_point spectateStart = Clock::now();
+        if (options.spectators > 0) {
+            runSpectators(options, deadline, spectatorResult);
+        }
+        double serverCpu = options.serverPid ? processCpuSeconds(options.serverPid) - serverCpuStart : 0.0;
+        double spectateSeconds = std::chrono::duration<double>(Clock::now() - spectateStart).count();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (options.spectators > 0 && spectatorResult.connected > 0) {
+            double perSpectator = 1.0 / spectatorResult.connected;
+            std::cout << "spectators: " << spectatorResult.connected
+                      << "  bytes/s: " << static_cast<std::uint64_t>(spectatorResult.bytes / spectateSeconds)
+                      << "  bytes/s per spectator: " << spectatorResult.bytes / spectateSeconds * perSpectator
+                      << "  keyframes: " << spectatorResult.keyframes
+                      << "  deltas: " << spectatorResult.deltas
+                      << "  stale deltas: " << spectatorResult.staleDeltas
+                      << "  invalid deltas: " << spectatorResult.invalidDeltas << "\n"
+                      << "client CPU per spectator: " << spectatorResult.cpuSeconds / spectateSeconds * perSpectator * 1e6 << "us/s";
+            if (options.serverPid) {
+                std::cout << "  server CPU: " << 100.0 * serverCpu / spectateSeconds << "%"
+                          << "  server CPU per spectator (players included): " << serverCpu / spectateSeconds * perSpectator * 1e6 << "us/s";
+            }
+            std::cout << std::endl;
+        }
+
+        RunResult total;
+        for (auto& result : results) {
+            total.latenciesUs.insert(total.latenciesUs.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+            total.finishedGames += result.finishedGames;
+            total.serverShards = result.serverShards;
+            total.failed = total.failed || result.failed;
+        }
+        return total;
+    }
+
+    double percentile(const std::vector<std::uint32_t>& sorted, double p){
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        std::size_t index = static_cast<std::size_t>(p * (sorted.size() - 1));
+        return sorted[index];
+    }
+
+    /** @brief Prints one run, returns its p99 latency in microseconds. */
+    double report(const Options& options, unsigned int games, RunResult& result){
+        std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+        double actionsPerSecond = result.latenciesUs.size() / options.duration;
+        double p50 = percentile(result.latenciesUs, 0.50);
+        double p99 = percentile(result.latenciesUs, 0.99);
+        std::cout << "games: " << games
+                  << "  actions/s: " << static_cast<std::uint64_t>(actionsPerSecond)
+                  << "  p50: " << p50 << "us"
+                  << "  p99: " << p99 << "us"
+                  << "  finished games: " << result.finishedGames
+                  << "  games/core: " << games / std::max(1u, result.serverShards)
+                  << std::endl;
+        return p99;
+    }
+
+    void printUsage(const char* program){
+        std::cerr << "Usage: " << program << " [--unix PATH | --tcp PORT] [--connections N] [--games N] [--players N]\n"
+                  << "                 [--duration SECONDS] [--ramp] [--max-games N] [--p99-target-us US]\n"
+                  << "                 [--spectators N] [--server-pid PID]\n"
+                  << "  --ramp        double the number of games every run until p99 exceeds the target,\n"
+                  << "                then report the most games per server core that met it\n"
+                  << "  --spectators  open N spectator connections watching random games, and report the\n"
+                  << "                bytes/s and CPU per spectator (the server's CPU too, given its pid)\n";
+    }
+}
+
+// MAIN
+int main(int argc, char** argv) {
+    Options options;
+
+    // parse the command line
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--unix") == 0 && hasValue) {
+            options.unixPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tcp") == 0 && hasValue) {
+            options.tcpPort = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--connections") == 0 && hasValue) {
+            options.connections = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--games") == 0 && hasValue) {
+            options.games = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--players") == 0 && hasValue) {
+            options.players = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--duration") == 0 && hasValue) {
+            options.duration = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ramp") == 0) {
+            options.ramp = true;
+        } else if (std::strcmp(argv[i], "--max-games") == 0 && hasValue) {
+            options.maxGames = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--p99-target-us") == 0 && hasValue) {
+            options.p99TargetUs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--spectators") == 0 && hasValue) {
+            options.spectators = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--server-pid") == 0 && hasValue) {
+            options.serverPid = std::atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    // every spectator needs its own socket
+    if (options.spectators > 0) {
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = std::max<rlim_t>(limit.rlim_cur, std::min<rlim_t>(limit.rlim_max, options.spectators + options.connections + 64));
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    if (!options.ramp) {
+        RunResult result = runLoad(options, options.games);
+        if (result.failed) {
+            std::cerr << "Lost the connection to the server.\n";
+            return -1;
+        }
+        report(options, options.games, result);
+        return 0;
+    }
+
+    // ramp up until the latency target breaks
+    unsigned int bestGames = 0;
+    unsigned int shards = 1;
+    for (unsigned int games = options.games; games <= options.maxGames; games *= 2) {
+        RunResult result = runLoad(options, games);
+        if (result.failed) {
+            std::cerr << "Lost the connection to the server.\n";
+            return -1;
+        }
+        shards = std::max(1u, result.serverShards);
+        if (report(options, games, result) > options.p99TargetUs) {
+            break;
+        }
+        bestGames = games;
+    }
+    std::cout << "max games per core with p99 <= " << options.p99TargetUs << "us: " << bestGames / shards << std::endl;
+    return 0;
+}
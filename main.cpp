@@ -1,7 +1,30 @@
 // INCLUDES
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Board.hpp"
+#include "Dashboard.hpp"
+#include "LayoutCache.hpp"
+#include "LayoutPass.hpp"
 #include "MonopolyGame.hpp"
+#include "Profiler.hpp"
+#include "ProfilerOverlay.hpp"
+#include "Simulation.hpp"
+#include "TextBox.hpp"
+#include "ThreadPool.hpp"
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 // Defines
 #define WINDOW_HEIGHT 1000
@@ -9,28 +32,289 @@
 #define WINDOW_WIDTH WINDOW_HEIGHT + PLAYERS_MENU_WIDTH
 #define CORNERS_RATIO 2.f/13.f // defined the percentage of y-axis(WINDOW_HEIGHT) covered by one corner of the board. So the corner is WINDOW_HEIGHT*(CORNERS_RATIO) pixels long
 #define WINDOW_TITLE "Monopoly Game"
+#define GAME_SEED 1 // the seed of the dice of the first game
+#define PROFILER_OVERLAY_WIDTH 380 // the width of the profiler panel, added beside the players menu when profiling
+#define DEFAULT_TRACE_PATH "trace.json"
+#define FONT_PATH "Montserrat-Black.ttf"
+#define LAYOUT_CACHE_PATH "layout.cache" // the text layouts of the last run, so a warm start measures nothing
+#define RESIZE_DEBOUNCE_MS 150 // the board is laid out again once the window stopped resizing for this long
+#define DASHBOARD_BOT_ACTIONS_PER_FRAME 8 // the bot actions every game of the dashboard plays per frame
+#define COMMON_BOARD_SIZES { 720.f, 1080.f, 1440.f, 2160.f } // laid out in the background, so switching to these screen heights is instant
+
+/** @brief Gets the milliseconds since the process was launched (before the program was loaded), -1 if unknown. */
+static double getMillisecondsSinceLaunch() {
+#ifdef __linux__
+    // the 22nd field of /proc/self/stat is the start time in clock ticks since boot
+    std::ifstream stat("/proc/self/stat");
+    std::string line;
+    std::getline(stat, line);
+    std::size_t field = line.rfind(')'); // the command name may hold spaces
+    if (field == std::string::npos) {
+        return -1;
+    }
+    unsigned long long startTicks = 0;
+    for (int i = 0; i < 20 && field != std::string::npos; i++) {
+        field = line.find(' ', field + 1);
+    }
+    if (field == std::string::npos) {
+        return -1;
+    }
+    startTicks = std::stoull(line.substr(field + 1));
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return (now.tv_sec + now.tv_nsec / 1e9) * 1000.0 - startTicks * 1000.0 / sysconf(_SC_CLK_TCK);
+#else
+    return -1;
+#endif
+}
+
+/** @brief Gets the size of the board that fits in a window, beside the side panels. */
+static float getBoardSize(const sf::Vector2u& windowSize, unsigned int sidePanelsWidth) {
+    unsigned int width = windowSize.x > sidePanelsWidth ? windowSize.x - sidePanelsWidth : 1;
+    return static_cast<float>(std::max(1u, std::min(windowSize.y, width)));
+}
+
+/** @brief Lays out boards of the given sizes on a background thread, so their layouts are cached before the window gets that size.
+ *
+ * The thread measures with its own copy of the font, registered in the cache with the same id, so it never touches
+ * the font the window draws with.
+ * @param stop Checked between boards, to stop early when the window closes.
+ */
+static std::thread prewarmLayouts(LayoutCache& cache, std::uint64_t fontId, std::vector<float> boardSizes, const std::atomic<bool>& stop) {
+    return std::thread([&cache, fontId, boardSizes, &stop]{
+        Profiler::setThreadName("layout prewarm");
+        sf::Font font;
+        if (!font.loadFromFile(FONT_PATH)) {
+            return;
+        }
+        cache.registerFont(&font, fontId);
+        std::vector<const TextBox*> textBoxes;
+        for (float boardSize : boardSizes) {
+            if (stop) {
+                break;
+            }
+            PROFILE_ZONE("prewarm board");
+            Board board(boardSize, CORNERS_RATIO, font);
+            textBoxes.clear();
+            board.collectTextBoxes(textBoxes);
+            for (const TextBox* textBox : textBoxes) {
+                textBox->layout();
+            }
+        }
+        cache.unregisterFont(&font);
+    });
+}
+
+/** @brief Shows many games played by bots at once, as board thumbnails (see Dashboard).
+ *
+ * The games are played on the threads of a pool between the frames, so the dashboard draws them without locking.
+ * @param numGames The number of games shown.
+ * @param numThreads The number of threads playing the games, 0 for one per core.
+ * @return The exit code of the program.
+ */
+static int runDashboard(unsigned int numGames, unsigned int numThreads) {
+    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE);
+
+    sf::Font font;
+    if (!font.loadFromFile(FONT_PATH))
+    {
+        std::cerr << "Failed to load font.\n";
+        return -1;
+    }
+
+    Dashboard dashboard(sf::Vector2f(window.getSize()), numGames, CORNERS_RATIO, font);
+
+    std::vector<GameState> games;
+    games.reserve(numGames);
+    for (unsigned int i = 0; i < numGames; i++) {
+        games.emplace_back(4, GAME_SEED + i);
+    }
+    std::uint64_t nextSeed = GAME_SEED + numGames;
+    std::vector<std::uint64_t> seeds(numGames);
+    ThreadPool pool(numThreads);
+    std::atomic<std::uint64_t> actionCount(0);
+
+    sf::Clock frameClock;
+    sf::Int64 worstFrameUs = 0;
+    sf::Int64 totalFrameUs = 0;
+    sf::Int64 frameCount = 0;
+
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed
+                || (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)) {
+                window.close();
+            } else if (event.type == sf::Event::Resized) {
+                sf::Vector2f size(static_cast<float>(event.size.width), static_cast<float>(event.size.height));
+                window.setView(sf::View(sf::FloatRect(0.f, 0.f, size.x, size.y)));
+                dashboard.resize(size);
+            }
+        }
+
+        // finished games are replaced by new ones, the seeds are handed out here so they don't depend on the threads
+        for (unsigned int i = 0; i < numGames; i++) {
+            seeds[i] = games[i].getPhase() == GameState::Phase::GameOver ? nextSeed++ : 0;
+        }
+
+        {
+            PROFILE_ZONE("play games");
+            pool.parallelFor(numGames, [&games, &seeds, &actionCount](std::size_t index, unsigned int){
+                GameState& game = games[index];
+                if (seeds[index] != 0) {
+                    game = GameState(4, seeds[index]);
+                }
+                unsigned int actions = 0;
+                for (; actions < DASHBOARD_BOT_ACTIONS_PER_FRAME && game.getPhase() != GameState::Phase::GameOver; actions++) {
+                    Simulation::applyBotAction(game);
+                }
+                actionCount.fetch_add(actions, std::memory_order_relaxed);
+            });
+        }
+
+        {
+            PROFILE_ZONE("update dashboard");
+            for (unsigned int i = 0; i < numGames; i++) {
+                dashboard.setGame(i, games[i]);
+            }
+        }
+
+        {
+            PROFILE_ZONE("draw");
+            window.clear(sf::Color(30, 30, 30));
+            window.draw(dashboard);
+        }
+
+        {
+            PROFILE_ZONE("display");
+            window.display();
+        }
+
+        sf::Int64 frameUs = frameClock.restart().asMicroseconds();
+        worstFrameUs = std::max(worstFrameUs, frameUs);
+        totalFrameUs += frameUs;
+        frameCount++;
+    }
+
+    if (frameCount > 0) {
+        std::cout << "dashboard: " << numGames << " games, " << dashboard.getVertexCount() << " vertices in 2 draw calls per frame\n";
+        std::cout << "frames: " << frameCount << ", average frame: " << totalFrameUs / frameCount << "us"
+                  << " (" << 1e6 * frameCount / std::max<sf::Int64>(1, totalFrameUs) << " fps)"
+                  << ", worst frame: " << worstFrameUs << "us, game actions: " << actionCount.load() << "\n";
+    }
+    return 0;
+}
 
 // MAIN
-int main() {
+int main(int argc, char* argv[]) {
+    const auto mainStart = std::chrono::steady_clock::now();
+
+    // --profile records the profiler zones and shows them beside the board, --trace FILE also sets where they are exported
+    // --layout-threads N sets the number of threads laying out the text boxes (default: one per core)
+    // --dashboard N shows N games played by bots as thumbnails instead of the board, on the layout threads
+    bool profile = false;
+    std::string tracePath = DEFAULT_TRACE_PATH;
+    unsigned int layoutThreads = 0;
+    unsigned int dashboardGames = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            profile = true;
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--layout-threads") == 0 && i + 1 < argc) {
+            layoutThreads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--dashboard") == 0 && i + 1 < argc) {
+            dashboardGames = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--profile] [--trace FILE] [--layout-threads N] [--dashboard N]\n";
+            return -1;
+        }
+    }
+    Profiler::setEnabled(profile);
+    Profiler::setThreadName("render");
+
+    if (dashboardGames > 0) {
+        int result = runDashboard(dashboardGames, layoutThreads);
+        if (profile && Profiler::exportChromeTrace(tracePath)) {
+            std::cout << "trace written to " << tracePath << "\n";
+        }
+        return result;
+    }
+
     // CREATE THE RENDER WINDOW
-    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE);
+    unsigned int sidePanelsWidth = PLAYERS_MENU_WIDTH + (profile ? PROFILER_OVERLAY_WIDTH : 0);
+    unsigned int windowWidth = WINDOW_WIDTH + (profile ? PROFILER_OVERLAY_WIDTH : 0);
+    sf::RenderWindow window(sf::VideoMode(windowWidth, WINDOW_HEIGHT), WINDOW_TITLE);
+    bool fullscreen = false;
 
     // Load the common font of the game
     sf::Font font;
-    if (!font.loadFromFile("Montserrat-Black.ttf"))
+    if (!font.loadFromFile(FONT_PATH))
     {
         std::cerr << "Failed to load font.\n";
         return -1;
     }
 
+    // Reuse the text layouts of the last run, they are keyed by the font file, the strings and the bounds
+    LayoutCache layoutCache;
+    layoutCache.load(LAYOUT_CACHE_PATH);
+    const std::uint64_t fontId = LayoutCache::hashFile(FONT_PATH);
+    layoutCache.registerFont(&font, fontId);
+    TextBox::setLayoutCache(&layoutCache);
+
     // Create the game:
     MonopolyGame game(window.getSize(), CORNERS_RATIO, font);
+    game.resize(getBoardSize(window.getSize(), sidePanelsWidth));
 
     // Initialize players' names:
     game.setPlayersNames({"shoe", "hat", "dog", "car"});
 
     // Start the game
     game.startGame();
+
+    // Lay out the text boxes that changed across the cores before each frame, instead of one by one inside the draw
+    LayoutPass layoutPass(layoutThreads);
+    layoutPass.addFont(font, FONT_PATH);
+    std::vector<const TextBox*> textBoxes;
+    game.collectTextBoxes(textBoxes);
+
+    // While the window is being resized, the current layout is drawn scaled to the new size,
+    // and the exact relayout runs once the resizing stops
+    float shownBoardSize = game.getBoardSize();
+    bool relayoutPending = false;
+    bool toggleFullscreen = false;
+    sf::Clock resizeClock;
+
+    // Cache the layouts of the fullscreen board and of common screen sizes in the background, once the first frame is up
+    std::vector<float> prewarmSizes;
+    for (float boardSize : COMMON_BOARD_SIZES) {
+        prewarmSizes.push_back(boardSize);
+    }
+    prewarmSizes.insert(prewarmSizes.begin(), getBoardSize(sf::Vector2u(sf::VideoMode::getDesktopMode().width,
+                                                                         sf::VideoMode::getDesktopMode().height), sidePanelsWidth));
+    prewarmSizes.erase(std::remove(prewarmSizes.begin(), prewarmSizes.end(), shownBoardSize), prewarmSizes.end());
+    std::atomic<bool> stopPrewarm(false);
+    std::thread prewarmThread;
+
+    // The profiler panel, right of the players menu
+    std::unique_ptr<ProfilerOverlay> overlay;
+    if (profile) {
+        overlay = std::make_unique<ProfilerOverlay>(
+            sf::FloatRect(WINDOW_WIDTH, 0, PROFILER_OVERLAY_WIDTH, WINDOW_HEIGHT), font);
+    }
+
+    // Run the game logic on its own thread, the window only draws its snapshots
+    Simulation simulation(4, GAME_SEED);
+    simulation.start();
+
+    // Frame times, to check the drawing stays smooth while the simulation is busy
+    sf::Clock frameClock;
+    sf::Clock animationClock;
+    sf::Int64 worstFrameUs = 0;
+    sf::Int64 totalFrameUs = 0;
+    TextBox::UpdateCounts totalTextUpdates = { 0, 0 };
+    sf::Int64 frameCount = 0;
     
     while (window.isOpen()) {
         // POLL EVENTS
@@ -41,6 +325,14 @@ int main() {
                     window.close();
                     break;
 
+                // Keep drawing in pixels, and scale the board until the window stops resizing
+                case sf::Event::Resized:
+                    window.setView(sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(event.size.width), static_cast<float>(event.size.height))));
+                    shownBoardSize = getBoardSize(sf::Vector2u(event.size.width, event.size.height), sidePanelsWidth);
+                    relayoutPending = true;
+                    resizeClock.restart();
+                    break;
+
                 // Mouse left click
                 case sf::Event::MouseButtonPressed:
                     if (event.mouseButton.button == sf::Mouse::Left) {
@@ -54,21 +346,161 @@ int main() {
 
                 // Key pressed event
                 case sf::Event::KeyPressed:
-                    if (event.key.code == sf::Keyboard::Escape) {
-                        window.close();
+                    // the actions of the current player: Space rolls the dice, B buys, N does not buy, E ends the turn
+                    // T trades for the best deal another player accepts, A lets bots play every seat (or stops them),
+                    // R restarts the game
+                    switch (event.key.code) {
+                        case sf::Keyboard::Escape:
+                            window.close();
+                            break;
+                        case sf::Keyboard::Space:
+                            simulation.pushInput({ Simulation::Input::Kind::Action, GameState::Action::RollDice });
+                            break;
+                        case sf::Keyboard::B:
+                            simulation.pushInput({ Simulation::Input::Kind::Action, GameState::Action::Buy });
+                            break;
+                        case sf::Keyboard::N:
+                            simulation.pushInput({ Simulation::Input::Kind::Action, GameState::Action::DoNotBuy });
+                            break;
+                        case sf::Keyboard::E:
+                            simulation.pushInput({ Simulation::Input::Kind::Action, GameState::Action::EndTurn });
+                            break;
+                        case sf::Keyboard::T:
+                            simulation.pushInput({ Simulation::Input::Kind::ProposeTrade, GameState::Action::RollDice });
+                            break;
+                        case sf::Keyboard::A:
+                            simulation.pushInput({ Simulation::Input::Kind::ToggleAutoplay, GameState::Action::RollDice });
+                            break;
+                        case sf::Keyboard::R:
+                            simulation.pushInput({ Simulation::Input::Kind::NewGame, GameState::Action::RollDice });
+                            break;
+                        // F11 toggles fullscreen
+                        case sf::Keyboard::F11:
+                            toggleFullscreen = true;
+                            break;
+                        // F3 pauses (or resumes) recording the profiler zones, F4 exports them
+                        case sf::Keyboard::F3:
+                            Profiler::setEnabled(!Profiler::isEnabled());
+                            break;
+                        case sf::Keyboard::F4:
+                            if (Profiler::exportChromeTrace(tracePath)) {
+                                std::cout << "trace written to " << tracePath << "\n";
+                            }
+                            break;
+                        default:
+                            break;
                     }
                     break;
+
+                default:
+                    break;
+            }
+        }
+
+        // Recreate the window on a fullscreen toggle, its layout is usually cached already so it's laid out right away
+        if (toggleFullscreen) {
+            toggleFullscreen = false;
+            fullscreen = !fullscreen;
+            if (fullscreen) {
+                window.create(sf::VideoMode::getDesktopMode(), WINDOW_TITLE, sf::Style::Fullscreen);
+            } else {
+                window.create(sf::VideoMode(windowWidth, WINDOW_HEIGHT), WINDOW_TITLE);
+            }
+            shownBoardSize = getBoardSize(window.getSize(), sidePanelsWidth);
+            game.resize(shownBoardSize);
+            relayoutPending = false;
+        }
+
+        // The exact relayout, once the window stopped resizing
+        if (relayoutPending && resizeClock.getElapsedTime().asMilliseconds() >= RESIZE_DEBOUNCE_MS) {
+            game.resize(shownBoardSize);
+            relayoutPending = false;
+        }
+
+        // Show the newest state of the game, if it changed, and walk the tokens towards it
+        if (simulation.pollSnapshot()) {
+            game.applySnapshot(simulation.getSnapshot());
+        }
+        {
+            PROFILE_ZONE("animate");
+            game.update(animationClock.restart().asSeconds());
+        }
+
+        {
+            PROFILE_ZONE("layout");
+            layoutPass.run(textBoxes);
+        }
+
+        {
+            PROFILE_ZONE("draw");
+            // Clear previous buffer
+            window.clear();
+
+            // Draw the game, scaled from the size it's laid out for while resizing
+            float scale = shownBoardSize / game.getBoardSize();
+            sf::Transform boardTransform;
+            boardTransform.scale(scale, scale);
+            window.draw(game, boardTransform);
+
+            // Draw the profiler panel, right of the board
+            if (overlay) {
+                sf::Transform overlayTransform;
+                overlayTransform.translate(shownBoardSize + PLAYERS_MENU_WIDTH - (WINDOW_WIDTH), 0.f);
+                window.draw(*overlay, overlayTransform);
+            }
+        }
+
+        {
+            PROFILE_ZONE("display");
+            // Display the new buffer
+            window.display();
+        }
+
+        // Report the startup time once the first frame is on screen, and keep its layouts for the next start
+        if (frameCount == 0) {
+            double sinceMainMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mainStart).count();
+            std::cout << "startup: first frame presented " << sinceMainMs << "ms after main";
+            double sinceLaunchMs = getMillisecondsSinceLaunch();
+            if (sinceLaunchMs >= 0) {
+                std::cout << ", " << sinceLaunchMs << "ms after launch";
             }
+            std::cout << " (layouts: " << layoutCache.getHits() << " cached, " << layoutCache.getMisses() << " measured on "
+                      << layoutPass.getNumWorkers() << " thread(s))\n";
+            if (layoutCache.isDirty()) {
+                layoutCache.save(LAYOUT_CACHE_PATH);
+            }
+            prewarmThread = prewarmLayouts(layoutCache, fontId, prewarmSizes, stopPrewarm);
         }
 
-        // Clear previous buffer
-        window.clear();
-        
-        // Draw the game
-        window.draw(game);
+        sf::Int64 frameUs = frameClock.restart().asMicroseconds();
+        TextBox::UpdateCounts textUpdates = TextBox::takeUpdateCounts();
+        totalTextUpdates.full += textUpdates.full;
+        totalTextUpdates.incremental += textUpdates.incremental;
+        if (overlay) {
+            overlay->addCount("text boxes rebuilt", textUpdates.full);
+            overlay->addCount("text boxes moved", textUpdates.incremental);
+            overlay->addFrame(frameUs);
+        }
+        worstFrameUs = std::max(worstFrameUs, frameUs);
+        totalFrameUs += frameUs;
+        frameCount++;
+    }
 
-        // Display the new buffer
-        window.display();
+    simulation.stop();
+    stopPrewarm = true;
+    if (prewarmThread.joinable()) {
+        prewarmThread.join();
+    }
+    if (layoutCache.isDirty()) {
+        layoutCache.save(LAYOUT_CACHE_PATH);
+    }
+    if (profile && Profiler::exportChromeTrace(tracePath)) {
+        std::cout << "trace written to " << tracePath << "\n";
+    }
+    if (frameCount > 0) {
+        std::cout << "frames: " << frameCount << ", average frame: " << totalFrameUs / frameCount << "us"
+                  << ", worst frame: " << worstFrameUs << "us, game actions: " << simulation.getActionCount() << "\n";
+        std::cout << "text box updates: " << totalTextUpdates.full << " rebuilt, " << totalTextUpdates.incremental << " moved\n";
     }
 
     return 0;
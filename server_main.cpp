@@ -0,0 +1,122 @@
+// INCLUDES
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "GameServer.hpp"
+#include "GameState.hpp"
+
+// Defines
+#define DEFAULT_UNIX_PATH "/tmp/monopoly.sock"
+
+namespace {
+    GameServer* g_server = nullptr;
+
+    void onSignal(int){
+        if (g_server) {
+            g_server->stop();
+        }
+    }
+
+    void printUsage(const char* program){
+        std::cerr << "Usage: " << program << " [--shards N] [--unix PATH] [--tcp PORT] [--stats SECONDS]\n"
+                  << "  --shards N       number of game threads (default: number of cores)\n"
+                  << "  --unix PATH      Unix socket to listen on (default: " DEFAULT_UNIX_PATH ", 'none' to disable)\n"
+                  << "  --tcp PORT       loopback TCP port to listen on (default: disabled)\n"
+                  << "  --stats SECONDS  print the shard counters every SECONDS (default: disabled)\n";
+    }
+}
+
+// MAIN
+int main(int argc, char** argv) {
+    GameServer::Config config;
+    config.shardCount = std::thread::hardware_concurrency();
+    config.unixPath = DEFAULT_UNIX_PATH;
+    unsigned int statsInterval = 0;
+
+    // parse the command line
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--shards") == 0 && hasValue) {
+            config.shardCount = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--unix") == 0 && hasValue) {
+            config.unixPath = argv[++i];
+            if (config.unixPath == "none") {
+                config.unixPath.clear();
+            }
+        } else if (std::strcmp(argv[i], "--tcp") == 0 && hasValue) {
+            config.tcpPort = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--stats") == 0 && hasValue) {
+            statsInterval = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    try {
+        GameServer server(config);
+        g_server = &server;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        std::cout << "Monopoly server running " << server.getShardCount() << " shards";
+        if (!config.unixPath.empty()) {
+            std::cout << ", unix socket " << config.unixPath;
+        }
+        if (config.tcpPort != 0) {
+            std::cout << ", tcp 127.0.0.1:" << config.tcpPort;
+        }
+        std::cout << std::endl;
+        // the tiles' names, prices and rents live in one table shared by every game, a game only keeps its state
+        std::cout << "memory per game: " << GameState(2, 0).getMemoryUsage() << " bytes of game state, plus "
+                  << BoardDefinition::standard().getMemoryUsage() << " bytes of board definition shared by all games" << std::endl;
+
+        // report the counters of the shards from a side thread
+        std::atomic<bool> reporting(statsInterval > 0);
+        std::thread reporter;
+        if (reporting) {
+            reporter = std::thread([&]{
+                std::uint64_t lastActions = 0;
+                std::uint64_t lastBroadcastBytes = 0;
+                while (reporting) {
+                    std::this_thread::sleep_for(std::chrono::seconds(statsInterval));
+                    std::uint64_t actions = 0;
+                    std::uint64_t games = 0;
+                    std::uint64_t spectators = 0;
+                    std::uint64_t broadcastBytes = 0;
+                    for (unsigned int i = 0; i < server.getShardCount(); i++) {
+                        actions += server.getShardStats(i).actions;
+                        games += server.getShardStats(i).games;
+                        spectators += server.getShardStats(i).spectators;
+                        broadcastBytes += server.getShardStats(i).broadcastBytes;
+                    }
+                    std::cout << "games: " << games << ", actions/s: " << (actions - lastActions) / statsInterval;
+                    if (spectators > 0) {
+                        std::cout << ", spectators: " << spectators
+                                  << ", spectator bytes/s: " << (broadcastBytes - lastBroadcastBytes) / statsInterval;
+                    }
+                    std::cout << std::endl;
+                    lastActions = actions;
+                    lastBroadcastBytes = broadcastBytes;
+                }
+            });
+        }
+
+        server.run();
+
+        reporting = false;
+        if (reporter.joinable()) {
+            reporter.join();
+        }
+        g_server = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,340 @@
+// INCLUDES
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BoardDefinition.hpp"
+#include "ResultFile.hpp"
+#include "ResultWriter.hpp"
+#include "ThreadPool.hpp"
+#include "Tournament.hpp"
+
+namespace {
+    void printUsage(const char* program){
+        std::cerr << "Usage: " << program << " [--format roundrobin|swiss] [--rounds N] [--policies A,B,...] [--threads N]\n"
+                  << "                 [--seed S] [--min-pairs N] [--max-pairs N] [--stop-z Z] [--max-turns N] [--stats] [--perf]\n"
+                  << "                 [--results FILE] [--read FILE] [--checkpoint FILE] [--checkpoint-every S] [--list]\n"
+                  << "  --format     every policy against every other one, or Swiss rounds (default: roundrobin)\n"
+                  << "  --rounds     the rounds of a Swiss tournament (default: log2 of the policies plus 2)\n"
+                  << "  --policies   the builtin policies that play, by name (default: all of them)\n"
+                  << "  --threads    the threads that play the games (default: one per core)\n"
+                  << "  --min-pairs  the pairs of games a matchup plays before it can stop early (default: 32)\n"
+                  << "  --max-pairs  the pairs of games after which an undecided matchup stops (default: 1000)\n"
+                  << "  --stop-z     the standard errors from an even score that decide a matchup (default: 3)\n"
+                  << "  --max-turns  the turns after which a game goes to the higher net worth (default: 1000)\n"
+                  << "  --stats      print a summary of all the games after the standings\n"
+                  << "  --perf       print the cycles, instructions and misses of every thread, per turn and per game\n"
+                  << "  --results    write the result of every game to a columnar file\n"
+                  << "  --read       print the policies' scores from a file written by --results and exit\n"
+                  << "  --checkpoint save the tournament to a file as it runs, and go on from it if it's there\n"
+                  << "  --checkpoint-every  the seconds between two checkpoints (default: 60)\n"
+                  << "  --list       print the builtin policies and exit\n";
+    }
+
+    void printStats(GameStats& stats){
+        std::cout << '\n' << stats.getNumGames() << " games summed up in " << stats.getMemoryUsage() << " bytes\n"
+                  << std::fixed << std::setprecision(0);
+        std::cout << "game length (turns): p50 " << stats.getLengthQuantile(0.5) << ", p90 "
+                  << stats.getLengthQuantile(0.9) << ", p99 " << stats.getLengthQuantile(0.99) << '\n';
+        std::cout << "final net worth:     p50 " << stats.getWealthQuantile(0.5) << ", p90 "
+                  << stats.getWealthQuantile(0.9) << ", p99 " << stats.getWealthQuantile(0.99) << '\n';
+        std::cout << std::setprecision(1);
+        for (unsigned int seat = 0; seat < GameState::MAX_PLAYERS && stats.getSeatGames(seat) > 0; seat++) {
+            std::cout << "seat " << seat + 1 << " won " << 100.0 * stats.getSeatWins(seat) / stats.getSeatGames(seat)
+                      << "% of " << stats.getSeatGames(seat) << " games\n";
+        }
+
+        // the most landed on tiles
+        const BoardDefinition& board = BoardDefinition::standard();
+        const std::vector<std::uint64_t>& landings = stats.getLandings();
+        std::uint64_t totalLandings = 0;
+        std::vector<unsigned int> tiles;
+        for (unsigned int tile = 0; tile < landings.size(); tile++) {
+            totalLandings += landings[tile];
+            tiles.push_back(tile);
+        }
+        std::sort(tiles.begin(), tiles.end(), [&](unsigned int a, unsigned int b){ return landings[a] > landings[b]; });
+        std::cout << "\nmost landed on tiles:\n";
+        for (std::size_t i = 0; i < std::min<std::size_t>(8, tiles.size()) && totalLandings > 0; i++) {
+            std::cout << "  " << std::left << std::setw(24) << board.getTile(tiles[i]).name << std::right << std::setw(6)
+                      << 100.0 * landings[tiles[i]] / totalLandings << "%\n";
+        }
+
+        // the rent a player collected in a game
+        std::cout << "\nrent collected in a game:\n";
+        const std::uint64_t* income = stats.getIncomeHistogram();
+        for (unsigned int bucket = 0; bucket < GameStats::INCOME_BUCKETS; bucket++) {
+            if (income[bucket] == 0) {
+                continue;
+            }
+            std::uint64_t low = bucket == 0 ? 0 : (1ULL << (bucket - 1));
+            std::uint64_t high = bucket == 0 ? 0 : (1ULL << bucket) - 1;
+            std::cout << "  " << std::setw(8) << low << " - " << std::left << std::setw(8) << high << std::right
+                      << std::setw(10) << income[bucket] << '\n';
+        }
+    }
+
+    void printPolicies(){
+        std::cout << std::left << std::setw(22) << "policy" << std::right << std::setw(12) << "buy reserve"
+                  << std::setw(14) << "build reserve" << std::setw(12) << "build level" << std::setw(8) << "trades" << '\n';
+        for (const BotPolicy& policy : Tournament::getBuiltinPolicies()) {
+            std::cout << std::left << std::setw(22) << policy.name << std::right << std::setw(12) << policy.buyReserve
+                      << std::setw(14) << policy.buildReserve << std::setw(12) << policy.maxBuildLevel
+                      << std::setw(8) << (policy.trades ? "yes" : "no") << '\n';
+        }
+    }
+
+    // the counts of every thread and of all of them, per turn and per game
+    void printCounters(const Tournament& tournament){
+        bool hardware = tournament.hasPerfCounters();
+        std::cout << '\n' << (hardware ? "" : "perf events are unavailable here, wall clock only\n")
+                  << std::left << std::setw(8) << "thread" << std::right << std::setw(10) << "games" << std::setw(12)
+                  << "turns" << std::setw(12) << "turns/s" << std::setw(12) << "us/game";
+        if (hardware) {
+            std::cout << std::setw(14) << "cycles/turn" << std::setw(7) << "IPC" << std::setw(12) << "L1d/turn"
+                      << std::setw(12) << "LLC/turn" << std::setw(14) << "branch/turn";
+        }
+        std::cout << '\n';
+
+        // the total adds up the time of every thread, so its turns/s is per thread
+        std::vector<Tournament::WorkerCounters> rows = tournament.getWorkerCounters();
+        Tournament::WorkerCounters total = {};
+        for (const Tournament::WorkerCounters& row : rows) {
+            total.counts += row.counts;
+            total.games += row.games;
+            total.turns += row.turns;
+        }
+        rows.push_back(total);
+        for (std::size_t i = 0; i < rows.size(); i++) {
+            const Tournament::WorkerCounters& row = rows[i];
+            double turns = static_cast<double>(std::max<std::uint64_t>(row.turns, 1));
+            const std::uint64_t* counts = row.counts.counts;
+            std::cout << std::left << std::setw(8) << (i + 1 < rows.size() ? std::to_string(i) : "all") << std::right
+                      << std::setw(10) << row.games << std::setw(12) << row.turns << std::fixed << std::setprecision(0)
+                      << std::setw(12) << (row.counts.wallNs > 0 ? 1e9 * row.turns / row.counts.wallNs : 0.0)
+                      << std::setprecision(1) << std::setw(12)
+                      << (row.games > 0 ? row.counts.wallNs / 1e3 / row.games : 0.0);
+            if (hardware) {
+                std::cout << std::setprecision(0) << std::setw(14) << counts[PerfCounters::Cycles] / turns
+                          << std::setprecision(2) << std::setw(7)
+                          << counts[PerfCounters::Instructions] / std::max(1.0, static_cast<double>(counts[PerfCounters::Cycles]))
+                          << std::setw(12) << counts[PerfCounters::L1DataMisses] / turns << std::setprecision(3)
+                          << std::setw(12) << counts[PerfCounters::LastLevelMisses] / turns << std::setprecision(2)
+                          << std::setw(14) << counts[PerfCounters::BranchMisses] / turns;
+            }
+            std::cout << '\n';
+        }
+        if (hardware && total.games > 0) {
+            std::cout << "per game: " << std::setprecision(0)
+                      << static_cast<double>(total.counts.counts[PerfCounters::Cycles]) / total.games << " cycles, "
+                      << static_cast<double>(total.counts.counts[PerfCounters::Instructions]) / total.games
+                      << " instructions, " << static_cast<double>(total.counts.counts[PerfCounters::L1DataMisses]) / total.games
+                      << " L1d misses, " << static_cast<double>(total.counts.counts[PerfCounters::LastLevelMisses]) / total.games
+                      << " LLC misses, " << static_cast<double>(total.counts.counts[PerfCounters::BranchMisses]) / total.games
+                      << " branch misses\n";
+        }
+    }
+
+    // scores the policies from the columns of a result file, without parsing anything
+    int printResultFile(const char* path){
+        ResultFile file;
+        if (!file.open(path)) {
+            std::cerr << "not a whole result file: " << path << std::endl;
+            return -1;
+        }
+        const ResultFile::Header& header = file.getHeader();
+        std::vector<double> games(header.numPolicies, 0.0);
+        std::vector<double> score(header.numPolicies, 0.0);
+        std::uint64_t turns = 0;
+        for (std::uint64_t index = 0; index < header.numBlocks; index++) {
+            ResultFile::Block block = file.getBlock(index);
+            for (std::uint32_t row = 0; row < block.numRows; row++) {
+                turns += block.lengths[row];
+                for (unsigned int seat = 0; seat < header.numSeats; seat++) {
+                    unsigned int policy = block.policies[seat][row];
+                    games[policy] += 1.0;
+                    score[policy] += block.winners[row] < 0 ? 1.0 / header.numSeats
+                                                             : (block.winners[row] == static_cast<int>(seat) ? 1.0 : 0.0);
+                }
+            }
+        }
+        std::cout << header.numRows << " games of " << header.numSeats << " seats in " << header.numBlocks
+                  << " blocks, " << std::fixed << std::setprecision(1)
+                  << (header.numRows > 0 ? static_cast<double>(turns) / header.numRows : 0.0) << " turns a game\n";
+        for (unsigned int policy = 0; policy < header.numPolicies; policy++) {
+            std::cout << std::left << std::setw(22) << file.getPolicyName(policy) << std::right << std::setw(10)
+                      << games[policy] << std::setw(7) << (games[policy] > 0 ? 100.0 * score[policy] / games[policy] : 0.0)
+                      << "%\n";
+        }
+        return 0;
+    }
+
+    // picks builtin policies by name, from a comma separated list
+    bool selectPolicies(const std::string& names, std::vector<BotPolicy>& policies){
+        std::stringstream stream(names);
+        std::string name;
+        while (std::getline(stream, name, ',')) {
+            bool found = false;
+            for (const BotPolicy& policy : Tournament::getBuiltinPolicies()) {
+                if (policy.name == name) {
+                    policies.push_back(policy);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                std::cerr << "unknown policy: " << name << " (see --list)" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// MAIN
+int main(int argc, char* argv[]) {
+    Tournament::Options options;
+    std::vector<BotPolicy> policies;
+    unsigned int threads = 0;
+    bool printSummary = false;
+    bool countPerf = false;
+    const char* resultPath = nullptr;
+    const char* checkpointPath = nullptr;
+    double checkpointSeconds = 60.0;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--format") == 0 && hasValue) {
+            std::string format = argv[++i];
+            if (format == "swiss") {
+                options.format = Tournament::Format::Swiss;
+            } else if (format == "roundrobin") {
+                options.format = Tournament::Format::RoundRobin;
+            } else {
+                printUsage(argv[0]);
+                return -1;
+            }
+        } else if (std::strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            options.rounds = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--policies") == 0 && hasValue) {
+            if (!selectPolicies(argv[++i], policies)) {
+                return -1;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--min-pairs") == 0 && hasValue) {
+            options.minPairs = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-pairs") == 0 && hasValue) {
+            options.maxPairs = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--stop-z") == 0 && hasValue) {
+            options.stopZ = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-turns") == 0 && hasValue) {
+            options.maxTurns = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            printSummary = true;
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            countPerf = true;
+        } else if (std::strcmp(argv[i], "--results") == 0 && hasValue) {
+            resultPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0 && hasValue) {
+            checkpointPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint-every") == 0 && hasValue) {
+            checkpointSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--read") == 0 && hasValue) {
+            return printResultFile(argv[++i]);
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            printPolicies();
+            return 0;
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+    if (policies.empty()) {
+        policies = Tournament::getBuiltinPolicies();
+    }
+    if (policies.size() < 2) {
+        std::cerr << "a tournament needs at least 2 policies" << std::endl;
+        return -1;
+    }
+
+    ThreadPool pool(threads);
+    Tournament tournament(policies, options);
+    // a checkpoint left by a run that was stopped is gone on from
+    bool resuming = checkpointPath && std::ifstream(checkpointPath).good();
+    ResultWriter results;
+    if (resultPath) {
+        std::vector<std::string> policyNames;
+        for (const BotPolicy& policy : policies) {
+            policyNames.push_back(policy.name);
+        }
+        std::vector<std::string> tileNames;
+        const BoardDefinition& board = BoardDefinition::standard();
+        for (unsigned int tile = 0; tile < board.getNumTiles(); tile++) {
+            tileNames.push_back(board.getTile(tile).name);
+        }
+        // the tournament adds the results in order from its own thread
+        if (!results.open(resultPath, 2, 1, policyNames, tileNames, resuming)) {
+            std::cerr << "can't write the results to " << resultPath << std::endl;
+            return -1;
+        }
+    }
+    if (checkpointPath) {
+        tournament.setCheckpoint(checkpointPath, checkpointSeconds);
+    }
+    tournament.setPerfCounters(countPerf);
+    if (resuming) {
+        if (!tournament.resume(checkpointPath, resultPath ? &results : nullptr)) {
+            std::cerr << checkpointPath << " isn't a checkpoint of this tournament" << std::endl;
+            return -1;
+        }
+        std::cout << "Resuming from " << checkpointPath << std::endl;
+    }
+    std::cout << "Tournament of " << policies.size() << " policies on " << pool.getNumWorkers() << " threads" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    tournament.run(pool, &std::cout, resultPath ? &results : nullptr);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (resultPath && !results.close(tournament.getStats().getLandings())) {
+        std::cerr << "failed writing the results to " << resultPath << std::endl;
+        return -1;
+    }
+    if (checkpointPath) {
+        std::remove(checkpointPath);
+    }
+
+    // the ranking
+    unsigned int decided = 0;
+    for (const Tournament::Matchup& matchup : tournament.getMatchups()) {
+        decided += matchup.decided ? 1 : 0;
+    }
+    std::cout << '\n' << std::left << std::setw(6) << "rank" << std::setw(22) << "policy" << std::right
+              << std::setw(8) << "rating" << std::setw(10) << "games" << std::setw(8) << "score" << '\n';
+    unsigned int rank = 1;
+    for (const Tournament::Standing& standing : tournament.getStandings()) {
+        std::cout << std::left << std::setw(6) << rank++ << std::setw(22) << tournament.getPolicies()[standing.policy].name
+                  << std::right << std::fixed << std::setprecision(0) << std::setw(8) << standing.rating
+                  << std::setw(10) << standing.games << std::setprecision(1) << std::setw(7)
+                  << (standing.games > 0 ? 100.0 * standing.score / standing.games : 0.0) << "%\n";
+    }
+    std::cout << '\n' << tournament.getNumGames() << " games in " << std::setprecision(1) << seconds << "s, "
+              << decided << " of " << tournament.getMatchups().size() << " matchups decided early" << std::endl;
+    if (resultPath) {
+        std::cout << results.getNumRows() << " game results written to " << resultPath << std::endl;
+    }
+    if (printSummary) {
+        printStats(tournament.getStats());
+    }
+    if (countPerf) {
+        printCounters(tournament);
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+// INCLUDES
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "BoardDefinition.hpp"
+#include "ResultWriter.hpp"
+#include "ThreadPool.hpp"
+#include "Tournament.hpp"
+
+/*
+ * Kills a tournament that writes a checkpoint after every wave at several points of its run, goes on from the
+ * checkpoint it left, and checks that the result file and the ratings are byte for byte those of a tournament that was
+ * never stopped.
+ */
+
+namespace {
+    constexpr unsigned int NUM_POLICIES = 5;
+    constexpr unsigned int THREADS = 2;
+    // how long after its first checkpoint a tournament is killed
+    constexpr unsigned int KILL_AFTER_MS[] = { 0, 40, 150 };
+
+    /** @brief What a tournament leaves behind: its result file and its standings. */
+    struct Outcome {
+        bool ok = false;
+        std::string standings;
+        std::string results;
+    };
+
+    std::string readFile(const std::string& path){
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    /** @brief Plays a tournament as tournament_main does, going on from the checkpoint if there's one. */
+    Outcome play(const Tournament::Options& options, const std::string& resultPath, const std::string& checkpointPath){
+        Outcome outcome;
+        std::vector<BotPolicy> policies(Tournament::getBuiltinPolicies().begin(),
+                                        Tournament::getBuiltinPolicies().begin() + NUM_POLICIES);
+        std::vector<std::string> policyNames;
+        for (const BotPolicy& policy : policies) {
+            policyNames.push_back(policy.name);
+        }
+        std::vector<std::string> tileNames;
+        const BoardDefinition& board = BoardDefinition::standard();
+        for (unsigned int tile = 0; tile < board.getNumTiles(); tile++) {
+            tileNames.push_back(board.getTile(tile).name);
+        }
+
+        ThreadPool pool(THREADS);
+        Tournament tournament(policies, options);
+        bool resuming = !checkpointPath.empty() && std::ifstream(checkpointPath).good();
+        ResultWriter results;
+        if (!results.open(resultPath, 2, 1, policyNames, tileNames, resuming)) {
+            return outcome;
+        }
+        if (!checkpointPath.empty()) {
+            tournament.setCheckpoint(checkpointPath, 0.0);
+        }
+        if (resuming && !tournament.resume(checkpointPath, &results)) {
+            return outcome;
+        }
+        tournament.run(pool, nullptr, &results);
+        if (!results.close(tournament.getStats().getLandings())) {
+            return outcome;
+        }
+
+        // the ratings to the last bit
+        std::ostringstream standings;
+        standings << std::hexfloat;
+        for (const Tournament::Standing& standing : tournament.getStandings()) {
+            standings << standing.policy << ' ' << standing.rating << ' ' << standing.games << ' ' << standing.score << '\n';
+        }
+        outcome.ok = true;
+        outcome.standings = standings.str();
+        outcome.results = readFile(resultPath);
+        return outcome;
+    }
+
+    /** @brief Kills a tournament some time after its first checkpoint, then goes on from the checkpoint it left. */
+    Outcome playInterrupted(const Tournament::Options& options, const std::string& resultPath,
+                            const std::string& checkpointPath, unsigned int killAfterMs, bool& killed){
+        std::remove(checkpointPath.c_str());
+        pid_t child = fork();
+        if (child < 0) {
+            return Outcome{};
+        }
+        if (child == 0) {
+            play(options, resultPath, checkpointPath);
+            _exit(0);
+        }
+        while (!std::ifstream(checkpointPath).good() && waitpid(child, nullptr, WNOHANG) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(killAfterMs));
+        kill(child, SIGKILL);
+        int status = 0;
+        waitpid(child, &status, 0);
+        killed = WIFSIGNALED(status);
+        return play(options, resultPath, checkpointPath);
+    }
+}
+
+int main(){
+    std::string directory = std::filesystem::temp_directory_path().string() + "/monopoly_resume_" + std::to_string(getpid());
+    std::filesystem::create_directories(directory);
+    unsigned int failures = 0;
+    unsigned int runs = 0;
+
+    for (Tournament::Format format : { Tournament::Format::RoundRobin, Tournament::Format::Swiss }) {
+        Tournament::Options options;
+        options.format = format;
+        options.minPairs = 16;
+        options.maxPairs = 96;
+        options.batchPairs = 4;
+        options.waveBlocks = 4;
+        options.seed = 7;
+        const char* name = format == Tournament::Format::Swiss ? "swiss" : "round robin";
+
+        Outcome expected = play(options, directory + "/whole.mres", "");
+        if (!expected.ok) {
+            std::cerr << "FAILED " << name << ": the tournament that wasn't stopped" << std::endl;
+            failures++;
+            continue;
+        }
+        for (unsigned int killAfterMs : KILL_AFTER_MS) {
+            bool killed = false;
+            Outcome resumed = playInterrupted(options, directory + "/resumed.mres", directory + "/checkpoint", killAfterMs, killed);
+            runs++;
+            // a tournament that ended before it was killed proves nothing
+            if (!killed || !resumed.ok || resumed.standings != expected.standings || resumed.results != expected.results) {
+                std::cerr << "FAILED " << name << " killed " << killAfterMs << "ms after its first checkpoint: "
+                          << (!killed ? "it ended first" : !resumed.ok ? "it didn't go on"
+                              : resumed.standings != expected.standings ? "other ratings" : "another result file")
+                          << std::endl;
+                failures++;
+            }
+        }
+    }
+    std::filesystem::remove_all(directory);
+    std::cout << "Tournament resume: " << runs << " interrupted runs, " << failures << " failed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}